@@ -1091,6 +1091,268 @@ bool aalineRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
 	return _aalineRGBA(renderer, x1, y1, x2, y2, r, g, b, a, true);
 }
 
+/* ---- Tessellation */
+
+/*!
+\brief Maximum deviation in pixels of tessellated curves from the true curve.
+
+Note: 0 (default) selects the raster algorithms for circles, ellipses, arcs and pies.
+*/
+static float gfxPrimitivesTessellationTolerance = 0.0f;
+
+/*!
+\brief Minimum number of segments of a tessellated full circle.
+*/
+#define GFX_TESSELLATION_MIN_SEGMENTS	8
+
+/*!
+\brief Maximum number of segments of a tessellated full circle.
+*/
+#define GFX_TESSELLATION_MAX_SEGMENTS	1024
+
+/*!
+\brief Shared cos/sin tables, one per segment count (in steps of GFX_TESSELLATION_MIN_SEGMENTS).
+
+Each table holds the cosines followed by the sines of the segment angles.
+*/
+static float *gfxPrimitivesTessellationTables[GFX_TESSELLATION_MAX_SEGMENTS / GFX_TESSELLATION_MIN_SEGMENTS + 1];
+
+/*!
+\brief Set the tolerance for tessellated drawing of curved primitives.
+
+With a tolerance greater than 0, circles, ellipses, arcs and pies are drawn as
+tessellated line strips or triangle fans. The number of segments then adapts
+to the radius so the chord error stays below the tolerance: small markers get
+few segments and large circles are not faceted.
+
+\param tolerance Maximum deviation in pixels from the true curve, or 0 to use the raster algorithms (default).
+*/
+void gfxPrimitivesSetTessellationTolerance(float tolerance)
+{
+	gfxPrimitivesTessellationTolerance = (tolerance > 0.0f) ? tolerance : 0.0f;
+}
+
+/*!
+\brief Get the tolerance for tessellated drawing of curved primitives.
+
+\returns The current tolerance in pixels; 0 if the raster algorithms are used.
+*/
+float gfxPrimitivesGetTessellationTolerance(void)
+{
+	return gfxPrimitivesTessellationTolerance;
+}
+
+/*!
+\brief Internal calculation of the segment count for a full circle of the given radius.
+
+\param rad The (largest) radius of the curve in pixels.
+\param tolerance The maximum chord error in pixels.
+
+\returns The segment count, a multiple of GFX_TESSELLATION_MIN_SEGMENTS.
+*/
+static Sint32 _gfxTessellationSegments(double rad, double tolerance)
+{
+	Sint32 segments;
+
+	if (rad <= tolerance) {
+		return GFX_TESSELLATION_MIN_SEGMENTS;
+	}
+	segments = (Sint32)SDL_ceil(M_PI / SDL_acos(1.0 - tolerance / rad));
+	segments = (segments + GFX_TESSELLATION_MIN_SEGMENTS - 1) & ~(GFX_TESSELLATION_MIN_SEGMENTS - 1);
+	if (segments < GFX_TESSELLATION_MIN_SEGMENTS) {
+		segments = GFX_TESSELLATION_MIN_SEGMENTS;
+	} else if (segments > GFX_TESSELLATION_MAX_SEGMENTS) {
+		segments = GFX_TESSELLATION_MAX_SEGMENTS;
+	}
+	return segments;
+}
+
+/*!
+\brief Internal lookup (and lazy creation) of the shared cos/sin table for a segment count.
+
+\param segments The segment count as returned by _gfxTessellationSegments.
+
+\returns Pointer to segments cosines followed by segments sines, or NULL on allocation failure.
+*/
+static const float *_gfxTessellationTable(Sint32 segments)
+{
+	Sint32 i, slot;
+	float *table;
+	double da;
+
+	slot = segments / GFX_TESSELLATION_MIN_SEGMENTS;
+	if (gfxPrimitivesTessellationTables[slot] == NULL) {
+		table = (float *) malloc(2 * segments * sizeof(float));
+		if (table == NULL) {
+			return NULL;
+		}
+		da = 2.0 * M_PI / (double)segments;
+		for (i = 0; i < segments; i++) {
+			table[i] = (float)SDL_cos(da * (double)i);
+			table[segments + i] = (float)SDL_sin(da * (double)i);
+		}
+		gfxPrimitivesTessellationTables[slot] = table;
+	}
+	return gfxPrimitivesTessellationTables[slot];
+}
+
+/*!
+\brief Internal calculation of the points of an elliptical arc.
+
+Angles are in degrees, 0 degrees is right (+x), increasing towards +y. The
+end points are exact; the points in between come from the shared table.
+
+\param x X coordinate of the center.
+\param y Y coordinate of the center.
+\param rx Horizontal radius.
+\param ry Vertical radius.
+\param start Start angle of the arc in degrees.
+\param sweep Angle covered by the arc in degrees, 0 < sweep <= 360.
+\param segments Segment count of the full ellipse.
+\param table Shared cos/sin table for the segment count.
+\param pts Output points; room for segments+2 points.
+
+\returns The number of points written.
+*/
+static Sint32 _gfxTessellateArc(double x, double y, double rx, double ry, double start, double sweep, Sint32 segments, const float *table, SDL_FPoint *pts)
+{
+	Sint32 i, first, last, count, k;
+	double a;
+
+	count = 0;
+	a = start * M_PI / 180.0;
+	pts[count].x = (float)(x + rx * SDL_cos(a));
+	pts[count].y = (float)(y + ry * SDL_sin(a));
+	count++;
+
+	/*
+	* Interior table entries strictly between start and end 
+	*/
+	first = (Sint32)SDL_floor(start * (double)segments / 360.0) + 1;
+	last = (Sint32)SDL_ceil((start + sweep) * (double)segments / 360.0) - 1;
+	for (i = first; i <= last; i++) {
+		k = i % segments;
+		if (k < 0) {
+			k += segments;
+		}
+		pts[count].x = (float)(x + rx * table[k]);
+		pts[count].y = (float)(y + ry * table[segments + k]);
+		count++;
+	}
+
+	a = (start + sweep) * M_PI / 180.0;
+	pts[count].x = (float)(x + rx * SDL_cos(a));
+	pts[count].y = (float)(y + ry * SDL_sin(a));
+	count++;
+
+	return count;
+}
+
+/*!
+\brief Internal function to draw a tessellated ellipse, arc or pie with blending.
+
+\param renderer The renderer to draw on.
+\param x X coordinate of the center.
+\param y Y coordinate of the center.
+\param rx Horizontal radius in pixels.
+\param ry Vertical radius in pixels.
+\param start Start angle in degrees (0 is right, increasing towards +y).
+\param sweep Angle covered in degrees, 0 < sweep <= 360.
+\param pie Flag indicating if the center is part of the outline (pie) or not (arc, ellipse).
+\param f Flag indicating if the shape should be filled.
+\param r The red value of the shape to draw. 
+\param g The green value of the shape to draw. 
+\param b The blue value of the shape to draw. 
+\param a The alpha value of the shape to draw.
+
+\returns Returns true on success, false on failure.
+*/
+static bool _gfxTessellatedArcRGBA(SDL_Renderer * renderer, float x, float y, float rx, float ry, double start, double sweep, bool pie, bool f, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	bool result;
+	Sint32 segments, count, i;
+	const float *table;
+	SDL_FPoint *pts;
+	SDL_Vertex *v;
+	int *indices;
+	SDL_FColor color;
+	double cx, cy, erx, ery;
+
+	segments = _gfxTessellationSegments((rx > ry) ? rx : ry, gfxPrimitivesTessellationTolerance);
+	table = _gfxTessellationTable(segments);
+	if (table == NULL) {
+		return (false);
+	}
+
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+
+	if (!f) {
+		/*
+		* Outline: one line strip, closed through the center for pies 
+		*/
+		pts = (SDL_FPoint *) malloc((segments + 4) * sizeof(SDL_FPoint));
+		if (pts == NULL) {
+			return (false);
+		}
+		count = 0;
+		if (pie) {
+			pts[count].x = x;
+			pts[count].y = y;
+			count++;
+		}
+		count += _gfxTessellateArc(x, y, rx, ry, start, sweep, segments, table, &pts[count]);
+		if (pie) {
+			pts[count++] = pts[0];
+		}
+		result &= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		result &= SDL_RenderLines(renderer, pts, count);
+		free(pts);
+		return (result);
+	}
+
+	/*
+	* Fill: triangle fan around the center; geometry addresses pixel edges, so
+	* shift to pixel centers and grow by half a pixel to cover the same pixels as the outline 
+	*/
+	v = (SDL_Vertex *) malloc((segments + 3) * (sizeof(SDL_Vertex) + sizeof(SDL_FPoint)) + 3 * (segments + 2) * sizeof(int));
+	if (v == NULL) {
+		return (false);
+	}
+	pts = (SDL_FPoint *)(v + segments + 3);
+	indices = (int *)(pts + segments + 3);
+
+	cx = (double)x + 0.5;
+	cy = (double)y + 0.5;
+	erx = (double)rx + 0.5;
+	ery = (double)ry + 0.5;
+	count = _gfxTessellateArc(cx, cy, erx, ery, start, sweep, segments, table, pts);
+
+	color.r = (float)r / 255.0f;
+	color.g = (float)g / 255.0f;
+	color.b = (float)b / 255.0f;
+	color.a = (float)a / 255.0f;
+	SDL_memset(v, 0, (count + 1) * sizeof(SDL_Vertex));
+	v[0].position.x = (float)cx;
+	v[0].position.y = (float)cy;
+	v[0].color = color;
+	for (i = 0; i < count; i++) {
+		v[i + 1].position = pts[i];
+		v[i + 1].color = color;
+	}
+	for (i = 0; i < count - 1; i++) {
+		indices[3 * i] = 0;
+		indices[3 * i + 1] = i + 1;
+		indices[3 * i + 2] = i + 2;
+	}
+
+	result &= SDL_RenderGeometry(renderer, NULL, v, count + 1, indices, 3 * (count - 1));
+
+	free(v);
+
+	return (result);
+}
+
 /* ----- Circle */
 
 /*!
@@ -1226,6 +1488,14 @@ bool arcRGBA(SDL_Renderer * renderer, float x, float y, float rad, Sint32 start,
 	start %= 360;
 	end %= 360;
 
+	/*
+	* Tessellated drawing if a tolerance is set; equal angles draw the full circle
+	*/
+	if (gfxPrimitivesTessellationTolerance > 0.0f) {
+		return (_gfxTessellatedArcRGBA(renderer, x, y, rad, rad, (double)start,
+			(end > start) ? (double)(end - start) : (double)(end - start + 360), false, false, r, g, b, a));
+	}
+
 	/* now, we find which octants we're drawing in. */
 	startoct = start / 45;
 	endoct = end / 45;
@@ -1554,6 +1824,13 @@ bool _ellipseRGBA(SDL_Renderer * renderer, float x, float y, float rx, float ry,
 		ry = 1.0f;
 	}
 
+	/*
+	* Tessellated drawing if a tolerance is set
+	*/
+	if (gfxPrimitivesTessellationTolerance > 0.0f) {
+		return (_gfxTessellatedArcRGBA(renderer, x, y, rx, ry, 0.0, 360.0, false, f, r, g, b, a));
+	}
+
 	/*
  	 * Adjust overscan
 	 */
@@ -2088,6 +2365,20 @@ bool _pieRGBA(SDL_Renderer * renderer, float x, float y, float rad, Sint32 start
 		return (pixelRGBA(renderer, x, y, r, g, b, a));
 	}
 
+	/*
+	* Tessellated drawing if a tolerance is set; equal angles draw an empty pie (line)
+	*/
+	if ((gfxPrimitivesTessellationTolerance > 0.0f) && (start != end)) {
+		if (start < 0) {
+			start += 360;
+		}
+		if (end < 0) {
+			end += 360;
+		}
+		return (_gfxTessellatedArcRGBA(renderer, x, y, rad, rad, (double)start,
+			(end > start) ? (double)(end - start) : (double)(end - start + 360), true, filled, r, g, b, a));
+	}
+
 	/*
 	* Variable setup 
 	*/
@@ -2907,233 +3198,232 @@ bool filledPolygonRGBA(SDL_Renderer * renderer, const float * vx, const float *
 	return filledPolygonRGBAMT(renderer, vx, vy, n, r, g, b, a, NULL, NULL);
 }
 
-/* ---- Textured Polygon */
+/* ---- Cached Filled Polygon */
 
 /*!
-\brief Internal function to draw a textured horizontal line.
+\brief Cached span list of one filled polygon (an entry of the polygon cache).
+*/
+typedef struct _gfxPolygonCacheEntry {
+	Uint32 hash;						/*!< Hash of the vertex data. */
+	Sint32 n;							/*!< Number of vertices. */
+	float *vx;							/*!< Copy of the X coordinates, used to verify hash hits. */
+	float *vy;							/*!< Copy of the Y coordinates, used to verify hash hits. */
+	Sint32 *spans;						/*!< Span triplets (xa, xb, y) as computed by the scanline fill. */
+	Sint32 numSpans;					/*!< Number of spans. */
+	size_t size;						/*!< Memory accounted for this entry in bytes. */
+	struct _gfxPolygonCacheEntry *bucketNext;	/*!< Next entry in the hash bucket. */
+	struct _gfxPolygonCacheEntry *lruPrev;	/*!< More recently used entry. */
+	struct _gfxPolygonCacheEntry *lruNext;	/*!< Less recently used entry. */
+} _gfxPolygonCacheEntry;
 
-\param renderer The renderer to draw on.
-\param x1 X coordinate of the first point (i.e. left) of the line.
-\param x2 X coordinate of the second point (i.e. right) of the line.
-\param y Y coordinate of the points of the line.
-\param texture The texture to retrieve color information from.
-\param texture_w The width of the texture.
-\param texture_h The height of the texture.
-\param texture_dx The X offset for the texture lookup.
-\param texture_dy The Y offset for the textured lookup.
+/*!
+\brief Number of hash buckets of the polygon cache (power of two).
+*/
+#define GFX_POLYGON_CACHE_BUCKETS	256
 
-\returns Returns true on success, false on failure.
+/*!
+\brief Hash buckets of the polygon cache.
 */
-bool _HLineTextured(SDL_Renderer *renderer, float x1, float x2, float y, SDL_Texture *texture, Sint32 texture_w, Sint32 texture_h, Sint32 texture_dx, Sint32 texture_dy)
-{
-	float w;
-	float xtmp;
-	bool result = true;
-	Sint32 texture_x_walker;
-	Sint32 texture_y_start;
-	SDL_FRect source_rect,dst_rect;
-	Sint32 pixels_written,write_width;
+static _gfxPolygonCacheEntry *gfxPrimitivesPolyCacheBuckets[GFX_POLYGON_CACHE_BUCKETS];
 
-	/*
-	* Swap x1, x2 if required to ensure x1<=x2
-	*/
-	if (x1 > x2) {
-		xtmp = x1;
-		x1 = x2;
-		x2 = xtmp;
-	}
+/*!
+\brief Most recently used entry of the polygon cache.
+*/
+static _gfxPolygonCacheEntry *gfxPrimitivesPolyCacheHead = NULL;
 
-	/*
-	* Calculate width to draw
-	*/
-	w = x2 - x1 + 1;
+/*!
+\brief Least recently used entry of the polygon cache.
+*/
+static _gfxPolygonCacheEntry *gfxPrimitivesPolyCacheTail = NULL;
 
-	/*
-	* Determine where in the texture we start drawing
-	*/
-	texture_x_walker = ((int)x1 - texture_dx)  % texture_w;
-	if (texture_x_walker < 0){
-		texture_x_walker = texture_w + texture_x_walker ;
-	}
+/*!
+\brief Memory currently used by the polygon cache in bytes.
+*/
+static size_t gfxPrimitivesPolyCacheUsed = 0;
 
-	texture_y_start = ((int)y + texture_dy) % texture_h;
-	if (texture_y_start < 0){
-		texture_y_start = texture_h + texture_y_start;
-	}
+/*!
+\brief Memory limit of the polygon cache in bytes (default 1MB).
+*/
+static size_t gfxPrimitivesPolyCacheLimit = 1024 * 1024;
 
-	/* setup the source rectangle; we are only drawing one horizontal line */
-	source_rect.y = texture_y_start;
-	source_rect.x = texture_x_walker;
-	source_rect.h = 1;
+/*!
+\brief Scratch rectangle array used to replay translated spans.
+*/
+static SDL_FRect *gfxPrimitivesPolyCacheRects = NULL;
 
-	/* we will draw to the current y */
-	dst_rect.y = y;
-	dst_rect.h = 1;
+/*!
+\brief Number of rectangles allocated in the replay scratch array.
+*/
+static Sint32 gfxPrimitivesPolyCacheRectsAllocated = 0;
 
-	/* if there are enough pixels left in the current row of the texture */
-	/* draw it all at once */
-	if (w <= texture_w -texture_x_walker){
-		source_rect.w = w;
-		source_rect.x = texture_x_walker;
-		dst_rect.x= x1;
-		dst_rect.w = source_rect.w;
-		result = SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
-	} else { 
-		/* we need to draw multiple times */
-		/* draw the first segment */
-		pixels_written = texture_w  - texture_x_walker;
-		source_rect.w = pixels_written;
-		source_rect.x = texture_x_walker;
-		dst_rect.x= x1;
-		dst_rect.w = source_rect.w;
-		result &= SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
-		write_width = texture_w;
+/*!
+\brief Internal FNV-1a hash of a polygon vertex array.
 
-		/* now draw the rest */
-		/* set the source x to 0 */
-		source_rect.x = 0;
-		while (pixels_written < w){
-			if (write_width >= w - pixels_written) {
-				write_width =  w - pixels_written;
-			}
-			source_rect.w = write_width;
-			dst_rect.x = x1 + pixels_written;
-			dst_rect.w = source_rect.w;
-			result &= SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
-			pixels_written += write_width;
+\param vx Vertex array containing X coordinates of the points of the polygon.
+\param vy Vertex array containing Y coordinates of the points of the polygon.
+\param n Number of points in the vertex array.
+
+\returns The 32bit hash value.
+*/
+static Uint32 _gfxPolygonCacheHash(const float * vx, const float * vy, Sint32 n)
+{
+	Uint32 hash = 2166136261u;
+	const Uint8 *p;
+	size_t i, len;
+
+	len = n * sizeof(float);
+	p = (const Uint8 *)vx;
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	p = (const Uint8 *)vy;
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	hash = (hash ^ (Uint32)n) * 16777619u;
+	return hash;
+}
+
+/*!
+\brief Internal lookup of a polygon in the cache.
+
+\returns The matching entry or NULL if the polygon is not cached.
+*/
+static _gfxPolygonCacheEntry *_gfxPolygonCacheFind(Uint32 hash, const float * vx, const float * vy, Sint32 n)
+{
+	_gfxPolygonCacheEntry *entry;
+
+	entry = gfxPrimitivesPolyCacheBuckets[hash & (GFX_POLYGON_CACHE_BUCKETS - 1)];
+	while (entry != NULL) {
+		if ((entry->hash == hash) && (entry->n == n) &&
+			(memcmp(entry->vx, vx, n * sizeof(float)) == 0) &&
+			(memcmp(entry->vy, vy, n * sizeof(float)) == 0)) {
+				return entry;
 		}
+		entry = entry->bucketNext;
 	}
+	return NULL;
+}
 
-	return result;
+/*!
+\brief Internal removal of an entry from the LRU list.
+*/
+static void _gfxPolygonCacheUnlink(_gfxPolygonCacheEntry *entry)
+{
+	if (entry->lruPrev) {
+		entry->lruPrev->lruNext = entry->lruNext;
+	} else {
+		gfxPrimitivesPolyCacheHead = entry->lruNext;
+	}
+	if (entry->lruNext) {
+		entry->lruNext->lruPrev = entry->lruPrev;
+	} else {
+		gfxPrimitivesPolyCacheTail = entry->lruPrev;
+	}
+	entry->lruPrev = NULL;
+	entry->lruNext = NULL;
 }
 
 /*!
-\brief Draws a polygon filled with the given texture (Multi-Threading Capable). 
+\brief Internal insertion of an entry at the most recently used end of the LRU list.
+*/
+static void _gfxPolygonCachePushFront(_gfxPolygonCacheEntry *entry)
+{
+	entry->lruPrev = NULL;
+	entry->lruNext = gfxPrimitivesPolyCacheHead;
+	if (gfxPrimitivesPolyCacheHead) {
+		gfxPrimitivesPolyCacheHead->lruPrev = entry;
+	} else {
+		gfxPrimitivesPolyCacheTail = entry;
+	}
+	gfxPrimitivesPolyCacheHead = entry;
+}
 
-\param renderer The renderer to draw on.
-\param vx array of x vector components
-\param vy array of x vector components
-\param n the amount of vectors in the vx and vy array
-\param texture the sdl surface to use to fill the polygon
-\param texture_dx the offset of the texture relative to the screeen. If you move the polygon 10 pixels 
-to the left and want the texture to apear the same you need to increase the texture_dx value
-\param texture_dy see texture_dx
-\param polyInts Preallocated temp array storage for vertex sorting (used for multi-threaded operation)
-\param polyAllocated Flag indicating oif the temp array was allocated (used for multi-threaded operation)
+/*!
+\brief Internal removal and release of a cache entry.
+*/
+static void _gfxPolygonCacheRemove(_gfxPolygonCacheEntry *entry)
+{
+	_gfxPolygonCacheEntry **link;
 
-\returns Returns true on success, false on failure.
+	link = &gfxPrimitivesPolyCacheBuckets[entry->hash & (GFX_POLYGON_CACHE_BUCKETS - 1)];
+	while (*link != entry) {
+		link = &(*link)->bucketNext;
+	}
+	*link = entry->bucketNext;
+	_gfxPolygonCacheUnlink(entry);
+	gfxPrimitivesPolyCacheUsed -= entry->size;
+	free(entry);
+}
+
+/*!
+\brief Internal eviction of least recently used entries until the cache fits the given size.
 */
-bool texturedPolygonMT(SDL_Renderer *renderer, const float * vx, const float * vy, Sint32 n,
-	SDL_Surface * texture, Sint32 texture_dx, Sint32 texture_dy, Sint32 **polyInts, bool *polyAllocated)
+static void _gfxPolygonCacheTrim(size_t limit)
 {
-	bool result;
-	Sint32 i;
-	Sint32 y, xa, xb;
-	Sint32 minx,maxx,miny, maxy;
-	Sint32 x1, y1;
-	Sint32 x2, y2;
-	Sint32 ind1, ind2;
-	Sint32 ints;
-	Sint32 *gfxPrimitivesPolyInts = NULL;
-	Sint32 *gfxPrimitivesPolyIntsTemp = NULL;
-	Sint32 gfxPrimitivesPolyAllocated = 0;
-	SDL_Texture *textureAsTexture = NULL;
-
-	/*
-	* Sanity check number of edges
-	*/
-	if (n < 3) {
-		return false;
+	while ((gfxPrimitivesPolyCacheTail != NULL) && (gfxPrimitivesPolyCacheUsed > limit)) {
+		_gfxPolygonCacheRemove(gfxPrimitivesPolyCacheTail);
 	}
+}
 
-	/*
-	* Map polygon cache  
-	*/
-	if ((polyInts==NULL) || (polyAllocated==NULL)) {
-		/* Use global cache */
-		gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsGlobal;
-		gfxPrimitivesPolyAllocated = gfxPrimitivesPolyAllocatedGlobal;
-	} else {
-		/* Use local cache */
-		gfxPrimitivesPolyInts = *polyInts;
-		gfxPrimitivesPolyAllocated = *polyAllocated;
-	}
+/*!
+\brief Internal computation of the span list of a filled polygon.
 
-	/*
-	* Allocate temp array, only grow array 
-	*/
-	if (!gfxPrimitivesPolyAllocated) {
-		gfxPrimitivesPolyInts = (Sint32 *) malloc(sizeof(int) * n);
-		gfxPrimitivesPolyAllocated = n;
-	} else {
-		if (gfxPrimitivesPolyAllocated < n) {
-			gfxPrimitivesPolyIntsTemp = (Sint32 *) realloc(gfxPrimitivesPolyInts, sizeof(int) * n);
-			if (gfxPrimitivesPolyIntsTemp == NULL) {
-				/* Realloc failed - keeps original memory block, but fails this operation */
-				return(false);
-			}
-			gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsTemp;
-			gfxPrimitivesPolyAllocated = n;
-		}
-	}
+Uses the same scanline intersection and rounding as filledPolygonRGBAMT so that
+replayed spans cover exactly the pixels of an uncached fill.
 
-	/*
-	* Check temp array
-	*/
-	if (gfxPrimitivesPolyInts==NULL) {        
-		gfxPrimitivesPolyAllocated = 0;
-	}
+\param vx Vertex array containing X coordinates of the points of the polygon.
+\param vy Vertex array containing Y coordinates of the points of the polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param hash Hash of the vertex data.
 
-	/*
-	* Update cache variables
-	*/
-	if ((polyInts==NULL) || (polyAllocated==NULL)) { 
-		gfxPrimitivesPolyIntsGlobal =  gfxPrimitivesPolyInts;
-		gfxPrimitivesPolyAllocatedGlobal = gfxPrimitivesPolyAllocated;
-	} else {
-		*polyInts = gfxPrimitivesPolyInts;
-		*polyAllocated = gfxPrimitivesPolyAllocated;
+\returns A new cache entry (not yet linked) or NULL on allocation failure.
+*/
+static _gfxPolygonCacheEntry *_gfxPolygonCacheBuild(const float * vx, const float * vy, Sint32 n, Uint32 hash)
+{
+	_gfxPolygonCacheEntry *entry, *grown;
+	Sint32 *polyInts;
+	Sint32 i, y, xa, xb;
+	Sint32 miny, maxy;
+	Sint32 x1, y1, x2, y2;
+	Sint32 ind1, ind2;
+	Sint32 ints;
+	Sint32 spansAllocated;
+	size_t header;
+
+	polyInts = (Sint32 *) malloc(sizeof(Sint32) * n);
+	if (polyInts == NULL) {
+		return NULL;
 	}
 
 	/*
-	* Check temp array again
+	* Entry, vertex copies and spans live in one block; spans grow at the end 
 	*/
-	if (gfxPrimitivesPolyInts==NULL) {        
-		return false;
+	header = sizeof(_gfxPolygonCacheEntry) + 2 * n * sizeof(float);
+	spansAllocated = n;
+	entry = (_gfxPolygonCacheEntry *) malloc(header + 3 * spansAllocated * sizeof(Sint32));
+	if (entry == NULL) {
+		free(polyInts);
+		return NULL;
 	}
+	entry->numSpans = 0;
 
 	/*
-	* Determine X,Y minima,maxima 
+	* Determine Y maxima 
 	*/
 	miny = vy[0];
 	maxy = vy[0];
-	minx = vx[0];
-	maxx = vx[0];
 	for (i = 1; (i < n); i++) {
 		if (vy[i] < miny) {
 			miny = vy[i];
 		} else if (vy[i] > maxy) {
 			maxy = vy[i];
 		}
-		if (vx[i] < minx) {
-			minx = vx[i];
-		} else if (vx[i] > maxx) {
-			maxx = vx[i];
-		}
 	}
 
-    /* Create texture for drawing */
-	textureAsTexture = SDL_CreateTextureFromSurface(renderer, texture);
-	if (textureAsTexture == NULL)
-	{
-		return false;
-	}
-	SDL_SetTextureBlendMode(textureAsTexture, SDL_BLENDMODE_BLEND);
-	
 	/*
-	* Draw, scanning y 
+	* Scan y and collect spans 
 	*/
-	result = true;
 	for (y = miny; (y <= maxy); y++) {
 		ints = 0;
 		for (i = 0; (i < n); i++) {
@@ -3158,637 +3448,2191 @@ bool texturedPolygonMT(SDL_Renderer *renderer, const float * vx, const float * v
 				continue;
 			}
 			if ( ((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)) ) {
-				gfxPrimitivesPolyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
-			} 
+				polyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+			}
 		}
 
-		qsort(gfxPrimitivesPolyInts, ints, sizeof(int), _gfxPrimitivesCompareInt);
+		qsort(polyInts, ints, sizeof(int), _gfxPrimitivesCompareInt);
 
-		for (i = 0; (i < ints); i += 2) {
-			xa = gfxPrimitivesPolyInts[i] + 1;
+		for (i = 0; (i < ints - 1); i += 2) {
+			xa = polyInts[i] + 1;
 			xa = (xa >> 16) + ((xa & 32768) >> 15);
-			xb = gfxPrimitivesPolyInts[i+1] - 1;
+			xb = polyInts[i+1] - 1;
 			xb = (xb >> 16) + ((xb & 32768) >> 15);
-			result &= _HLineTextured(renderer, xa, xb, y, textureAsTexture, texture->w, texture->h, texture_dx, texture_dy);
+			if (entry->numSpans >= spansAllocated) {
+				spansAllocated *= 2;
+				grown = (_gfxPolygonCacheEntry *) realloc(entry, header + 3 * spansAllocated * sizeof(Sint32));
+				if (grown == NULL) {
+					free(entry);
+					free(polyInts);
+					return NULL;
+				}
+				entry = grown;
+			}
+			entry->spans = (Sint32 *)((Uint8 *)entry + header);
+			entry->spans[3 * entry->numSpans] = (xa < xb) ? xa : xb;
+			entry->spans[3 * entry->numSpans + 1] = (xa < xb) ? xb : xa;
+			entry->spans[3 * entry->numSpans + 2] = y;
+			entry->numSpans++;
 		}
 	}
 
-	SDL_DestroyTexture(textureAsTexture);
+	free(polyInts);
 
-	return result;
+	/*
+	* Fill in the entry; pointers are set last since the block may have moved 
+	*/
+	entry->hash = hash;
+	entry->n = n;
+	entry->vx = (float *)(entry + 1);
+	entry->vy = entry->vx + n;
+	entry->spans = (Sint32 *)((Uint8 *)entry + header);
+	memcpy(entry->vx, vx, n * sizeof(float));
+	memcpy(entry->vy, vy, n * sizeof(float));
+	entry->size = header + 3 * spansAllocated * sizeof(Sint32);
+	entry->bucketNext = NULL;
+	entry->lruPrev = NULL;
+	entry->lruNext = NULL;
+
+	return entry;
 }
 
 /*!
-\brief Draws a polygon filled with the given texture. 
-
-This standard version is calling multithreaded versions with NULL cache parameters.
+\brief Set the memory limit of the filled polygon cache.
 
-\param renderer The renderer to draw on.
-\param vx array of x vector components
-\param vy array of x vector components
-\param n the amount of vectors in the vx and vy array
-\param texture the sdl surface to use to fill the polygon
-\param texture_dx the offset of the texture relative to the screeen. if you move the polygon 10 pixels 
-to the left and want the texture to apear the same you need to increase the texture_dx value
-\param texture_dy see texture_dx
+Least recently used polygons are evicted when the limit is exceeded. A limit
+of 0 disables caching; filledPolygonCachedRGBA then draws uncached.
 
-\returns Returns true on success, false on failure.
+\param size The maximum memory used by the cache in bytes. Default is 1MB.
 */
-bool texturedPolygon(SDL_Renderer *renderer, const float * vx, const float * vy, Sint32 n, SDL_Surface *texture, Sint32 texture_dx, Sint32 texture_dy)
+void gfxPrimitivesSetPolygonCacheSize(size_t size)
 {
-	/*
-	* Draw
-	*/
-	return (texturedPolygonMT(renderer, vx, vy, n, texture, texture_dx, texture_dy, NULL, NULL));
+	gfxPrimitivesPolyCacheLimit = size;
+	_gfxPolygonCacheTrim(size);
 }
 
-/* ---- Character */
-
 /*!
-\brief Global cache for NxM pixel font textures created at runtime.
-*/
-static SDL_Texture *gfxPrimitivesFont[256];
-
-/*!
-\brief Pointer to the current font data. Default is a 8x8 pixel internal font. 
+\brief Remove all polygons from the filled polygon cache and release its memory.
 */
-static const unsigned char *currentFontdata = gfxPrimitivesFontdata;
+void gfxPrimitivesClearPolygonCache(void)
+{
+	_gfxPolygonCacheTrim(0);
+	free(gfxPrimitivesPolyCacheRects);
+	gfxPrimitivesPolyCacheRects = NULL;
+	gfxPrimitivesPolyCacheRectsAllocated = 0;
+}
 
 /*!
-\brief Width of the current font. Default is 8. 
-*/
-static Uint32 charWidth = 8;
+\brief Remove a polygon from the filled polygon cache.
 
-/*!
-\brief Height of the current font. Default is 8. 
-*/
-static Uint32 charHeight = 8;
+Must be called when the application modifies a vertex array in place and
+reuses it, if the old shape should not stay cached until evicted.
 
-/*!
-\brief Width for rendering. Autocalculated.
-*/
-static Uint32 charWidthLocal = 8;
+\param vx Vertex array containing X coordinates of the points of the polygon.
+\param vy Vertex array containing Y coordinates of the points of the polygon.
+\param n Number of points in the vertex array.
 
-/*!
-\brief Height for rendering. Autocalculated.
+\returns Returns true if the polygon was cached, false otherwise.
 */
-static Uint32 charHeightLocal = 8;
+bool gfxPrimitivesInvalidatePolygonCache(const float * vx, const float * vy, Sint32 n)
+{
+	_gfxPolygonCacheEntry *entry;
 
-/*!
-\brief Pitch of the current font in bytes. Default is 1. 
-*/
-static Uint32 charPitch = 1;
+	if ((vx == NULL) || (vy == NULL) || (n < 3)) {
+		return false;
+	}
 
-/*!
-\brief Characters 90deg clockwise rotations. Default is 0. Max is 3. 
-*/
-static Uint32 charRotation = 0;
+	entry = _gfxPolygonCacheFind(_gfxPolygonCacheHash(vx, vy, n), vx, vy, n);
+	if (entry == NULL) {
+		return false;
+	}
+	_gfxPolygonCacheRemove(entry);
+	return true;
+}
 
 /*!
-\brief Character data size in bytes of the current font. Default is 8. 
-*/
-static Uint32 charSize = 8;
+\brief Draw cached filled polygon with alpha blending.
 
-/*!
-\brief Sets or resets the current global font data.
+The scanline spans of the polygon are computed on first use and stored in a
+cache keyed by the vertex data. Subsequent calls with identical vertices only
+translate and submit the stored spans, so static shapes (e.g. map regions)
+skip the intersection and sorting work. The fill matches filledPolygonRGBA.
 
-The font data array is organized in follows: 
-[fontdata] = [character 0][character 1]...[character 255] where
-[character n] = [byte 1 row 1][byte 2 row 1]...[byte {pitch} row 1][byte 1 row 2] ...[byte {pitch} row height] where
-[byte n] = [bit 0]...[bit 7] where 
-[bit n] = [0 for transparent pixel|1 for colored pixel]
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param dx Translation in X applied to the polygon when drawing.
+\param dy Translation in Y applied to the polygon when drawing.
+\param r The red value of the filled polygon to draw. 
+\param g The green value of the filled polygon to draw. 
+\param b The blue value of the filled polygon to draw. 
+\param a The alpha value of the filled polygon to draw.
 
-\param fontdata Pointer to array of font data. Set to NULL, to reset global font to the default 8x8 font.
-\param cw Width of character in bytes. Ignored if fontdata==NULL.
-\param ch Height of character in bytes. Ignored if fontdata==NULL.
+\returns Returns true on success, false on failure.
 */
-void gfxPrimitivesSetFont(const void *fontdata, Uint32 cw, Uint32 ch)
+bool filledPolygonCachedRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, float dx, float dy, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+	bool result;
+	Uint32 hash;
 	Sint32 i;
+	_gfxPolygonCacheEntry *entry;
+	SDL_FRect *rects;
 
-	if ((fontdata) && (cw) && (ch)) {
-		currentFontdata = (unsigned char *)fontdata;
-		charWidth = cw;
-		charHeight = ch;
-	} else {
-		currentFontdata = gfxPrimitivesFontdata;
-		charWidth = 8;
-		charHeight = 8;
+	/*
+	* Vertex array NULL check 
+	*/
+	if ((vx == NULL) || (vy == NULL)) {
+		return (false);
 	}
 
-	charPitch = (charWidth+7)/8;
-	charSize = charPitch * charHeight;
+	/*
+	* Sanity check number of edges
+	*/
+	if (n < 3) {
+		return false;
+	}
 
-	/* Maybe flip width/height for rendering */
-	if ((charRotation==1) || (charRotation==3))
-	{
-		charWidthLocal = charHeight;
-		charHeightLocal = charWidth;
+	/*
+	* Lookup or build the span list 
+	*/
+	hash = _gfxPolygonCacheHash(vx, vy, n);
+	entry = _gfxPolygonCacheFind(hash, vx, vy, n);
+	if (entry != NULL) {
+		_gfxPolygonCacheUnlink(entry);
+		_gfxPolygonCachePushFront(entry);
+	} else {
+		entry = _gfxPolygonCacheBuild(vx, vy, n, hash);
+		if (entry == NULL) {
+			return (false);
+		}
+		if (entry->size <= gfxPrimitivesPolyCacheLimit) {
+			_gfxPolygonCacheTrim(gfxPrimitivesPolyCacheLimit - entry->size);
+			entry->bucketNext = gfxPrimitivesPolyCacheBuckets[hash & (GFX_POLYGON_CACHE_BUCKETS - 1)];
+			gfxPrimitivesPolyCacheBuckets[hash & (GFX_POLYGON_CACHE_BUCKETS - 1)] = entry;
+			_gfxPolygonCachePushFront(entry);
+			gfxPrimitivesPolyCacheUsed += entry->size;
+		}
 	}
-	else
-	{
-		charWidthLocal = charWidth;
-		charHeightLocal = charHeight;
+
+	/*
+	* Grow replay scratch array 
+	*/
+	result = true;
+	if (entry->numSpans > gfxPrimitivesPolyCacheRectsAllocated) {
+		rects = (SDL_FRect *) realloc(gfxPrimitivesPolyCacheRects, entry->numSpans * sizeof(SDL_FRect));
+		if (rects == NULL) {
+			result = false;
+		} else {
+			gfxPrimitivesPolyCacheRects = rects;
+			gfxPrimitivesPolyCacheRectsAllocated = entry->numSpans;
+		}
 	}
 
-	/* Clear character cache */
-	for (i = 0; i < 256; i++) {
-		if (gfxPrimitivesFont[i]) {
-			SDL_DestroyTexture(gfxPrimitivesFont[i]);
-			gfxPrimitivesFont[i] = NULL;
+	/*
+	* Translate spans and draw them in one call 
+	*/
+	if (result && (entry->numSpans > 0)) {
+		rects = gfxPrimitivesPolyCacheRects;
+		for (i = 0; i < entry->numSpans; i++) {
+			rects[i].x = (float)entry->spans[3 * i] + dx;
+			rects[i].y = (float)entry->spans[3 * i + 2] + dy;
+			rects[i].w = (float)(entry->spans[3 * i + 1] - entry->spans[3 * i] + 1);
+			rects[i].h = 1.0f;
 		}
+		result &= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+		result &= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		result &= SDL_RenderFillRects(renderer, rects, entry->numSpans);
 	}
+
+	/*
+	* Entries that did not fit the cache are not linked 
+	*/
+	if ((entry->lruPrev == NULL) && (gfxPrimitivesPolyCacheHead != entry)) {
+		free(entry);
+	}
+
+	return (result);
 }
 
 /*!
-\brief Sets current global font character rotation steps. 
+\brief Draw cached filled polygon with alpha blending.
 
-Default is 0 (no rotation). 1 = 90deg clockwise. 2 = 180deg clockwise. 3 = 270deg clockwise.
-Changing the rotation, will reset the character cache.
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param dx Translation in X applied to the polygon when drawing.
+\param dy Translation in Y applied to the polygon when drawing.
+\param color The color value of the filled polygon to draw (0xRRGGBBAA). 
 
-\param rotation Number of 90deg clockwise steps to rotate
+\returns Returns true on success, false on failure.
 */
-void gfxPrimitivesSetFontRotation(Uint32 rotation)
+bool filledPolygonCachedColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, float dx, float dy, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return filledPolygonCachedRGBA(renderer, vx, vy, n, dx, dy, c[0], c[1], c[2], c[3]);
+}
+
+/* ---- Textured Polygon */
+
+/*!
+\brief Internal function to draw a textured horizontal line.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point (i.e. left) of the line.
+\param x2 X coordinate of the second point (i.e. right) of the line.
+\param y Y coordinate of the points of the line.
+\param texture The texture to retrieve color information from.
+\param texture_w The width of the texture.
+\param texture_h The height of the texture.
+\param texture_dx The X offset for the texture lookup.
+\param texture_dy The Y offset for the textured lookup.
+
+\returns Returns true on success, false on failure.
+*/
+bool _HLineTextured(SDL_Renderer *renderer, float x1, float x2, float y, SDL_Texture *texture, Sint32 texture_w, Sint32 texture_h, Sint32 texture_dx, Sint32 texture_dy)
+{
+	float w;
+	float xtmp;
+	bool result = true;
+	Sint32 texture_x_walker;
+	Sint32 texture_y_start;
+	SDL_FRect source_rect,dst_rect;
+	Sint32 pixels_written,write_width;
+
+	/*
+	* Swap x1, x2 if required to ensure x1<=x2
+	*/
+	if (x1 > x2) {
+		xtmp = x1;
+		x1 = x2;
+		x2 = xtmp;
+	}
+
+	/*
+	* Calculate width to draw
+	*/
+	w = x2 - x1 + 1;
+
+	/*
+	* Determine where in the texture we start drawing
+	*/
+	texture_x_walker = ((int)x1 - texture_dx)  % texture_w;
+	if (texture_x_walker < 0){
+		texture_x_walker = texture_w + texture_x_walker ;
+	}
+
+	texture_y_start = ((int)y + texture_dy) % texture_h;
+	if (texture_y_start < 0){
+		texture_y_start = texture_h + texture_y_start;
+	}
+
+	/* setup the source rectangle; we are only drawing one horizontal line */
+	source_rect.y = texture_y_start;
+	source_rect.x = texture_x_walker;
+	source_rect.h = 1;
+
+	/* we will draw to the current y */
+	dst_rect.y = y;
+	dst_rect.h = 1;
+
+	/* if there are enough pixels left in the current row of the texture */
+	/* draw it all at once */
+	if (w <= texture_w -texture_x_walker){
+		source_rect.w = w;
+		source_rect.x = texture_x_walker;
+		dst_rect.x= x1;
+		dst_rect.w = source_rect.w;
+		result = SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
+	} else { 
+		/* we need to draw multiple times */
+		/* draw the first segment */
+		pixels_written = texture_w  - texture_x_walker;
+		source_rect.w = pixels_written;
+		source_rect.x = texture_x_walker;
+		dst_rect.x= x1;
+		dst_rect.w = source_rect.w;
+		result &= SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
+		write_width = texture_w;
+
+		/* now draw the rest */
+		/* set the source x to 0 */
+		source_rect.x = 0;
+		while (pixels_written < w){
+			if (write_width >= w - pixels_written) {
+				write_width =  w - pixels_written;
+			}
+			source_rect.w = write_width;
+			dst_rect.x = x1 + pixels_written;
+			dst_rect.w = source_rect.w;
+			result &= SDL_RenderTexture(renderer, texture, &source_rect, &dst_rect);
+			pixels_written += write_width;
+		}
+	}
+
+	return result;
+}
+
+/*!
+\brief Draws a polygon filled with the given texture (Multi-Threading Capable). 
+
+\param renderer The renderer to draw on.
+\param vx array of x vector components
+\param vy array of x vector components
+\param n the amount of vectors in the vx and vy array
+\param texture the sdl surface to use to fill the polygon
+\param texture_dx the offset of the texture relative to the screeen. If you move the polygon 10 pixels 
+to the left and want the texture to apear the same you need to increase the texture_dx value
+\param texture_dy see texture_dx
+\param polyInts Preallocated temp array storage for vertex sorting (used for multi-threaded operation)
+\param polyAllocated Flag indicating oif the temp array was allocated (used for multi-threaded operation)
+
+\returns Returns true on success, false on failure.
+*/
+bool texturedPolygonMT(SDL_Renderer *renderer, const float * vx, const float * vy, Sint32 n,
+	SDL_Surface * texture, Sint32 texture_dx, Sint32 texture_dy, Sint32 **polyInts, bool *polyAllocated)
 {
+	bool result;
 	Sint32 i;
+	Sint32 y, xa, xb;
+	Sint32 minx,maxx,miny, maxy;
+	Sint32 x1, y1;
+	Sint32 x2, y2;
+	Sint32 ind1, ind2;
+	Sint32 ints;
+	Sint32 *gfxPrimitivesPolyInts = NULL;
+	Sint32 *gfxPrimitivesPolyIntsTemp = NULL;
+	Sint32 gfxPrimitivesPolyAllocated = 0;
+	SDL_Texture *textureAsTexture = NULL;
+
+	/*
+	* Sanity check number of edges
+	*/
+	if (n < 3) {
+		return false;
+	}
+
+	/*
+	* Map polygon cache  
+	*/
+	if ((polyInts==NULL) || (polyAllocated==NULL)) {
+		/* Use global cache */
+		gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsGlobal;
+		gfxPrimitivesPolyAllocated = gfxPrimitivesPolyAllocatedGlobal;
+	} else {
+		/* Use local cache */
+		gfxPrimitivesPolyInts = *polyInts;
+		gfxPrimitivesPolyAllocated = *polyAllocated;
+	}
+
+	/*
+	* Allocate temp array, only grow array 
+	*/
+	if (!gfxPrimitivesPolyAllocated) {
+		gfxPrimitivesPolyInts = (Sint32 *) malloc(sizeof(int) * n);
+		gfxPrimitivesPolyAllocated = n;
+	} else {
+		if (gfxPrimitivesPolyAllocated < n) {
+			gfxPrimitivesPolyIntsTemp = (Sint32 *) realloc(gfxPrimitivesPolyInts, sizeof(int) * n);
+			if (gfxPrimitivesPolyIntsTemp == NULL) {
+				/* Realloc failed - keeps original memory block, but fails this operation */
+				return(false);
+			}
+			gfxPrimitivesPolyInts = gfxPrimitivesPolyIntsTemp;
+			gfxPrimitivesPolyAllocated = n;
+		}
+	}
+
+	/*
+	* Check temp array
+	*/
+	if (gfxPrimitivesPolyInts==NULL) {        
+		gfxPrimitivesPolyAllocated = 0;
+	}
+
+	/*
+	* Update cache variables
+	*/
+	if ((polyInts==NULL) || (polyAllocated==NULL)) { 
+		gfxPrimitivesPolyIntsGlobal =  gfxPrimitivesPolyInts;
+		gfxPrimitivesPolyAllocatedGlobal = gfxPrimitivesPolyAllocated;
+	} else {
+		*polyInts = gfxPrimitivesPolyInts;
+		*polyAllocated = gfxPrimitivesPolyAllocated;
+	}
+
+	/*
+	* Check temp array again
+	*/
+	if (gfxPrimitivesPolyInts==NULL) {        
+		return false;
+	}
+
+	/*
+	* Determine X,Y minima,maxima 
+	*/
+	miny = vy[0];
+	maxy = vy[0];
+	minx = vx[0];
+	maxx = vx[0];
+	for (i = 1; (i < n); i++) {
+		if (vy[i] < miny) {
+			miny = vy[i];
+		} else if (vy[i] > maxy) {
+			maxy = vy[i];
+		}
+		if (vx[i] < minx) {
+			minx = vx[i];
+		} else if (vx[i] > maxx) {
+			maxx = vx[i];
+		}
+	}
+
+    /* Create texture for drawing */
+	textureAsTexture = SDL_CreateTextureFromSurface(renderer, texture);
+	if (textureAsTexture == NULL)
+	{
+		return false;
+	}
+	SDL_SetTextureBlendMode(textureAsTexture, SDL_BLENDMODE_BLEND);
+	
+	/*
+	* Draw, scanning y 
+	*/
+	result = true;
+	for (y = miny; (y <= maxy); y++) {
+		ints = 0;
+		for (i = 0; (i < n); i++) {
+			if (!i) {
+				ind1 = n - 1;
+				ind2 = 0;
+			} else {
+				ind1 = i - 1;
+				ind2 = i;
+			}
+			y1 = vy[ind1];
+			y2 = vy[ind2];
+			if (y1 < y2) {
+				x1 = vx[ind1];
+				x2 = vx[ind2];
+			} else if (y1 > y2) {
+				y2 = vy[ind1];
+				y1 = vy[ind2];
+				x2 = vx[ind1];
+				x1 = vx[ind2];
+			} else {
+				continue;
+			}
+			if ( ((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)) ) {
+				gfxPrimitivesPolyInts[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+			} 
+		}
+
+		qsort(gfxPrimitivesPolyInts, ints, sizeof(int), _gfxPrimitivesCompareInt);
+
+		for (i = 0; (i < ints); i += 2) {
+			xa = gfxPrimitivesPolyInts[i] + 1;
+			xa = (xa >> 16) + ((xa & 32768) >> 15);
+			xb = gfxPrimitivesPolyInts[i+1] - 1;
+			xb = (xb >> 16) + ((xb & 32768) >> 15);
+			result &= _HLineTextured(renderer, xa, xb, y, textureAsTexture, texture->w, texture->h, texture_dx, texture_dy);
+		}
+	}
+
+	SDL_DestroyTexture(textureAsTexture);
+
+	return result;
+}
+
+/*!
+\brief Draws a polygon filled with the given texture. 
+
+This standard version is calling multithreaded versions with NULL cache parameters.
+
+\param renderer The renderer to draw on.
+\param vx array of x vector components
+\param vy array of x vector components
+\param n the amount of vectors in the vx and vy array
+\param texture the sdl surface to use to fill the polygon
+\param texture_dx the offset of the texture relative to the screeen. if you move the polygon 10 pixels 
+to the left and want the texture to apear the same you need to increase the texture_dx value
+\param texture_dy see texture_dx
+
+\returns Returns true on success, false on failure.
+*/
+bool texturedPolygon(SDL_Renderer *renderer, const float * vx, const float * vy, Sint32 n, SDL_Surface *texture, Sint32 texture_dx, Sint32 texture_dy)
+{
+	/*
+	* Draw
+	*/
+	return (texturedPolygonMT(renderer, vx, vy, n, texture, texture_dx, texture_dy, NULL, NULL));
+}
+
+/* ---- Character */
+
+/*!
+\brief Global cache for NxM pixel font textures created at runtime.
+*/
+static SDL_Texture *gfxPrimitivesFont[256];
+
+/*!
+\brief Pointer to the current font data. Default is a 8x8 pixel internal font. 
+*/
+static const unsigned char *currentFontdata = gfxPrimitivesFontdata;
+
+/*!
+\brief Width of the current font. Default is 8. 
+*/
+static Uint32 charWidth = 8;
+
+/*!
+\brief Height of the current font. Default is 8. 
+*/
+static Uint32 charHeight = 8;
+
+/*!
+\brief Width for rendering. Autocalculated.
+*/
+static Uint32 charWidthLocal = 8;
+
+/*!
+\brief Height for rendering. Autocalculated.
+*/
+static Uint32 charHeightLocal = 8;
+
+/*!
+\brief Pitch of the current font in bytes. Default is 1. 
+*/
+static Uint32 charPitch = 1;
+
+/*!
+\brief Characters 90deg clockwise rotations. Default is 0. Max is 3. 
+*/
+static Uint32 charRotation = 0;
+
+/*!
+\brief Character data size in bytes of the current font. Default is 8. 
+*/
+static Uint32 charSize = 8;
+
+/*!
+\brief Sets or resets the current global font data.
+
+The font data array is organized in follows: 
+[fontdata] = [character 0][character 1]...[character 255] where
+[character n] = [byte 1 row 1][byte 2 row 1]...[byte {pitch} row 1][byte 1 row 2] ...[byte {pitch} row height] where
+[byte n] = [bit 0]...[bit 7] where 
+[bit n] = [0 for transparent pixel|1 for colored pixel]
+
+\param fontdata Pointer to array of font data. Set to NULL, to reset global font to the default 8x8 font.
+\param cw Width of character in bytes. Ignored if fontdata==NULL.
+\param ch Height of character in bytes. Ignored if fontdata==NULL.
+*/
+void gfxPrimitivesSetFont(const void *fontdata, Uint32 cw, Uint32 ch)
+{
+	Sint32 i;
+
+	if ((fontdata) && (cw) && (ch)) {
+		currentFontdata = (unsigned char *)fontdata;
+		charWidth = cw;
+		charHeight = ch;
+	} else {
+		currentFontdata = gfxPrimitivesFontdata;
+		charWidth = 8;
+		charHeight = 8;
+	}
+
+	charPitch = (charWidth+7)/8;
+	charSize = charPitch * charHeight;
+
+	/* Maybe flip width/height for rendering */
+	if ((charRotation==1) || (charRotation==3))
+	{
+		charWidthLocal = charHeight;
+		charHeightLocal = charWidth;
+	}
+	else
+	{
+		charWidthLocal = charWidth;
+		charHeightLocal = charHeight;
+	}
+
+	/* Clear character cache */
+	for (i = 0; i < 256; i++) {
+		if (gfxPrimitivesFont[i]) {
+			SDL_DestroyTexture(gfxPrimitivesFont[i]);
+			gfxPrimitivesFont[i] = NULL;
+		}
+	}
+}
+
+/*!
+\brief Sets current global font character rotation steps. 
+
+Default is 0 (no rotation). 1 = 90deg clockwise. 2 = 180deg clockwise. 3 = 270deg clockwise.
+Changing the rotation, will reset the character cache.
+
+\param rotation Number of 90deg clockwise steps to rotate
+*/
+void gfxPrimitivesSetFontRotation(Uint32 rotation)
+{
+	Sint32 i;
+
+	rotation = rotation & 3;
+	if (charRotation != rotation)
+	{
+		/* Store rotation */
+		charRotation = rotation;
+
+		/* Maybe flip width/height for rendering */
+		if ((charRotation==1) || (charRotation==3))
+		{
+			charWidthLocal = charHeight;
+			charHeightLocal = charWidth;
+		}
+		else
+		{
+			charWidthLocal = charWidth;
+			charHeightLocal = charHeight;
+		}
+
+		/* Clear character cache */
+		for (i = 0; i < 256; i++) {
+			if (gfxPrimitivesFont[i]) {
+				SDL_DestroyTexture(gfxPrimitivesFont[i]);
+				gfxPrimitivesFont[i] = NULL;
+			}
+		}
+	}
+}
+
+/*!
+\brief Draw a character of the currently set font.
+
+\param renderer The Renderer to draw on.
+\param x X (horizontal) coordinate of the upper left corner of the character.
+\param y Y (vertical) coordinate of the upper left corner of the character.
+\param c The character to draw.
+\param r The red value of the character to draw. 
+\param g The green value of the character to draw. 
+\param b The blue value of the character to draw. 
+\param a The alpha value of the character to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool characterRGBA(SDL_Renderer *renderer, float x, float y, char c, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL_FRect srect;
+	SDL_FRect drect;
+	bool result;
+	Uint32 ix, iy;
+	const unsigned char *charpos;
+	Uint8 *curpos;
+	Uint8 patt, mask;
+	Uint8 *linepos;
+	Uint32 pitch;
+	SDL_Surface *character;
+	SDL_Surface *rotatedCharacter;
+	Uint32 ci;
+
+	/*
+	* Setup source rectangle
+	*/
+	srect.x = 0;
+	srect.y = 0;
+	srect.w = charWidthLocal;
+	srect.h = charHeightLocal;
+
+	/*
+	* Setup destination rectangle
+	*/
+	drect.x = x;
+	drect.y = y;
+	drect.w = charWidthLocal;
+	drect.h = charHeightLocal;
+
+	/* Character index in cache */
+	ci = (unsigned char) c;
+
+	/*
+	* Create new charWidth x charHeight bitmap surface if not already present.
+	* Might get rotated later.
+	*/
+	if (gfxPrimitivesFont[ci] == NULL) {
+		/*
+		* Redraw character into surface
+		*/
+		character =	SDL_CreateSurface(
+			charWidth, charHeight, SDL_PIXELFORMAT_RGBA8888);
+		if (character == NULL) {
+			return (false);
+		}
+
+		charpos = currentFontdata + ci * charSize;
+				linepos = (Uint8 *)character->pixels;
+		pitch = character->pitch;
+
+		/*
+		* Drawing loop 
+		*/
+		patt = 0;
+		for (iy = 0; iy < charHeight; iy++) {
+			mask = 0x00;
+			curpos = linepos;
+			for (ix = 0; ix < charWidth; ix++) {
+				if (!(mask >>= 1)) {
+					patt = *charpos++;
+					mask = 0x80;
+				}
+				if (patt & mask) {
+					*(Uint32 *)curpos = 0xffffffff;
+				} else {
+					*(Uint32 *)curpos = 0;
+				}
+				curpos += 4;
+			}
+			linepos += pitch;
+		}
+
+		/* Maybe rotate and replace cached image */
+		if (charRotation>0)
+		{
+			rotatedCharacter = rotateSurface90Degrees(character, charRotation);
+			SDL_DestroySurface(character);
+			character = rotatedCharacter;
+		}
+
+		/* Convert temp surface into texture */
+		gfxPrimitivesFont[ci] = SDL_CreateTextureFromSurface(renderer, character);
+		SDL_DestroySurface(character);
+
+		/*
+		* Check pointer 
+		*/
+		if (gfxPrimitivesFont[ci] == NULL) {
+			return (false);
+		}
+	}
+
+	/*
+	* Set color 
+	*/
+	result = true;
+	result &= SDL_SetTextureColorMod(gfxPrimitivesFont[ci], r, g, b);
+	result &= SDL_SetTextureAlphaMod(gfxPrimitivesFont[ci], a);
+
+	/*
+	* Draw texture onto destination 
+	*/
+	result &= SDL_RenderTexture(renderer, gfxPrimitivesFont[ci], &srect, &drect);
+
+	return (result);
+}
+
+
+/*!
+\brief Draw a character of the currently set font.
+
+\param renderer The renderer to draw on.
+\param x X (horizontal) coordinate of the upper left corner of the character.
+\param y Y (vertical) coordinate of the upper left corner of the character.
+\param c The character to draw.
+\param color The color value of the character to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool characterColor(SDL_Renderer * renderer, float x, float y, char c, Uint32 color)
+{
+	Uint8 *co = (Uint8 *)&color; 
+	return characterRGBA(renderer, x, y, c, co[0], co[1], co[2], co[3]);
+}
+
+
+/*!
+\brief Draw a string in the currently set font.
+
+The spacing between consequtive characters in the string is the fixed number of pixels 
+of the character width of the current global font.
+
+\param renderer The renderer to draw on.
+\param x X (horizontal) coordinate of the upper left corner of the string.
+\param y Y (vertical) coordinate of the upper left corner of the string.
+\param s The string to draw.
+\param color The color value of the string to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool stringColor(SDL_Renderer * renderer, float x, float y, const char *s, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return stringRGBA(renderer, x, y, s, c[0], c[1], c[2], c[3]);
+}
+
+/*!
+\brief Draw a string in the currently set font.
+
+\param renderer The renderer to draw on.
+\param x X (horizontal) coordinate of the upper left corner of the string.
+\param y Y (vertical) coordinate of the upper left corner of the string.
+\param s The string to draw.
+\param r The red value of the string to draw. 
+\param g The green value of the string to draw. 
+\param b The blue value of the string to draw. 
+\param a The alpha value of the string to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool stringRGBA(SDL_Renderer * renderer, float x, float y, const char *s, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	bool result = true;
+	float curx = x;
+	float cury = y;
+	const char *curchar = s;
+
+	while (*curchar && result) {
+		result &= characterRGBA(renderer, curx, cury, *curchar, r, g, b, a);
+		switch (charRotation)
+		{
+		case 0:
+			curx += charWidthLocal;
+			break;
+		case 2:
+			curx -= charWidthLocal;
+			break;
+		case 1:
+			cury += charHeightLocal;
+			break;
+		case 3:
+			cury -= charHeightLocal;
+			break;
+		}
+		curchar++;
+	}
+
+	return (result);
+}
+
+/* ---- Bezier curve */
+
+/*!
+\brief Internal function to calculate bezier interpolator of data array with ndata values at position 't'.
+
+\param data Array of values.
+\param ndata Size of array.
+\param t Position for which to calculate interpolated value. t should be between [0, ndata].
+
+\returns Interpolated value at position t, value[0] when t<0, value[n-1] when t>n.
+*/
+double _evaluateBezier (double *data, Sint32 ndata, double t)
+{
+	double mu, result;
+	Sint32 n,k,kn,nn,nkn;
+	double blend,muk,munk;
+
+	/* Sanity check bounds */
+	if (t<0.0) {
+		return(data[0]);
+	}
+	if (t>=(double)ndata) {
+		return(data[ndata-1]);
+	}
+
+	/* Adjust t to the range 0.0 to 1.0 */ 
+	mu=t/(double)ndata;
+
+	/* Calculate interpolate */
+	n=ndata-1;
+	result=0.0;
+	muk = 1;
+	munk = pow(1-mu,(double)n);
+	for (k=0;k<=n;k++) {
+		nn = n;
+		kn = k;
+		nkn = n - k;
+		blend = muk * munk;
+		muk *= mu;
+		munk /= (1-mu);
+		while (nn >= 1) {
+			blend *= nn;
+			nn--;
+			if (kn > 1) {
+				blend /= (double)kn;
+				kn--;
+			}
+			if (nkn > 1) {
+				blend /= (double)nkn;
+				nkn--;
+			}
+		}
+		result += data[k] * blend;
+	}
+
+	return (result);
+}
+
+/*!
+\brief Draw a bezier curve with alpha blending.
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the bezier curve.
+\param vy Vertex array containing Y coordinates of the points of the bezier curve.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param s Number of steps for the interpolation. Minimum number is 2.
+\param color The color value of the bezier curve to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool bezierColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, Sint32 s, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return bezierRGBA(renderer, vx, vy, n, s, c[0], c[1], c[2], c[3]);
+}
+
+/*!
+\brief Draw a bezier curve with alpha blending.
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the bezier curve.
+\param vy Vertex array containing Y coordinates of the points of the bezier curve.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param s Number of steps for the interpolation. Minimum number is 2.
+\param r The red value of the bezier curve to draw. 
+\param g The green value of the bezier curve to draw. 
+\param b The blue value of the bezier curve to draw. 
+\param a The alpha value of the bezier curve to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool bezierRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, Sint32 s, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	bool result;
+	Sint32 i;
+	double *x, *y, t, stepsize;
+	float x1, y1, x2, y2;
+
+	/*
+	* Sanity check 
+	*/
+	if (n < 3) {
+		return (false);
+	}
+	if (s < 2) {
+		return (false);
+	}
+
+	/*
+	* Variable setup 
+	*/
+	stepsize=(double)1.0/(double)s;
+
+	/* Transfer vertices into float arrays */
+	if ((x=(double *)malloc(sizeof(double)*(n+1)))==NULL) {
+		return(false);
+	}
+	if ((y=(double *)malloc(sizeof(double)*(n+1)))==NULL) {
+		free(x);
+		return(false);
+	}    
+	for (i=0; i<n; i++) {
+		x[i]=(double)vx[i];
+		y[i]=(double)vy[i];
+	}      
+	x[n]=(double)vx[0];
+	y[n]=(double)vy[0];
+
+	/*
+	* Set color 
+	*/
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+	result &= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+	/*
+	* Draw 
+	*/
+	t=0.0;
+	x1=(Sint32)lrint(_evaluateBezier(x,n+1,t));
+	y1=(Sint32)lrint(_evaluateBezier(y,n+1,t));
+	for (i = 0; i <= (n*s); i++) {
+		t += stepsize;
+		x2=(Sint32)_evaluateBezier(x,n,t);
+		y2=(Sint32)_evaluateBezier(y,n,t);
+		result &= line(renderer, x1, y1, x2, y2);
+		x1 = x2;
+		y1 = y2;
+	}
+
+	/* Clean up temporary array */
+	free(x);
+	free(y);
+
+	return (result);
+}
+
+
+/*!
+\brief Draw a thick line with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >0.
+\param color The color value of the line to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool thickLineColor(SDL_Renderer *renderer, float x1, float y1, float x2, float y2, float width, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return thickLineRGBA(renderer, x1, y1, x2, y2, width, c[0], c[1], c[2], c[3]);
+}
+
+/*!
+\brief Draw a thick line with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >0.
+\param r The red value of the character to draw. 
+\param g The green value of the character to draw. 
+\param b The blue value of the character to draw. 
+\param a The alpha value of the character to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool thickLineRGBA(SDL_Renderer *renderer, float x1, float y1, float x2, float y2, float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	Sint32 wh;
+	double dx, dy, dx1, dy1, dx2, dy2;
+	double l, wl2, nx, ny, ang, adj;
+	float px[4], py[4];
+
+	if (renderer == NULL) {
+		return false;
+	}
+
+	if (width < 1) {
+		return false;
+	}
+
+	/* Special case: thick "point" */
+	if ((x1 == x2) && (y1 == y2)) {
+		wh = width / 2;
+		return boxRGBA(renderer, x1 - wh, y1 - wh, x2 + width, y2 + width, r, g, b, a);		
+	}
+
+	/* Special case: width == 1 */
+	if (width == 1) {
+		return lineRGBA(renderer, x1, y1, x2, y2, r, g, b, a);		
+	}
+
+	/* Calculate offsets for sides */
+	dx = (double)(x2 - x1);
+	dy = (double)(y2 - y1);
+	l = SDL_sqrt(dx*dx + dy*dy);
+	ang = SDL_atan2(dx, dy);
+	adj = 0.1 + 0.9 * SDL_fabs(SDL_cos(2.0 * ang));
+	wl2 = ((double)width - adj)/(2.0 * l);
+	nx = dx * wl2;
+	ny = dy * wl2;
+
+	/* Build polygon */
+	dx1 = (double)x1;
+	dy1 = (double)y1;
+	dx2 = (double)x2;
+	dy2 = (double)y2;
+	px[0] = (float)(dx1 + ny);
+	px[1] = (float)(dx1 - ny);
+	px[2] = (float)(dx2 - ny);
+	px[3] = (float)(dx2 + ny);
+	py[0] = (float)(dy1 - nx);
+	py[1] = (float)(dy1 + nx);
+	py[2] = (float)(dy2 + nx);
+	py[3] = (float)(dy2 - nx);
+
+	/* Draw polygon */
+	return filledPolygonRGBA(renderer, px, py, 4, r, g, b, a);
+}
+
+/* ---- AA Thick Line */
+
+/*!
+\brief Miter scale limit for joins of anti-aliased thick polylines.
+
+Joins sharper than this would produce long spikes; their offset is clamped.
+*/
+#define GFX_AATHICKLINE_MITER_LIMIT	4.0
+
+/*!
+\brief Internal helper to set one row of four vertices across an anti-aliased thick line.
+
+The row runs from the outer left edge to the outer right edge; the two outer
+vertices carry zero alpha so the renderer feathers the edges over one pixel.
+*/
+static void _aaThickLineRow(SDL_Vertex *v, double px, double py, double nx, double ny, double inner, double outer, const SDL_FColor *core, const SDL_FColor *edge)
+{
+	v[0].position.x = (float)(px + nx * outer);
+	v[0].position.y = (float)(py + ny * outer);
+	v[0].color = *edge;
+	v[1].position.x = (float)(px + nx * inner);
+	v[1].position.y = (float)(py + ny * inner);
+	v[1].color = *core;
+	v[2].position.x = (float)(px - nx * inner);
+	v[2].position.y = (float)(py - ny * inner);
+	v[2].color = *core;
+	v[3].position.x = (float)(px - nx * outer);
+	v[3].position.y = (float)(py - ny * outer);
+	v[3].color = *edge;
+}
+
+/*!
+\brief Draw anti-aliased thick polyline with alpha blending.
+
+The polyline is built as a strip of core quads with one-pixel feathered edge
+quads on both sides and at both ends. Joins are mitered (with a limit) and
+the whole line is submitted in a single SDL_RenderGeometry call.
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the polyline.
+\param vy Vertex array containing Y coordinates of the points of the polyline.
+\param n Number of points in the vertex array. Minimum number is 2.
+\param width Width of the line in pixels. Must be >=1.
+\param r The red value of the line to draw. 
+\param g The green value of the line to draw. 
+\param b The blue value of the line to draw. 
+\param a The alpha value of the line to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool aaThickPolylineRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	bool result;
+	Sint32 i, k, m, rows;
+	Sint32 *pts;
+	double hw, inner, outer;
+	double dx, dy, l, nx, ny, mx, my, ml, scale;
+	double px, py;
+	double *dirs;
+	SDL_FColor core, edge;
+	SDL_Vertex *v;
+	int *indices, *idx;
+
+	if ((renderer == NULL) || (vx == NULL) || (vy == NULL) || (n < 2)) {
+		return (false);
+	}
+
+	if (width < 1) {
+		return (false);
+	}
+
+	/*
+	* Scratch: segment directions, vertices, triangle indices, point indices
+	* (largest alignment first, so no padding is needed) 
+	*/
+	rows = n + 2;
+	dirs = (double *) malloc(2 * n * sizeof(double) + 4 * rows * sizeof(SDL_Vertex) + 18 * (rows - 1) * sizeof(int) + n * sizeof(Sint32));
+	if (dirs == NULL) {
+		return (false);
+	}
+	v = (SDL_Vertex *)(dirs + 2 * n);
+	indices = (int *)(v + 4 * rows);
+	pts = (Sint32 *)(indices + 18 * (rows - 1));
+
+	/*
+	* Drop coincident points and compute unit directions of the remaining segments 
+	*/
+	m = 0;
+	pts[m++] = 0;
+	for (i = 1; i < n; i++) {
+		dx = (double)vx[i] - (double)vx[pts[m - 1]];
+		dy = (double)vy[i] - (double)vy[pts[m - 1]];
+		l = SDL_sqrt(dx * dx + dy * dy);
+		if (l < 1e-6) {
+			continue;
+		}
+		dirs[2 * (m - 1)] = dx / l;
+		dirs[2 * (m - 1) + 1] = dy / l;
+		pts[m++] = i;
+	}
+
+	/*
+	* Special case: thick "point" 
+	*/
+	if (m < 2) {
+		free(dirs);
+		hw = width / 2.0;
+		return aaThickLineRGBA(renderer, vx[0] - (float)hw, vy[0], vx[0] + (float)hw, vy[0], width, r, g, b, a);
+	}
+
+	core.r = (float)r / 255.0f;
+	core.g = (float)g / 255.0f;
+	core.b = (float)b / 255.0f;
+	core.a = (float)a / 255.0f;
+	edge = core;
+	edge.a = 0.0f;
+
+	hw = (double)width / 2.0;
+	inner = hw - 0.5;
+	outer = hw + 0.5;
+	SDL_memset(v, 0, 4 * (m + 2) * sizeof(SDL_Vertex));
+
+	/*
+	* One row per point, offset along the (mitered) normal; coordinates address pixel centers 
+	*/
+	for (i = 0; i < m; i++) {
+		px = (double)vx[pts[i]] + 0.5;
+		py = (double)vy[pts[i]] + 0.5;
+		if (i == 0) {
+			nx = -dirs[1];
+			ny = dirs[0];
+			scale = 1.0;
+		} else if (i == m - 1) {
+			nx = -dirs[2 * (i - 1) + 1];
+			ny = dirs[2 * (i - 1)];
+			scale = 1.0;
+		} else {
+			nx = -dirs[2 * (i - 1) + 1];
+			ny = dirs[2 * (i - 1)];
+			mx = nx - dirs[2 * i + 1];
+			my = ny + dirs[2 * i];
+			ml = SDL_sqrt(mx * mx + my * my);
+			if (ml < 1e-6) {
+				/* Full reversal: keep the incoming normal */
+				mx = nx;
+				my = ny;
+				scale = 1.0;
+			} else {
+				mx /= ml;
+				my /= ml;
+				scale = 1.0 / (mx * nx + my * ny);
+				if (scale > GFX_AATHICKLINE_MITER_LIMIT) {
+					scale = GFX_AATHICKLINE_MITER_LIMIT;
+				}
+			}
+			nx = mx;
+			ny = my;
+		}
+		_aaThickLineRow(&v[4 * (i + 1)], px, py, nx * scale, ny * scale, inner, outer, &core, &edge);
+	}
+
+	/*
+	* End cap rows one pixel beyond the end points, fully transparent 
+	*/
+	for (k = 0; k < 4; k++) {
+		v[k] = v[4 + k];
+		v[k].position.x -= (float)dirs[0];
+		v[k].position.y -= (float)dirs[1];
+		v[k].color = edge;
+		v[4 * (m + 1) + k] = v[4 * m + k];
+		v[4 * (m + 1) + k].position.x += (float)dirs[2 * (m - 2)];
+		v[4 * (m + 1) + k].position.y += (float)dirs[2 * (m - 2) + 1];
+		v[4 * (m + 1) + k].color = edge;
+	}
+
+	/*
+	* Three quads between consecutive rows 
+	*/
+	idx = indices;
+	for (i = 0; i < m + 1; i++) {
+		for (k = 0; k < 3; k++) {
+			*idx++ = 4 * i + k;
+			*idx++ = 4 * i + k + 1;
+			*idx++ = 4 * (i + 1) + k + 1;
+			*idx++ = 4 * i + k;
+			*idx++ = 4 * (i + 1) + k + 1;
+			*idx++ = 4 * (i + 1) + k;
+		}
+	}
+
+	/*
+	* Draw
+	*/
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	result &= SDL_RenderGeometry(renderer, NULL, v, 4 * (m + 2), indices, 18 * (m + 1));
+
+	free(dirs);
+
+	return (result);
+}
+
+/*!
+\brief Draw anti-aliased thick polyline with alpha blending.
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the polyline.
+\param vy Vertex array containing Y coordinates of the points of the polyline.
+\param n Number of points in the vertex array. Minimum number is 2.
+\param width Width of the line in pixels. Must be >=1.
+\param color The color value of the line to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool aaThickPolylineColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, float width, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return aaThickPolylineRGBA(renderer, vx, vy, n, width, c[0], c[1], c[2], c[3]);
+}
+
+/*!
+\brief Draw anti-aliased thick line with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >=1.
+\param r The red value of the line to draw. 
+\param g The green value of the line to draw. 
+\param b The blue value of the line to draw. 
+\param a The alpha value of the line to draw.
+
+\returns Returns true on success, false on failure.
+*/
+bool aaThickLineRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2, float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	float px[2], py[2];
+
+	/* Special case: thick "point" becomes a square of the line width */
+	if ((x1 == x2) && (y1 == y2)) {
+		x1 -= width / 2;
+		x2 += width / 2;
+	}
+
+	px[0] = x1;
+	py[0] = y1;
+	px[1] = x2;
+	py[1] = y2;
+	return aaThickPolylineRGBA(renderer, px, py, 2, width, r, g, b, a);
+}
+
+/*!
+\brief Draw anti-aliased thick line with alpha blending.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the line.
+\param y1 Y coordinate of the first point of the line.
+\param x2 X coordinate of the second point of the line.
+\param y2 Y coordinate of the second point of the line.
+\param width Width of the line in pixels. Must be >=1.
+\param color The color value of the line to draw (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool aaThickLineColor(SDL_Renderer * renderer, float x1, float y1, float x2, float y2, float width, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return aaThickLineRGBA(renderer, x1, y1, x2, y2, width, c[0], c[1], c[2], c[3]);
+}
+
+/* ---- Gradient fills */
+
+/*!
+\brief Internal helper to convert a packed color into a float color for geometry rendering.
+
+\param color The color value to convert (0xRRGGBBAA).
+\param fc Pointer to the float color to fill.
+
+\returns Returns true if the color is fully opaque, false otherwise.
+*/
+static bool _gradientColor(Uint32 color, SDL_FColor *fc)
+{
+	Uint8 *c = (Uint8 *)&color;
+	fc->r = (float)c[0] / 255.0f;
+	fc->g = (float)c[1] / 255.0f;
+	fc->b = (float)c[2] / 255.0f;
+	fc->a = (float)c[3] / 255.0f;
+	return (c[3] == 255);
+}
+
+/*!
+\brief Draw box (filled rectangle) with a four-corner color gradient.
+
+The colors are interpolated across the box by the renderer, so the whole
+gradient is drawn with a single geometry call and no overdraw.
+
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the box.
+\param y1 Y coordinate of the first point of the box.
+\param x2 X coordinate of the second point of the box.
+\param y2 Y coordinate of the second point of the box.
+\param c1 The color value of the top left corner (0xRRGGBBAA). 
+\param c2 The color value of the top right corner (0xRRGGBBAA). 
+\param c3 The color value of the bottom right corner (0xRRGGBBAA). 
+\param c4 The color value of the bottom left corner (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool boxGradient(SDL_Renderer * renderer, float x1, float y1, float x2, float y2, Uint32 c1, Uint32 c2, Uint32 c3, Uint32 c4)
+{
+	bool result;
+	bool opaque;
+	float tmp;
+	SDL_Vertex v[4];
+	static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	if (renderer == NULL) {
+		return (false);
+	}
+
+	/*
+	* Swap x1, x2 if required 
+	*/
+	if (x1 > x2) {
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+	}
+
+	/*
+	* Swap y1, y2 if required 
+	*/
+	if (y1 > y2) {
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
+	}
+
+	/*
+	* Corners cover the same pixels as boxRGBA 
+	*/
+	SDL_memset(v, 0, sizeof(v));
+	v[0].position.x = x1;
+	v[0].position.y = y1;
+	v[1].position.x = x2 + 1;
+	v[1].position.y = y1;
+	v[2].position.x = x2 + 1;
+	v[2].position.y = y2 + 1;
+	v[3].position.x = x1;
+	v[3].position.y = y2 + 1;
+	opaque = _gradientColor(c1, &v[0].color);
+	opaque &= _gradientColor(c2, &v[1].color);
+	opaque &= _gradientColor(c3, &v[2].color);
+	opaque &= _gradientColor(c4, &v[3].color);
+
+	/*
+	* Draw
+	*/
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, (opaque) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+	result &= SDL_RenderGeometry(renderer, NULL, v, 4, indices, 6);
+	return result;
+}
+
+/*!
+\brief Internal helper to test if point p lies inside (or on) the triangle a, b, c of the given orientation.
+*/
+static bool _gradientPointInTriangle(const float *vx, const float *vy, int a, int b, int c, int p, float orient)
+{
+	float d1, d2, d3;
+
+	d1 = orient * ((vx[b] - vx[a]) * (vy[p] - vy[a]) - (vy[b] - vy[a]) * (vx[p] - vx[a]));
+	d2 = orient * ((vx[c] - vx[b]) * (vy[p] - vy[b]) - (vy[c] - vy[b]) * (vx[p] - vx[b]));
+	d3 = orient * ((vx[a] - vx[c]) * (vy[p] - vy[c]) - (vy[a] - vy[c]) * (vx[p] - vx[c]));
+	return ((d1 >= 0.0f) && (d2 >= 0.0f) && (d3 >= 0.0f));
+}
+
+/*!
+\brief Internal ear-clipping triangulation of a simple polygon.
+
+Self-intersecting input has no valid ear at some point; the remaining
+vertices are then emitted as a fan so that the call still draws something sensible.
+
+\param vx Vertex array containing X coordinates of the points of the polygon.
+\param vy Vertex array containing Y coordinates of the points of the polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param indices Output index array with room for 3*(n-2) entries.
+\param remaining Scratch array with room for n entries.
+
+\returns Returns the number of indices written.
+*/
+static int _gradientTriangulate(const float *vx, const float *vy, int n, int *indices, int *remaining)
+{
+	int i, j, count, ni, prev, next, cur;
+	float area, orient, cross;
+	bool ear;
+
+	/*
+	* Determine orientation from the signed area 
+	*/
+	area = 0.0f;
+	for (i = 0, j = n - 1; i < n; j = i++) {
+		area += vx[j] * vy[i] - vx[i] * vy[j];
+	}
+	orient = (area < 0.0f) ? -1.0f : 1.0f;
 
-	rotation = rotation & 3;
-	if (charRotation != rotation)
-	{
-		/* Store rotation */
-		charRotation = rotation;
+	for (i = 0; i < n; i++) {
+		remaining[i] = i;
+	}
+	count = n;
+	ni = 0;
 
-		/* Maybe flip width/height for rendering */
-		if ((charRotation==1) || (charRotation==3))
-		{
-			charWidthLocal = charHeight;
-			charHeightLocal = charWidth;
-		}
-		else
-		{
-			charWidthLocal = charWidth;
-			charHeightLocal = charHeight;
+	i = 0;
+	j = 0;
+	while (count > 3) {
+		prev = remaining[(i + count - 1) % count];
+		cur = remaining[i];
+		next = remaining[(i + 1) % count];
+
+		/*
+		* Ear test: convex corner with no other vertex inside 
+		*/
+		cross = orient * ((vx[cur] - vx[prev]) * (vy[next] - vy[prev]) - (vy[cur] - vy[prev]) * (vx[next] - vx[prev]));
+		ear = (cross > 0.0f);
+		if (ear) {
+			int k;
+			for (k = 0; k < count; k++) {
+				int p = remaining[k];
+				if ((p == prev) || (p == cur) || (p == next)) {
+					continue;
+				}
+				if (_gradientPointInTriangle(vx, vy, prev, cur, next, p, orient)) {
+					ear = false;
+					break;
+				}
+			}
 		}
 
-		/* Clear character cache */
-		for (i = 0; i < 256; i++) {
-			if (gfxPrimitivesFont[i]) {
-				SDL_DestroyTexture(gfxPrimitivesFont[i]);
-				gfxPrimitivesFont[i] = NULL;
+		if (ear) {
+			indices[ni++] = prev;
+			indices[ni++] = cur;
+			indices[ni++] = next;
+			SDL_memmove(&remaining[i], &remaining[i + 1], (count - i - 1) * sizeof(int));
+			count--;
+			if (i >= count) {
+				i = 0;
+			}
+			j = 0;
+		} else {
+			i = (i + 1) % count;
+			j++;
+			if (j >= count) {
+				/* No ear found: degenerate or self-intersecting, fan the rest */
+				for (i = 1; i < count - 1; i++) {
+					indices[ni++] = remaining[0];
+					indices[ni++] = remaining[i];
+					indices[ni++] = remaining[i + 1];
+				}
+				return ni;
 			}
 		}
 	}
+
+	indices[ni++] = remaining[0];
+	indices[ni++] = remaining[1];
+	indices[ni++] = remaining[2];
+	return ni;
 }
 
 /*!
-\brief Draw a character of the currently set font.
+\brief Draw filled polygon with per-vertex colors.
 
-\param renderer The Renderer to draw on.
-\param x X (horizontal) coordinate of the upper left corner of the character.
-\param y Y (vertical) coordinate of the upper left corner of the character.
-\param c The character to draw.
-\param r The red value of the character to draw. 
-\param g The green value of the character to draw. 
-\param b The blue value of the character to draw. 
-\param a The alpha value of the character to draw.
+The polygon is triangulated once and the colors are interpolated across the
+triangles by the renderer. The polygon should be simple (not self-intersecting).
+
+\param renderer The renderer to draw on.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param colors Color array containing one color value per vertex (0xRRGGBBAA).
+\param n Number of points in the vertex and color arrays. Minimum number is 3.
 
 \returns Returns true on success, false on failure.
 */
-bool characterRGBA(SDL_Renderer *renderer, float x, float y, char c, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+bool filledPolygonGradient(SDL_Renderer * renderer, const float * vx, const float * vy, const Uint32 * colors, Sint32 n)
 {
-	SDL_FRect srect;
-	SDL_FRect drect;
 	bool result;
-	Uint32 ix, iy;
-	const unsigned char *charpos;
-	Uint8 *curpos;
-	Uint8 patt, mask;
-	Uint8 *linepos;
-	Uint32 pitch;
-	SDL_Surface *character;
-	SDL_Surface *rotatedCharacter;
-	Uint32 ci;
+	bool opaque;
+	Sint32 i;
+	int numIndices;
+	SDL_Vertex *v;
+	int *indices;
+	int *remaining;
 
 	/*
-	* Setup source rectangle
+	* Sanity check number of edges
 	*/
-	srect.x = 0;
-	srect.y = 0;
-	srect.w = charWidthLocal;
-	srect.h = charHeightLocal;
+	if ((renderer == NULL) || (vx == NULL) || (vy == NULL) || (colors == NULL) || (n < 3)) {
+		return (false);
+	}
 
 	/*
-	* Setup destination rectangle
+	* Allocate vertices, indices and scratch in one block 
 	*/
-	drect.x = x;
-	drect.y = y;
-	drect.w = charWidthLocal;
-	drect.h = charHeightLocal;
+	v = (SDL_Vertex *) malloc(n * sizeof(SDL_Vertex) + (3 * (n - 2) + n) * sizeof(int));
+	if (v == NULL) {
+		return (false);
+	}
+	indices = (int *) (v + n);
+	remaining = indices + 3 * (n - 2);
+
+	opaque = true;
+	for (i = 0; i < n; i++) {
+		v[i].position.x = vx[i];
+		v[i].position.y = vy[i];
+		v[i].tex_coord.x = 0.0f;
+		v[i].tex_coord.y = 0.0f;
+		opaque &= _gradientColor(colors[i], &v[i].color);
+	}
 
-	/* Character index in cache */
-	ci = (unsigned char) c;
+	numIndices = _gradientTriangulate(vx, vy, n, indices, remaining);
 
 	/*
-	* Create new charWidth x charHeight bitmap surface if not already present.
-	* Might get rotated later.
+	* Draw
 	*/
-	if (gfxPrimitivesFont[ci] == NULL) {
-		/*
-		* Redraw character into surface
-		*/
-		character =	SDL_CreateSurface(
-			charWidth, charHeight, SDL_PIXELFORMAT_RGBA8888);
-		if (character == NULL) {
-			return (false);
-		}
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, (opaque) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+	result &= SDL_RenderGeometry(renderer, NULL, v, n, indices, numIndices);
 
-		charpos = currentFontdata + ci * charSize;
-				linepos = (Uint8 *)character->pixels;
-		pitch = character->pitch;
+	free(v);
 
-		/*
-		* Drawing loop 
-		*/
-		patt = 0;
-		for (iy = 0; iy < charHeight; iy++) {
-			mask = 0x00;
-			curpos = linepos;
-			for (ix = 0; ix < charWidth; ix++) {
-				if (!(mask >>= 1)) {
-					patt = *charpos++;
-					mask = 0x80;
-				}
-				if (patt & mask) {
-					*(Uint32 *)curpos = 0xffffffff;
-				} else {
-					*(Uint32 *)curpos = 0;
-				}
-				curpos += 4;
-			}
-			linepos += pitch;
-		}
+	return (result);
+}
 
-		/* Maybe rotate and replace cached image */
-		if (charRotation>0)
-		{
-			rotatedCharacter = rotateSurface90Degrees(character, charRotation);
-			SDL_DestroySurface(character);
-			character = rotatedCharacter;
-		}
+/*!
+\brief Draw filled circle with a radial color gradient.
 
-		/* Convert temp surface into texture */
-		gfxPrimitivesFont[ci] = SDL_CreateTextureFromSurface(renderer, character);
-		SDL_DestroySurface(character);
+The circle is drawn as a triangle fan around the center; the renderer
+interpolates from the inner color at the center to the outer color at the rim.
 
-		/*
-		* Check pointer 
-		*/
-		if (gfxPrimitivesFont[ci] == NULL) {
-			return (false);
-		}
+\param renderer The renderer to draw on.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param inner The color value at the center of the circle (0xRRGGBBAA). 
+\param outer The color value at the rim of the circle (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool filledCircleRadialGradient(SDL_Renderer * renderer, float x, float y, float rad, Uint32 inner, Uint32 outer)
+{
+	bool result;
+	bool opaque;
+	Sint32 i, segments;
+	double cx, cy;
+	const float *table;
+	SDL_FColor rim;
+	SDL_Vertex *v;
+	int *indices;
+
+	/*
+	* Sanity check radius 
+	*/
+	if ((renderer == NULL) || (rad < 0)) {
+		return (false);
 	}
 
 	/*
-	* Set color 
+	* Special case for rad=0 - draw a point 
 	*/
-	result = true;
-	result &= SDL_SetTextureColorMod(gfxPrimitivesFont[ci], r, g, b);
-	result &= SDL_SetTextureAlphaMod(gfxPrimitivesFont[ci], a);
+	if (rad == 0) {
+		return (pixelColor(renderer, x, y, inner));
+	}
 
 	/*
-	* Draw texture onto destination 
+	* Segment count follows the tessellation tolerance, or a quarter pixel if none is set 
 	*/
-	result &= SDL_RenderTexture(renderer, gfxPrimitivesFont[ci], &srect, &drect);
+	segments = _gfxTessellationSegments(rad, (gfxPrimitivesTessellationTolerance > 0.0f) ? gfxPrimitivesTessellationTolerance : 0.25);
+	table = _gfxTessellationTable(segments);
+	if (table == NULL) {
+		return (false);
+	}
+
+	v = (SDL_Vertex *) malloc((segments + 1) * sizeof(SDL_Vertex) + 3 * segments * sizeof(int));
+	if (v == NULL) {
+		return (false);
+	}
+	indices = (int *) (v + segments + 1);
+
+	/*
+	* Center vertex at the pixel center, rim vertices around it 
+	*/
+	cx = (double)x + 0.5;
+	cy = (double)y + 0.5;
+	SDL_memset(v, 0, (segments + 1) * sizeof(SDL_Vertex));
+	v[0].position.x = (float)cx;
+	v[0].position.y = (float)cy;
+	opaque = _gradientColor(inner, &v[0].color);
+	opaque &= _gradientColor(outer, &rim);
+	for (i = 0; i < segments; i++) {
+		v[i + 1].position.x = (float)(cx + (double)rad * table[i]);
+		v[i + 1].position.y = (float)(cy + (double)rad * table[segments + i]);
+		v[i + 1].color = rim;
+		indices[3 * i] = 0;
+		indices[3 * i + 1] = i + 1;
+		indices[3 * i + 2] = (i + 1) % segments + 1;
+	}
+
+	/*
+	* Draw
+	*/
+	result = true;
+	result &= SDL_SetRenderDrawBlendMode(renderer, (opaque) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+	result &= SDL_RenderGeometry(renderer, NULL, v, segments + 1, indices, 3 * segments);
+
+	free(v);
 
 	return (result);
 }
 
+/* ---- Pattern fills */
 
 /*!
-\brief Draw a character of the currently set font.
+\brief Largest supported pattern size (width and height in pixels).
+*/
+#define GFX_PATTERN_MAX_SIZE	64
 
-\param renderer The renderer to draw on.
-\param x X (horizontal) coordinate of the upper left corner of the character.
-\param y Y (vertical) coordinate of the upper left corner of the character.
-\param c The character to draw.
-\param color The color value of the character to draw (0xRRGGBBAA). 
+/*!
+\brief Number of pattern textures kept in the pattern cache.
+*/
+#define GFX_PATTERN_CACHE_ENTRIES	16
 
-\returns Returns true on success, false on failure.
+/*!
+\brief Cached repeating texture of one fill pattern.
 */
-bool characterColor(SDL_Renderer * renderer, float x, float y, char c, Uint32 color)
-{
-	Uint8 *co = (Uint8 *)&color; 
-	return characterRGBA(renderer, x, y, c, co[0], co[1], co[2], co[3]);
-}
+typedef struct {
+	SDL_Renderer *renderer;		/*!< Renderer the texture was created for. */
+	SDL_Texture *texture;		/*!< White/transparent pattern texture. */
+	Uint32 size;				/*!< Pattern width and height in pixels. */
+	Uint32 stamp;				/*!< Last use, for LRU replacement. */
+	Uint8 bits[GFX_PATTERN_MAX_SIZE * GFX_PATTERN_MAX_SIZE / 8];	/*!< Copy of the pattern bits. */
+} _gfxPatternCacheEntry;
 
+/*!
+\brief Pattern texture cache.
+*/
+static _gfxPatternCacheEntry gfxPrimitivesPatternCache[GFX_PATTERN_CACHE_ENTRIES];
 
 /*!
-\brief Draw a string in the currently set font.
+\brief Use counter of the pattern texture cache.
+*/
+static Uint32 gfxPrimitivesPatternStamp = 0;
 
-The spacing between consequtive characters in the string is the fixed number of pixels 
-of the character width of the current global font.
+/*!
+\brief Renderer property that tracks the lifetime of cached pattern textures.
+*/
+#define GFX_PATTERN_RENDERER_PROPERTY	"SDL_gfx.pattern_cache"
 
-\param renderer The renderer to draw on.
-\param x X (horizontal) coordinate of the upper left corner of the string.
-\param y Y (vertical) coordinate of the upper left corner of the string.
-\param s The string to draw.
-\param color The color value of the string to draw (0xRRGGBBAA). 
+/*!
+\brief Release all cached pattern textures.
 
-\returns Returns true on success, false on failure.
+Textures of a destroyed renderer are dropped from the cache automatically, so
+this is only needed to free the texture memory early.
 */
-bool stringColor(SDL_Renderer * renderer, float x, float y, const char *s, Uint32 color)
+void gfxPrimitivesClearPatternCache(void)
 {
-	Uint8 *c = (Uint8 *)&color; 
-	return stringRGBA(renderer, x, y, s, c[0], c[1], c[2], c[3]);
+	Sint32 i;
+
+	for (i = 0; i < GFX_PATTERN_CACHE_ENTRIES; i++) {
+		if (gfxPrimitivesPatternCache[i].texture != NULL) {
+			SDL_DestroyTexture(gfxPrimitivesPatternCache[i].texture);
+		}
+	}
+	SDL_memset(gfxPrimitivesPatternCache, 0, sizeof(gfxPrimitivesPatternCache));
+	gfxPrimitivesPatternStamp = 0;
 }
 
 /*!
-\brief Draw a string in the currently set font.
+\brief Internal cleanup callback of the renderer property, forgets the entries of a destroyed renderer.
 
-\param renderer The renderer to draw on.
-\param x X (horizontal) coordinate of the upper left corner of the string.
-\param y Y (vertical) coordinate of the upper left corner of the string.
-\param s The string to draw.
-\param r The red value of the string to draw. 
-\param g The green value of the string to draw. 
-\param b The blue value of the string to draw. 
-\param a The alpha value of the string to draw.
+The renderer releases its textures itself, so they are not destroyed here.
+
+\param userdata Unused.
+\param value The renderer being destroyed.
+*/
+static void SDLCALL _gfxPatternRendererDestroyed(void *userdata, void *value)
+{
+	Sint32 i;
+
+	(void)userdata;
+	for (i = 0; i < GFX_PATTERN_CACHE_ENTRIES; i++) {
+		if (gfxPrimitivesPatternCache[i].renderer == (SDL_Renderer *)value) {
+			SDL_memset(&gfxPrimitivesPatternCache[i], 0, sizeof(_gfxPatternCacheEntry));
+		}
+	}
+}
+
+/*!
+\brief Internal lookup (and creation) of the repeating texture of a fill pattern.
+
+\param renderer The renderer the texture is used with.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels.
+
+\returns The pattern texture or NULL on failure.
+*/
+static SDL_Texture *_gfxPatternTexture(SDL_Renderer * renderer, const Uint8 * pattern, Uint32 size)
+{
+	Sint32 i, slot;
+	Uint32 ix, iy, pitch, bytes;
+	const Uint8 *linepos;
+	Uint32 *curpos;
+	SDL_Surface *surface;
+	SDL_Texture *texture;
+	SDL_PropertiesID props;
+	_gfxPatternCacheEntry *entry;
+
+	pitch = (size + 7) / 8;
+	bytes = pitch * size;
+
+	/*
+	* Lookup; remember the least recently used slot 
+	*/
+	slot = 0;
+	for (i = 0; i < GFX_PATTERN_CACHE_ENTRIES; i++) {
+		entry = &gfxPrimitivesPatternCache[i];
+		if ((entry->texture != NULL) && (entry->renderer == renderer) && (entry->size == size) &&
+			(memcmp(entry->bits, pattern, bytes) == 0)) {
+				entry->stamp = ++gfxPrimitivesPatternStamp;
+				return entry->texture;
+		}
+		if (entry->stamp < gfxPrimitivesPatternCache[slot].stamp) {
+			slot = i;
+		}
+	}
+
+	/*
+	* Get notified when the renderer goes away, so no entry outlives it 
+	*/
+	props = SDL_GetRendererProperties(renderer);
+	if (props == 0) {
+		return NULL;
+	}
+	if (!SDL_HasProperty(props, GFX_PATTERN_RENDERER_PROPERTY) &&
+		!SDL_SetPointerPropertyWithCleanup(props, GFX_PATTERN_RENDERER_PROPERTY, renderer, _gfxPatternRendererDestroyed, NULL)) {
+		return NULL;
+	}
+
+	/*
+	* Expand bits (MSB first, like the font data) into white or transparent pixels 
+	*/
+	surface = SDL_CreateSurface(size, size, SDL_PIXELFORMAT_RGBA8888);
+	if (surface == NULL) {
+		return NULL;
+	}
+	for (iy = 0; iy < size; iy++) {
+		linepos = pattern + iy * pitch;
+		curpos = (Uint32 *)((Uint8 *)surface->pixels + iy * surface->pitch);
+		for (ix = 0; ix < size; ix++) {
+			curpos[ix] = (linepos[ix >> 3] & (0x80 >> (ix & 7))) ? 0xffffffff : 0;
+		}
+	}
+	texture = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_DestroySurface(surface);
+	if (texture == NULL) {
+		return NULL;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+
+	/*
+	* Replace least recently used entry 
+	*/
+	entry = &gfxPrimitivesPatternCache[slot];
+	if (entry->texture != NULL) {
+		SDL_DestroyTexture(entry->texture);
+	}
+	entry->renderer = renderer;
+	entry->texture = texture;
+	entry->size = size;
+	entry->stamp = ++gfxPrimitivesPatternStamp;
+	memcpy(entry->bits, pattern, bytes);
+
+	return texture;
+}
+
+/*!
+\brief Internal function to draw pattern-filled geometry.
+
+Texture coordinates are derived from the screen position so that adjacent
+fills line up; coordinates beyond the texture make the renderer repeat it.
+
+\param renderer The renderer to draw on.
+\param v Vertices with positions set; colors and texture coordinates are filled in.
+\param nv Number of vertices.
+\param indices Triangle indices.
+\param ni Number of indices.
+\param pattern The pattern bits.
+\param size The pattern width and height in pixels.
+\param r The red value of the set pattern pixels. 
+\param g The green value of the set pattern pixels. 
+\param b The blue value of the set pattern pixels. 
+\param a The alpha value of the set pattern pixels.
 
 \returns Returns true on success, false on failure.
 */
-bool stringRGBA(SDL_Renderer * renderer, float x, float y, const char *s, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+static bool _gfxPatternGeometry(SDL_Renderer * renderer, SDL_Vertex *v, int nv, const int *indices, int ni, const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-	bool result = true;
-	float curx = x;
-	float cury = y;
-	const char *curchar = s;
+	SDL_Texture *texture;
+	SDL_FColor color;
+	float scale;
+	int i;
 
-	while (*curchar && result) {
-		result &= characterRGBA(renderer, curx, cury, *curchar, r, g, b, a);
-		switch (charRotation)
-		{
-		case 0:
-			curx += charWidthLocal;
-			break;
-		case 2:
-			curx -= charWidthLocal;
-			break;
-		case 1:
-			cury += charHeightLocal;
-			break;
-		case 3:
-			cury -= charHeightLocal;
-			break;
-		}
-		curchar++;
+	texture = _gfxPatternTexture(renderer, pattern, size);
+	if (texture == NULL) {
+		return (false);
 	}
 
-	return (result);
-}
+	color.r = (float)r / 255.0f;
+	color.g = (float)g / 255.0f;
+	color.b = (float)b / 255.0f;
+	color.a = (float)a / 255.0f;
+	scale = 1.0f / (float)size;
+	for (i = 0; i < nv; i++) {
+		v[i].color = color;
+		v[i].tex_coord.x = v[i].position.x * scale;
+		v[i].tex_coord.y = v[i].position.y * scale;
+	}
 
-/* ---- Bezier curve */
+	return SDL_RenderGeometry(renderer, texture, v, nv, indices, ni);
+}
 
 /*!
-\brief Internal function to calculate bezier interpolator of data array with ndata values at position 't'.
+\brief Draw box (filled rectangle) with a repeating bit pattern.
 
-\param data Array of values.
-\param ndata Size of array.
-\param t Position for which to calculate interpolated value. t should be between [0, ndata].
+The pattern is a square bitmap in the same format as the font data: rows of
+(size+7)/8 bytes, most significant bit first. Set bits are drawn in the given
+color, clear bits are left untouched. The pattern is anchored to the screen
+origin, so adjacent fills line up. Power-of-two sizes are recommended since
+some renderers can only repeat those textures. The pattern texture is cached
+per renderer and dropped when the renderer is destroyed.
 
-\returns Interpolated value at position t, value[0] when t<0, value[n-1] when t>n.
+\param renderer The renderer to draw on.
+\param x1 X coordinate of the first point of the box.
+\param y1 Y coordinate of the first point of the box.
+\param x2 X coordinate of the second point of the box.
+\param y2 Y coordinate of the second point of the box.
+\param pattern The pattern bits.
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param r The red value of the set pattern pixels. 
+\param g The green value of the set pattern pixels. 
+\param b The blue value of the set pattern pixels. 
+\param a The alpha value of the set pattern pixels.
+
+\returns Returns true on success, false on failure.
 */
-double _evaluateBezier (double *data, Sint32 ndata, double t)
+bool boxPatternRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2, const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-	double mu, result;
-	Sint32 n,k,kn,nn,nkn;
-	double blend,muk,munk;
+	float tmp;
+	SDL_Vertex v[4];
+	static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
 
-	/* Sanity check bounds */
-	if (t<0.0) {
-		return(data[0]);
-	}
-	if (t>=(double)ndata) {
-		return(data[ndata-1]);
+	if ((renderer == NULL) || (pattern == NULL) || (size < 1) || (size > GFX_PATTERN_MAX_SIZE)) {
+		return (false);
 	}
 
-	/* Adjust t to the range 0.0 to 1.0 */ 
-	mu=t/(double)ndata;
+	/*
+	* Swap x1, x2 if required 
+	*/
+	if (x1 > x2) {
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+	}
 
-	/* Calculate interpolate */
-	n=ndata-1;
-	result=0.0;
-	muk = 1;
-	munk = pow(1-mu,(double)n);
-	for (k=0;k<=n;k++) {
-		nn = n;
-		kn = k;
-		nkn = n - k;
-		blend = muk * munk;
-		muk *= mu;
-		munk /= (1-mu);
-		while (nn >= 1) {
-			blend *= nn;
-			nn--;
-			if (kn > 1) {
-				blend /= (double)kn;
-				kn--;
-			}
-			if (nkn > 1) {
-				blend /= (double)nkn;
-				nkn--;
-			}
-		}
-		result += data[k] * blend;
+	/*
+	* Swap y1, y2 if required 
+	*/
+	if (y1 > y2) {
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
 	}
 
-	return (result);
+	/*
+	* Corners cover the same pixels as boxRGBA 
+	*/
+	v[0].position.x = x1;
+	v[0].position.y = y1;
+	v[1].position.x = x2 + 1;
+	v[1].position.y = y1;
+	v[2].position.x = x2 + 1;
+	v[2].position.y = y2 + 1;
+	v[3].position.x = x1;
+	v[3].position.y = y2 + 1;
+
+	return _gfxPatternGeometry(renderer, v, 4, indices, 6, pattern, size, r, g, b, a);
 }
 
 /*!
-\brief Draw a bezier curve with alpha blending.
+\brief Draw box (filled rectangle) with a repeating bit pattern.
 
 \param renderer The renderer to draw on.
-\param vx Vertex array containing X coordinates of the points of the bezier curve.
-\param vy Vertex array containing Y coordinates of the points of the bezier curve.
-\param n Number of points in the vertex array. Minimum number is 3.
-\param s Number of steps for the interpolation. Minimum number is 2.
-\param color The color value of the bezier curve to draw (0xRRGGBBAA). 
+\param x1 X coordinate of the first point of the box.
+\param y1 Y coordinate of the first point of the box.
+\param x2 X coordinate of the second point of the box.
+\param y2 Y coordinate of the second point of the box.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param color The color value of the set pattern pixels (0xRRGGBBAA). 
 
 \returns Returns true on success, false on failure.
 */
-bool bezierColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, Sint32 s, Uint32 color)
+bool boxPatternColor(SDL_Renderer * renderer, float x1, float y1, float x2, float y2, const Uint8 * pattern, Uint32 size, Uint32 color)
 {
 	Uint8 *c = (Uint8 *)&color; 
-	return bezierRGBA(renderer, vx, vy, n, s, c[0], c[1], c[2], c[3]);
+	return boxPatternRGBA(renderer, x1, y1, x2, y2, pattern, size, c[0], c[1], c[2], c[3]);
 }
 
 /*!
-\brief Draw a bezier curve with alpha blending.
+\brief Draw filled polygon with a repeating bit pattern.
+
+The polygon is triangulated like filledPolygonGradient and should be simple (not self-intersecting).
 
 \param renderer The renderer to draw on.
-\param vx Vertex array containing X coordinates of the points of the bezier curve.
-\param vy Vertex array containing Y coordinates of the points of the bezier curve.
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
 \param n Number of points in the vertex array. Minimum number is 3.
-\param s Number of steps for the interpolation. Minimum number is 2.
-\param r The red value of the bezier curve to draw. 
-\param g The green value of the bezier curve to draw. 
-\param b The blue value of the bezier curve to draw. 
-\param a The alpha value of the bezier curve to draw.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param r The red value of the set pattern pixels. 
+\param g The green value of the set pattern pixels. 
+\param b The blue value of the set pattern pixels. 
+\param a The alpha value of the set pattern pixels.
 
 \returns Returns true on success, false on failure.
 */
-bool bezierRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, Sint32 s, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+bool filledPolygonPatternRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
 	bool result;
 	Sint32 i;
-	double *x, *y, t, stepsize;
-	float x1, y1, x2, y2;
+	int numIndices;
+	SDL_Vertex *v;
+	int *indices;
+	int *remaining;
 
-	/*
-	* Sanity check 
-	*/
-	if (n < 3) {
+	if ((renderer == NULL) || (vx == NULL) || (vy == NULL) || (n < 3) ||
+		(pattern == NULL) || (size < 1) || (size > GFX_PATTERN_MAX_SIZE)) {
 		return (false);
 	}
-	if (s < 2) {
+
+	v = (SDL_Vertex *) malloc(n * sizeof(SDL_Vertex) + (3 * (n - 2) + n) * sizeof(int));
+	if (v == NULL) {
 		return (false);
 	}
+	indices = (int *) (v + n);
+	remaining = indices + 3 * (n - 2);
 
-	/*
-	* Variable setup 
-	*/
-	stepsize=(double)1.0/(double)s;
-
-	/* Transfer vertices into float arrays */
-	if ((x=(double *)malloc(sizeof(double)*(n+1)))==NULL) {
-		return(false);
+	for (i = 0; i < n; i++) {
+		v[i].position.x = vx[i];
+		v[i].position.y = vy[i];
 	}
-	if ((y=(double *)malloc(sizeof(double)*(n+1)))==NULL) {
-		free(x);
-		return(false);
-	}    
-	for (i=0; i<n; i++) {
-		x[i]=(double)vx[i];
-		y[i]=(double)vy[i];
-	}      
-	x[n]=(double)vx[0];
-	y[n]=(double)vy[0];
+	numIndices = _gradientTriangulate(vx, vy, n, indices, remaining);
 
-	/*
-	* Set color 
-	*/
-	result = true;
-	result &= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	result &= SDL_SetRenderDrawColor(renderer, r, g, b, a);
-
-	/*
-	* Draw 
-	*/
-	t=0.0;
-	x1=(Sint32)lrint(_evaluateBezier(x,n+1,t));
-	y1=(Sint32)lrint(_evaluateBezier(y,n+1,t));
-	for (i = 0; i <= (n*s); i++) {
-		t += stepsize;
-		x2=(Sint32)_evaluateBezier(x,n,t);
-		y2=(Sint32)_evaluateBezier(y,n,t);
-		result &= line(renderer, x1, y1, x2, y2);
-		x1 = x2;
-		y1 = y2;
-	}
+	result = _gfxPatternGeometry(renderer, v, n, indices, numIndices, pattern, size, r, g, b, a);
 
-	/* Clean up temporary array */
-	free(x);
-	free(y);
+	free(v);
 
 	return (result);
 }
 
-
 /*!
-\brief Draw a thick line with alpha blending.
+\brief Draw filled polygon with a repeating bit pattern.
 
 \param renderer The renderer to draw on.
-\param x1 X coordinate of the first point of the line.
-\param y1 Y coordinate of the first point of the line.
-\param x2 X coordinate of the second point of the line.
-\param y2 Y coordinate of the second point of the line.
-\param width Width of the line in pixels. Must be >0.
-\param color The color value of the line to draw (0xRRGGBBAA). 
+\param vx Vertex array containing X coordinates of the points of the filled polygon.
+\param vy Vertex array containing Y coordinates of the points of the filled polygon.
+\param n Number of points in the vertex array. Minimum number is 3.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param color The color value of the set pattern pixels (0xRRGGBBAA). 
 
 \returns Returns true on success, false on failure.
 */
-bool thickLineColor(SDL_Renderer *renderer, float x1, float y1, float x2, float y2, float width, Uint32 color)
+bool filledPolygonPatternColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, const Uint8 * pattern, Uint32 size, Uint32 color)
 {
 	Uint8 *c = (Uint8 *)&color; 
-	return thickLineRGBA(renderer, x1, y1, x2, y2, width, c[0], c[1], c[2], c[3]);
+	return filledPolygonPatternRGBA(renderer, vx, vy, n, pattern, size, c[0], c[1], c[2], c[3]);
 }
 
 /*!
-\brief Draw a thick line with alpha blending.
+\brief Draw filled circle with a repeating bit pattern.
 
 \param renderer The renderer to draw on.
-\param x1 X coordinate of the first point of the line.
-\param y1 Y coordinate of the first point of the line.
-\param x2 X coordinate of the second point of the line.
-\param y2 Y coordinate of the second point of the line.
-\param width Width of the line in pixels. Must be >0.
-\param r The red value of the character to draw. 
-\param g The green value of the character to draw. 
-\param b The blue value of the character to draw. 
-\param a The alpha value of the character to draw.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param r The red value of the set pattern pixels. 
+\param g The green value of the set pattern pixels. 
+\param b The blue value of the set pattern pixels. 
+\param a The alpha value of the set pattern pixels.
 
 \returns Returns true on success, false on failure.
 */
-bool thickLineRGBA(SDL_Renderer *renderer, float x1, float y1, float x2, float y2, float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+bool filledCirclePatternRGBA(SDL_Renderer * renderer, float x, float y, float rad, const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-	Sint32 wh;
-	double dx, dy, dx1, dy1, dx2, dy2;
-	double l, wl2, nx, ny, ang, adj;
-	float px[4], py[4];
+	bool result;
+	Sint32 i, segments;
+	double cx, cy, erad;
+	const float *table;
+	SDL_Vertex *v;
+	int *indices;
 
-	if (renderer == NULL) {
-		return false;
+	if ((renderer == NULL) || (rad < 0) || (pattern == NULL) || (size < 1) || (size > GFX_PATTERN_MAX_SIZE)) {
+		return (false);
 	}
 
-	if (width < 1) {
-		return false;
+	/*
+	* Segment count follows the tessellation tolerance, or a quarter pixel if none is set 
+	*/
+	segments = _gfxTessellationSegments(rad, (gfxPrimitivesTessellationTolerance > 0.0f) ? gfxPrimitivesTessellationTolerance : 0.25);
+	table = _gfxTessellationTable(segments);
+	if (table == NULL) {
+		return (false);
 	}
 
-	/* Special case: thick "point" */
-	if ((x1 == x2) && (y1 == y2)) {
-		wh = width / 2;
-		return boxRGBA(renderer, x1 - wh, y1 - wh, x2 + width, y2 + width, r, g, b, a);		
+	v = (SDL_Vertex *) malloc((segments + 1) * sizeof(SDL_Vertex) + 3 * segments * sizeof(int));
+	if (v == NULL) {
+		return (false);
 	}
+	indices = (int *) (v + segments + 1);
 
-	/* Special case: width == 1 */
-	if (width == 1) {
-		return lineRGBA(renderer, x1, y1, x2, y2, r, g, b, a);		
+	/*
+	* Fan around the pixel center, half a pixel larger to cover the same pixels as filledCircleRGBA 
+	*/
+	cx = (double)x + 0.5;
+	cy = (double)y + 0.5;
+	erad = (double)rad + 0.5;
+	v[0].position.x = (float)cx;
+	v[0].position.y = (float)cy;
+	for (i = 0; i < segments; i++) {
+		v[i + 1].position.x = (float)(cx + erad * table[i]);
+		v[i + 1].position.y = (float)(cy + erad * table[segments + i]);
+		indices[3 * i] = 0;
+		indices[3 * i + 1] = i + 1;
+		indices[3 * i + 2] = (i + 1) % segments + 1;
 	}
 
-	/* Calculate offsets for sides */
-	dx = (double)(x2 - x1);
-	dy = (double)(y2 - y1);
-	l = SDL_sqrt(dx*dx + dy*dy);
-	ang = SDL_atan2(dx, dy);
-	adj = 0.1 + 0.9 * SDL_fabs(SDL_cos(2.0 * ang));
-	wl2 = ((double)width - adj)/(2.0 * l);
-	nx = dx * wl2;
-	ny = dy * wl2;
+	result = _gfxPatternGeometry(renderer, v, segments + 1, indices, 3 * segments, pattern, size, r, g, b, a);
 
-	/* Build polygon */
-	dx1 = (double)x1;
-	dy1 = (double)y1;
-	dx2 = (double)x2;
-	dy2 = (double)y2;
-	px[0] = (float)(dx1 + ny);
-	px[1] = (float)(dx1 - ny);
-	px[2] = (float)(dx2 - ny);
-	px[3] = (float)(dx2 + ny);
-	py[0] = (float)(dy1 - nx);
-	py[1] = (float)(dy1 + nx);
-	py[2] = (float)(dy2 + nx);
-	py[3] = (float)(dy2 - nx);
+	free(v);
 
-	/* Draw polygon */
-	return filledPolygonRGBA(renderer, px, py, 4, r, g, b, a);
+	return (result);
+}
+
+/*!
+\brief Draw filled circle with a repeating bit pattern.
+
+\param renderer The renderer to draw on.
+\param x X coordinate of the center of the filled circle.
+\param y Y coordinate of the center of the filled circle.
+\param rad Radius in pixels of the filled circle.
+\param pattern The pattern bits (see boxPatternRGBA).
+\param size The pattern width and height in pixels (1 to 64, e.g. 8).
+\param color The color value of the set pattern pixels (0xRRGGBBAA). 
+
+\returns Returns true on success, false on failure.
+*/
+bool filledCirclePatternColor(SDL_Renderer * renderer, float x, float y, float rad, const Uint8 * pattern, Uint32 size, Uint32 color)
+{
+	Uint8 *c = (Uint8 *)&color; 
+	return filledCirclePatternRGBA(renderer, x, y, rad, pattern, size, c[0], c[1], c[2], c[3]);
 }
@@ -123,6 +123,21 @@ extern "C" {
 	SDL3_GFXPRIMITIVES_SCOPE bool thickLineRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
 		float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+	/* AA Thick Line */
+	SDL3_GFXPRIMITIVES_SCOPE bool aaThickLineColor(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
+		float width, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool aaThickLineRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
+		float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	SDL3_GFXPRIMITIVES_SCOPE bool aaThickPolylineColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		float width, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool aaThickPolylineRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		float width, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+	/* Tessellation of curved primitives */
+
+	SDL3_GFXPRIMITIVES_SCOPE void gfxPrimitivesSetTessellationTolerance(float tolerance);
+	SDL3_GFXPRIMITIVES_SCOPE float gfxPrimitivesGetTessellationTolerance(void);
+
 	/* Circle */
 
 	SDL3_GFXPRIMITIVES_SCOPE bool circleColor(SDL_Renderer * renderer, float x, float y, float rad, Uint32 color);
@@ -214,6 +229,16 @@ extern "C" {
 	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonRGBA(SDL_Renderer * renderer, const float * vx,
 		const float * vy, Sint32 n, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+	/* Cached Filled Polygon */
+
+	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonCachedColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		float dx, float dy, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonCachedRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		float dx, float dy, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	SDL3_GFXPRIMITIVES_SCOPE void gfxPrimitivesSetPolygonCacheSize(size_t size);
+	SDL3_GFXPRIMITIVES_SCOPE void gfxPrimitivesClearPolygonCache(void);
+	SDL3_GFXPRIMITIVES_SCOPE bool gfxPrimitivesInvalidatePolygonCache(const float * vx, const float * vy, Sint32 n);
+
 	/* Textured Polygon */
 
 	SDL3_GFXPRIMITIVES_SCOPE bool texturedPolygon(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n, SDL_Surface * texture,Sint32 texture_dx,Sint32 texture_dy);
@@ -224,6 +249,31 @@ extern "C" {
 	SDL3_GFXPRIMITIVES_SCOPE bool bezierRGBA(SDL_Renderer * renderer, const float * vx, const float * vy,
 		Sint32 n, Sint32 s, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+	/* Gradient fills */
+
+	SDL3_GFXPRIMITIVES_SCOPE bool boxGradient(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
+		Uint32 c1, Uint32 c2, Uint32 c3, Uint32 c4);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonGradient(SDL_Renderer * renderer, const float * vx, const float * vy,
+		const Uint32 * colors, Sint32 n);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledCircleRadialGradient(SDL_Renderer * renderer, float x, float y, float rad,
+		Uint32 inner, Uint32 outer);
+
+	/* Pattern fills */
+
+	SDL3_GFXPRIMITIVES_SCOPE bool boxPatternColor(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
+		const Uint8 * pattern, Uint32 size, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool boxPatternRGBA(SDL_Renderer * renderer, float x1, float y1, float x2, float y2,
+		const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonPatternColor(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		const Uint8 * pattern, Uint32 size, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledPolygonPatternRGBA(SDL_Renderer * renderer, const float * vx, const float * vy, Sint32 n,
+		const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledCirclePatternColor(SDL_Renderer * renderer, float x, float y, float rad,
+		const Uint8 * pattern, Uint32 size, Uint32 color);
+	SDL3_GFXPRIMITIVES_SCOPE bool filledCirclePatternRGBA(SDL_Renderer * renderer, float x, float y, float rad,
+		const Uint8 * pattern, Uint32 size, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	SDL3_GFXPRIMITIVES_SCOPE void gfxPrimitivesClearPatternCache(void);
+
 	/* Characters/Strings */
 
 	SDL3_GFXPRIMITIVES_SCOPE void gfxPrimitivesSetFont(const void *fontdata, Uint32 cw, Uint32 ch);
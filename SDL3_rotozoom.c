@@ -58,6 +58,11 @@ to a situation where the program can segfault.
 */
 #define VALUE_LIMIT	0.001
 
+/*!
+\brief Number of ints in the row/column tables of the zoomers for a w x h destination.
+*/
+#define ZOOM_TABLE_INTS(w, h)	((w) + 1 + 2 * ((h) + 1) + 3 * (w))
+
 /*!
 \brief Returns colorkey info for a surface
 */
@@ -68,1397 +73,6773 @@ Uint32 _colorkey(SDL_Surface *src)
 	return key;
 }
 
+/* ---- Bilinear kernels */
 
-/*! 
-\brief Internal 32 bit integer-factor averaging Shrinker.
-
-Shrinks 32 bit RGBA/ABGR 'src' surface to 'dst' surface.
-Averages color and alpha values values of src pixels to calculate dst pixels.
-Assumes src and dst surfaces are of 32 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+/*!
+\brief Flag indicating if SIMD kernels may be used (default on).
+*/
+static int rotozoomSIMDEnabled = 1;
 
-\param src The surface to shrink (input).
-\param dst The shrunken surface (output).
-\param factorx The horizontal shrinking ratio.
-\param factory The vertical shrinking ratio.
+/*!
+\brief Row kernel of the smooth (bilinear) zoomer.
 
-\return 0 for success or -1 for error.
+Interpolates one destination row from the source rows r0 and r1 using the
+precomputed column offsets (ox0, ox1) and horizontal weights (fx) and the
+vertical weight fy. All weights are 16bit fractions.
 */
-int _shrinkSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
-{
-	int x, y, dx, dy, dgap, ra, ga, ba, aa;
-	int n_average;
-	SDL_Color *sp, *osp, *oosp;
-	SDL_Color *dp;
+typedef void (*_zoomRowRGBAFunc)(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w);
 
-	/*
-	* Averaging integer shrink
-	*/
+/*!
+\brief Span kernel of the smooth (bilinear) rotozoomer.
 
-	/* Precalculate division factor */
-	n_average = factorx*factory;
+Interpolates w destination pixels, starting at the 16.16 source position
+(sdx, sdy) and stepping by (icos, isin) per pixel. All source footprints must
+be inside the source surface. Mirroring is folded into the tap offsets: the
+top left tap of source position (x, y) is sp[base + y * rowstep + x * colstep],
+its right and bottom neighbours are colstep and rowstep pixels away.
+*/
+typedef void (*_transformRowRGBAFunc)(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin);
 
-	/*
-	* Scan destination
-	*/
-	sp = (SDL_Color *) src->pixels;
-	
-	dp = (SDL_Color *) dst->pixels;
-	dgap = dst->pitch - dst->w * 4;
+/*!
+\brief Internal bilinear interpolation of one 32bit pixel.
 
-	for (y = 0; y < dst->h; y++) {
+This is the reference implementation; every channel is interpolated
+first horizontally, then vertically, with truncating 16.16 fixed point math.
+All SIMD kernels produce bit-identical results.
 
-		osp=sp;
-		for (x = 0; x < dst->w; x++) {
+\param c00 Top left source pixel.
+\param c01 Top right source pixel.
+\param c10 Bottom left source pixel.
+\param c11 Bottom right source pixel.
+\param ex Horizontal weight (16bit fraction).
+\param ey Vertical weight (16bit fraction).
 
-			/* Trace out source box and accumulate */
-			oosp=sp;
-			ra=ga=ba=aa=0;
-			for (dy=0; dy < factory; dy++) {
-				for (dx=0; dx < factorx; dx++) {
-					ra += sp->r;
-					ga += sp->g;
-					ba += sp->b;
-					aa += sp->a;
-
-					sp++;
-				} 
-				/* src dx loop */
-				sp = (SDL_Color *)((Uint8*)sp + (src->pitch - 4*factorx)); // next y
-			}
-			/* src dy loop */
+\return The interpolated pixel.
+*/
+static Uint32 _interpolateRGBA(Uint32 c00, Uint32 c01, Uint32 c10, Uint32 c11, int ex, int ey)
+{
+	Uint32 result;
+	int shift, p00, p01, p10, p11, t1, t2;
+
+	result = 0;
+	for (shift = 0; shift < 32; shift += 8) {
+		p00 = (c00 >> shift) & 0xff;
+		p01 = (c01 >> shift) & 0xff;
+		p10 = (c10 >> shift) & 0xff;
+		p11 = (c11 >> shift) & 0xff;
+		t1 = ((((p01 - p00) * ex) >> 16) + p00) & 0xff;
+		t2 = ((((p11 - p10) * ex) >> 16) + p10) & 0xff;
+		result |= (Uint32)(((((t2 - t1) * ey) >> 16) + t1) & 0xff) << shift;
+	}
+	return result;
+}
 
-			/* next box-x */
-			sp = (SDL_Color *)((Uint8*)oosp + 4*factorx);
+/*!
+\brief Scalar (reference) row kernel of the smooth zoomer.
+*/
+static void _zoomRowRGBA_C(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w)
+{
+	int x;
 
-			/* Store result in destination */
-			dp->r = ra/n_average;
-			dp->g = ga/n_average;
-			dp->b = ba/n_average;
-			dp->a = aa/n_average;
+	for (x = 0; x < w; x++) {
+		d[x] = _interpolateRGBA(r0[ox0[x]], r0[ox1[x]], r1[ox0[x]], r1[ox1[x]], fx[x], fy);
+	}
+}
 
-			/*
-			* Advance destination pointer 
-			*/
-			dp++;
-		} 
-		/* dst x loop */
+/*!
+\brief Scalar (reference) span kernel of the smooth rotozoomer.
+*/
+static void _transformRowRGBA_C(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin)
+{
+	int x, o;
 
-		/* next box-y */
-		sp = (SDL_Color *)((Uint8*)osp + src->pitch*factory);
+	for (x = 0; x < w; x++) {
+		o = base + (sdy >> 16) * rowstep + (sdx >> 16) * colstep;
+		d[x] = _interpolateRGBA(sp[o], sp[o + colstep], sp[o + rowstep], sp[o + rowstep + colstep], sdx & 0xffff, sdy & 0xffff);
+		sdx = (int) ((Uint32) sdx + (Uint32) icos);
+		sdy = (int) ((Uint32) sdy + (Uint32) isin);
+	}
+}
 
-		/*
-		* Advance destination pointers 
-		*/
-		dp = (SDL_Color *) ((Uint8 *) dp + dgap);
-	} 
-	/* dst y loop */
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 multiply of signed 16bit values by 16bit fractions, rounding towards negative infinity.
 
-	return (0);
+_mm_mulhi_epi16 treats weights >= 0x8000 as negative (w - 0x10000); adding
+the value back for those lanes gives the exact (v * w) >> 16 of the scalar code.
+*/
+static __m128i _mulFix_SSE2(__m128i v, __m128i w)
+{
+	return _mm_add_epi16(_mm_mulhi_epi16(v, w), _mm_and_si128(v, _mm_srai_epi16(w, 15)));
 }
 
-/*! 
-\brief Internal 8 bit integer-factor averaging shrinker.
+/*!
+\brief SSE2 bilinear interpolation of two pixels widened to 16bit lanes.
+*/
+static __m128i _interpolate2_SSE2(__m128i c00, __m128i c01, __m128i c10, __m128i c11, __m128i ex, __m128i ey)
+{
+	__m128i t1, t2;
 
-Shrinks 8bit Y 'src' surface to 'dst' surface.
-Averages color (brightness) values values of src pixels to calculate dst pixels.
-Assumes src and dst surfaces are of 8 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+	t1 = _mm_add_epi16(c00, _mulFix_SSE2(_mm_sub_epi16(c01, c00), ex));
+	t2 = _mm_add_epi16(c10, _mulFix_SSE2(_mm_sub_epi16(c11, c10), ex));
+	return _mm_add_epi16(t1, _mulFix_SSE2(_mm_sub_epi16(t2, t1), ey));
+}
 
-\param src The surface to shrink (input).
-\param dst The shrunken surface (output).
-\param factorx The horizontal shrinking ratio.
-\param factory The vertical shrinking ratio.
+/*!
+\brief SSE2 bilinear interpolation of four pixels with per-pixel weights.
 
-\return 0 for success or -1 for error.
+\param c00 Top left source pixels.
+\param c01 Top right source pixels.
+\param c10 Bottom left source pixels.
+\param c11 Bottom right source pixels.
+\param ex Horizontal weights, one 32bit lane per pixel.
+\param ey Vertical weights, one 32bit lane per pixel.
+
+\return The four interpolated pixels.
 */
-int _shrinkSurfaceY(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+static __m128i _interpolate4_SSE2(__m128i c00, __m128i c01, __m128i c10, __m128i c11, __m128i ex, __m128i ey)
 {
-	int x, y, dx, dy, dgap, a;
-	int n_average;
-	Uint8 *sp, *osp, *oosp;
-	Uint8 *dp;
+	__m128i zero, lo, hi;
 
-	/*
-	* Averaging integer shrink
-	*/
+	zero = _mm_setzero_si128();
 
-	/* Precalculate division factor */
-	n_average = factorx*factory;
+	/* Replicate each weight into the four 16bit lanes of its pixel */
+	ex = _mm_or_si128(ex, _mm_slli_epi32(ex, 16));
+	ey = _mm_or_si128(ey, _mm_slli_epi32(ey, 16));
 
-	/*
-	* Scan destination
-	*/
-	sp = (Uint8 *) src->pixels;
+	lo = _interpolate2_SSE2(_mm_unpacklo_epi8(c00, zero), _mm_unpacklo_epi8(c01, zero),
+		_mm_unpacklo_epi8(c10, zero), _mm_unpacklo_epi8(c11, zero),
+		_mm_unpacklo_epi32(ex, ex), _mm_unpacklo_epi32(ey, ey));
+	hi = _interpolate2_SSE2(_mm_unpackhi_epi8(c00, zero), _mm_unpackhi_epi8(c01, zero),
+		_mm_unpackhi_epi8(c10, zero), _mm_unpackhi_epi8(c11, zero),
+		_mm_unpackhi_epi32(ex, ex), _mm_unpackhi_epi32(ey, ey));
+	return _mm_packus_epi16(lo, hi);
+}
 
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+/*!
+\brief SSE2 row kernel of the smooth zoomer (four pixels per step).
+*/
+static void _zoomRowRGBA_SSE2(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w)
+{
+	int x;
+	__m128i ey;
+
+	ey = _mm_set1_epi32(fy);
+	for (x = 0; x + 4 <= w; x += 4) {
+		_mm_storeu_si128((__m128i *)(d + x), _interpolate4_SSE2(
+			_mm_setr_epi32((int)r0[ox0[x]], (int)r0[ox0[x + 1]], (int)r0[ox0[x + 2]], (int)r0[ox0[x + 3]]),
+			_mm_setr_epi32((int)r0[ox1[x]], (int)r0[ox1[x + 1]], (int)r0[ox1[x + 2]], (int)r0[ox1[x + 3]]),
+			_mm_setr_epi32((int)r1[ox0[x]], (int)r1[ox0[x + 1]], (int)r1[ox0[x + 2]], (int)r1[ox0[x + 3]]),
+			_mm_setr_epi32((int)r1[ox1[x]], (int)r1[ox1[x + 1]], (int)r1[ox1[x + 2]], (int)r1[ox1[x + 3]]),
+			_mm_loadu_si128((const __m128i *)(fx + x)), ey));
+	}
+	_zoomRowRGBA_C(r0, r1, d + x, ox0 + x, ox1 + x, fx + x, fy, w - x);
+}
 
-	for (y = 0; y < dst->h; y++) {    
+/*!
+\brief SSE2 span kernel of the smooth rotozoomer (four pixels per step).
+*/
+static void _transformRowRGBA_SSE2(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin)
+{
+	int x, k, o;
+	SDL_ALIGNED(16) Uint32 c00[4], c01[4], c10[4], c11[4];
+	SDL_ALIGNED(16) int ex[4], ey[4];
+
+	for (x = 0; x + 4 <= w; x += 4) {
+		for (k = 0; k < 4; k++) {
+			o = base + (sdy >> 16) * rowstep + (sdx >> 16) * colstep;
+			c00[k] = sp[o];
+			c01[k] = sp[o + colstep];
+			c10[k] = sp[o + rowstep];
+			c11[k] = sp[o + rowstep + colstep];
+			ex[k] = sdx & 0xffff;
+			ey[k] = sdy & 0xffff;
+			sdx = (int) ((Uint32) sdx + (Uint32) icos);
+			sdy = (int) ((Uint32) sdy + (Uint32) isin);
+		}
+		_mm_storeu_si128((__m128i *)(d + x), _interpolate4_SSE2(
+			_mm_load_si128((const __m128i *)c00), _mm_load_si128((const __m128i *)c01),
+			_mm_load_si128((const __m128i *)c10), _mm_load_si128((const __m128i *)c11),
+			_mm_load_si128((const __m128i *)ex), _mm_load_si128((const __m128i *)ey)));
+	}
+	_transformRowRGBA_C(sp, base, colstep, rowstep, d + x, w - x, sdx, sdy, icos, isin);
+}
+#endif /* SDL_SSE2_INTRINSICS */
 
-		osp=sp;
-		for (x = 0; x < dst->w; x++) {
+#ifdef SDL_AVX2_INTRINSICS
+/*!
+\brief AVX2 multiply of signed 16bit values by 16bit fractions (see _mulFix_SSE2).
+*/
+static __m256i SDL_TARGETING("avx2") _mulFix_AVX2(__m256i v, __m256i w)
+{
+	return _mm256_add_epi16(_mm256_mulhi_epi16(v, w), _mm256_and_si256(v, _mm256_srai_epi16(w, 15)));
+}
 
-			/* Trace out source box and accumulate */
-			oosp=sp;
-			a=0;
-			for (dy=0; dy < factory; dy++) {
-				for (dx=0; dx < factorx; dx++) {
-					a += (*sp);
-					/* next x */           
-					sp++;
-				} 
-				/* end src dx loop */         
-				/* next y */
-				sp = (Uint8 *)((Uint8*)sp + (src->pitch - factorx)); 
-			} 
-			/* end src dy loop */
-
-			/* next box-x */
-			sp = (Uint8 *)((Uint8*)oosp + factorx);
+/*!
+\brief AVX2 bilinear interpolation of eight pixels with per-pixel weights.
 
-			/* Store result in destination */
-			*dp = a/n_average;
+\param c00 Top left source pixels.
+\param c01 Top right source pixels.
+\param c10 Bottom left source pixels.
+\param c11 Bottom right source pixels.
+\param ex Horizontal weights, one 32bit lane per pixel.
+\param ey Vertical weights, one 32bit lane per pixel.
 
-			/*
-			* Advance destination pointer 
-			*/
-			dp++;
-		} 
-		/* end dst x loop */
+\return The eight interpolated pixels.
+*/
+static __m256i SDL_TARGETING("avx2") _interpolate8_AVX2(__m256i c00, __m256i c01, __m256i c10, __m256i c11, __m256i ex, __m256i ey)
+{
+	__m256i zero, lo, hi, exl, eyl, t1, t2, a, b, c, e;
+
+	zero = _mm256_setzero_si256();
+	ex = _mm256_or_si256(ex, _mm256_slli_epi32(ex, 16));
+	ey = _mm256_or_si256(ey, _mm256_slli_epi32(ey, 16));
+
+	/* Pixels 0,1 and 4,5 (the unpacks work within 128bit lanes) */
+	exl = _mm256_unpacklo_epi32(ex, ex);
+	eyl = _mm256_unpacklo_epi32(ey, ey);
+	a = _mm256_unpacklo_epi8(c00, zero);
+	b = _mm256_unpacklo_epi8(c01, zero);
+	c = _mm256_unpacklo_epi8(c10, zero);
+	e = _mm256_unpacklo_epi8(c11, zero);
+	t1 = _mm256_add_epi16(a, _mulFix_AVX2(_mm256_sub_epi16(b, a), exl));
+	t2 = _mm256_add_epi16(c, _mulFix_AVX2(_mm256_sub_epi16(e, c), exl));
+	lo = _mm256_add_epi16(t1, _mulFix_AVX2(_mm256_sub_epi16(t2, t1), eyl));
+
+	/* Pixels 2,3 and 6,7 */
+	exl = _mm256_unpackhi_epi32(ex, ex);
+	eyl = _mm256_unpackhi_epi32(ey, ey);
+	a = _mm256_unpackhi_epi8(c00, zero);
+	b = _mm256_unpackhi_epi8(c01, zero);
+	c = _mm256_unpackhi_epi8(c10, zero);
+	e = _mm256_unpackhi_epi8(c11, zero);
+	t1 = _mm256_add_epi16(a, _mulFix_AVX2(_mm256_sub_epi16(b, a), exl));
+	t2 = _mm256_add_epi16(c, _mulFix_AVX2(_mm256_sub_epi16(e, c), exl));
+	hi = _mm256_add_epi16(t1, _mulFix_AVX2(_mm256_sub_epi16(t2, t1), eyl));
+
+	return _mm256_packus_epi16(lo, hi);
+}
 
-		/* next box-y */
-		sp = (Uint8 *)((Uint8*)osp + src->pitch*factory);
+/*!
+\brief AVX2 row kernel of the smooth zoomer (eight pixels per step, gathered taps).
+*/
+static void SDL_TARGETING("avx2") _zoomRowRGBA_AVX2(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w)
+{
+	int x;
+	__m256i ey, i0, i1;
+
+	ey = _mm256_set1_epi32(fy);
+	for (x = 0; x + 8 <= w; x += 8) {
+		i0 = _mm256_loadu_si256((const __m256i *)(ox0 + x));
+		i1 = _mm256_loadu_si256((const __m256i *)(ox1 + x));
+		_mm256_storeu_si256((__m256i *)(d + x), _interpolate8_AVX2(
+			_mm256_i32gather_epi32((const int *)r0, i0, 4),
+			_mm256_i32gather_epi32((const int *)r0, i1, 4),
+			_mm256_i32gather_epi32((const int *)r1, i0, 4),
+			_mm256_i32gather_epi32((const int *)r1, i1, 4),
+			_mm256_loadu_si256((const __m256i *)(fx + x)), ey));
+	}
+	_zoomRowRGBA_C(r0, r1, d + x, ox0 + x, ox1 + x, fx + x, fy, w - x);
+}
 
-		/*
-		* Advance destination pointers 
-		*/
-		dp = (Uint8 *)((Uint8 *)dp + dgap);
-	} 
-	/* end dst y loop */
+/*!
+\brief AVX2 span kernel of the smooth rotozoomer (eight pixels per step).
 
-	return (0);
+Source positions and tap offsets are computed in vector registers and the
+taps are fetched with gathers.
+*/
+static void SDL_TARGETING("avx2") _transformRowRGBA_AVX2(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin)
+{
+	int x;
+	__m256i step, vsdx, vsdy, off, vcol, vrow, vbase, low16, dsdx, dsdy;
+
+	step = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	vsdx = _mm256_add_epi32(_mm256_set1_epi32(sdx), _mm256_mullo_epi32(step, _mm256_set1_epi32(icos)));
+	vsdy = _mm256_add_epi32(_mm256_set1_epi32(sdy), _mm256_mullo_epi32(step, _mm256_set1_epi32(isin)));
+	dsdx = _mm256_slli_epi32(_mm256_set1_epi32(icos), 3);
+	dsdy = _mm256_slli_epi32(_mm256_set1_epi32(isin), 3);
+	vcol = _mm256_set1_epi32(colstep);
+	vrow = _mm256_set1_epi32(rowstep);
+	vbase = _mm256_set1_epi32(base);
+	low16 = _mm256_set1_epi32(0xffff);
+
+	for (x = 0; x + 8 <= w; x += 8) {
+		off = _mm256_add_epi32(vbase, _mm256_add_epi32(
+			_mm256_mullo_epi32(_mm256_srai_epi32(vsdy, 16), vrow),
+			_mm256_mullo_epi32(_mm256_srai_epi32(vsdx, 16), vcol)));
+		_mm256_storeu_si256((__m256i *)(d + x), _interpolate8_AVX2(
+			_mm256_i32gather_epi32((const int *)sp, off, 4),
+			_mm256_i32gather_epi32((const int *)sp, _mm256_add_epi32(off, vcol), 4),
+			_mm256_i32gather_epi32((const int *)sp, _mm256_add_epi32(off, vrow), 4),
+			_mm256_i32gather_epi32((const int *)sp, _mm256_add_epi32(off, _mm256_add_epi32(vrow, vcol)), 4),
+			_mm256_and_si256(vsdx, low16), _mm256_and_si256(vsdy, low16)));
+		vsdx = _mm256_add_epi32(vsdx, dsdx);
+		vsdy = _mm256_add_epi32(vsdy, dsdy);
+	}
+	_transformRowRGBA_C(sp, base, colstep, rowstep, d + x, w - x,
+		(int)((Uint32)sdx + (Uint32)x * (Uint32)icos), (int)((Uint32)sdy + (Uint32)x * (Uint32)isin), icos, isin);
 }
+#endif /* SDL_AVX2_INTRINSICS */
 
-/*! 
-\brief Internal 32 bit Zoomer with optional anti-aliasing by bilinear interpolation.
-
-Zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface.
-Assumes src and dst surfaces are of 32 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+#ifdef SDL_NEON_INTRINSICS
+/*!
+\brief NEON bilinear interpolation of one 32bit pixel (see _interpolateRGBA).
 
-\param src The surface to zoom (input).
-\param dst The zoomed surface (output).
-\param flipx Flag indicating if the image should be horizontally flipped.
-\param flipy Flag indicating if the image should be vertically flipped.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+Channels are widened to 32bit lanes so the multiply and arithmetic shift
+match the scalar fixed point math exactly.
+*/
+static Uint32 _interpolateRGBA_NEON(Uint32 c00, Uint32 c01, Uint32 c10, Uint32 c11, int ex, int ey)
+{
+	int32x4_t p00, p01, p10, p11, t1, t2, r;
+	uint16x8_t top, bottom;
+	uint8x8_t packed;
+
+	top = vmovl_u8(vcreate_u8(((Uint64)c01 << 32) | c00));
+	bottom = vmovl_u8(vcreate_u8(((Uint64)c11 << 32) | c10));
+	p00 = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(top)));
+	p01 = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(top)));
+	p10 = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(bottom)));
+	p11 = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(bottom)));
+	t1 = vaddq_s32(p00, vshrq_n_s32(vmulq_n_s32(vsubq_s32(p01, p00), ex), 16));
+	t2 = vaddq_s32(p10, vshrq_n_s32(vmulq_n_s32(vsubq_s32(p11, p10), ex), 16));
+	r = vaddq_s32(t1, vshrq_n_s32(vmulq_n_s32(vsubq_s32(t2, t1), ey), 16));
+	packed = vmovn_u16(vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(r)), vdup_n_u16(0)));
+	return vget_lane_u32(vreinterpret_u32_u8(packed), 0);
+}
 
-\return 0 for success or -1 for error.
+/*!
+\brief NEON row kernel of the smooth zoomer.
 */
-int _zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
+static void _zoomRowRGBA_NEON(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w)
 {
-	int x, y, sx, sy, ssx, ssy, *sax, *say, *csax, *csay, *salast, csx, csy, ex, ey, cx, cy, sstep, sstepx, sstepy;
-	SDL_Color *c00, *c01, *c10, *c11;
-	SDL_Color *sp, *csp, *dp;
-	int spixelgap, spixelw, spixelh, dgap, t1, t2;
+	int x;
 
-	/*
-	* Allocate memory for row/column increments 
-	*/
-	if ((sax = (int *) malloc((dst->w + 1) * sizeof(Uint32))) == NULL) {
-		return (-1);
-	}
-	if ((say = (int *) malloc((dst->h + 1) * sizeof(Uint32))) == NULL) {
-		free(sax);
-		return (-1);
+	for (x = 0; x < w; x++) {
+		d[x] = _interpolateRGBA_NEON(r0[ox0[x]], r0[ox1[x]], r1[ox0[x]], r1[ox1[x]], fx[x], fy);
 	}
+}
 
-	/*
-	* Precalculate row increments 
-	*/
-	spixelw = (src->w - 1);
-	spixelh = (src->h - 1);
-	if (smooth) {
-		sx = (int) (65536.0 * (float) spixelw / (float) (dst->w - 1));
-		sy = (int) (65536.0 * (float) spixelh / (float) (dst->h - 1));
-	} else {
-		sx = (int) (65536.0 * (float) (src->w) / (float) (dst->w));
-		sy = (int) (65536.0 * (float) (src->h) / (float) (dst->h));
+/*!
+\brief NEON span kernel of the smooth rotozoomer.
+*/
+static void _transformRowRGBA_NEON(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin)
+{
+	int x, o;
+
+	for (x = 0; x < w; x++) {
+		o = base + (sdy >> 16) * rowstep + (sdx >> 16) * colstep;
+		d[x] = _interpolateRGBA_NEON(sp[o], sp[o + colstep], sp[o + rowstep], sp[o + rowstep + colstep], sdx & 0xffff, sdy & 0xffff);
+		sdx = (int) ((Uint32) sdx + (Uint32) icos);
+		sdy = (int) ((Uint32) sdy + (Uint32) isin);
 	}
+}
+#endif /* SDL_NEON_INTRINSICS */
 
-	/* Maximum scaled source size */
-	ssx = (src->w << 16) - 1;
-	ssy = (src->h << 16) - 1;
+/*!
+\brief Enable or disable the SIMD (SSE2/AVX2/NEON) kernels of the zoomer and rotozoomer.
 
-	/* Precalculate horizontal row increments */
-	csx = 0;
-	csax = sax;
-	for (x = 0; x <= dst->w; x++) {
-		*csax = csx;
-		csax++;
-		csx += sx;
+The kernels are selected at runtime based on the CPU features. They produce
+results identical to the scalar reference code, which is used when SIMD is
+disabled or not available.
 
-		/* Guard from overflows */
-		if (csx > ssx) { 
-			csx = ssx; 
+\param enable Set to 1 to use SIMD kernels when available (default), 0 to force the scalar code.
+*/
+void rotozoomSetSIMD(int enable)
+{
+	rotozoomSIMDEnabled = enable;
+}
+
+/*!
+\brief Internal selection of the smooth zoomer row kernel for the current CPU.
+*/
+static _zoomRowRGBAFunc _zoomRowRGBAKernel(void)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_AVX2_INTRINSICS
+		if (SDL_HasAVX2()) {
+			return _zoomRowRGBA_AVX2;
+		}
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return _zoomRowRGBA_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return _zoomRowRGBA_NEON;
 		}
+#endif
 	}
+	return _zoomRowRGBA_C;
+}
 
-	/* Precalculate vertical row increments */
-	csy = 0;
-	csay = say;
-	for (y = 0; y <= dst->h; y++) {
-		*csay = csy;
-		csay++;
-		csy += sy;
-
-		/* Guard from overflows */
-		if (csy > ssy) {
-			csy = ssy;
+/*!
+\brief Internal selection of the smooth rotozoomer row kernel for the current CPU.
+*/
+static _transformRowRGBAFunc _transformRowRGBAKernel(void)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_AVX2_INTRINSICS
+		if (SDL_HasAVX2()) {
+			return _transformRowRGBA_AVX2;
+		}
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return _transformRowRGBA_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return _transformRowRGBA_NEON;
 		}
+#endif
 	}
+	return _transformRowRGBA_C;
+}
 
-	sp = (SDL_Color *) src->pixels;
-	dp = (SDL_Color *) dst->pixels;
-	dgap = dst->pitch - dst->w * 4;
-	spixelgap = src->pitch/4;
+/* ---- Premultiplied bilinear kernels */
 
-	if (flipx) sp += spixelw;
-	if (flipy) sp += (spixelgap * spixelh);
+/*!
+\brief Row kernel of the smooth zoomer interpolating in premultiplied alpha space.
 
-	/*
-	* Switch between interpolating and non-interpolating code 
-	*/
-	if (smooth) {
+Same as _zoomRowRGBAFunc; ashift is the bit position of the alpha channel.
+*/
+typedef void (*_zoomRowRGBAPremulFunc)(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w, int ashift);
 
-		/*
-		* Interpolating Zoom 
-		*/
-		csay = say;
-		for (y = 0; y < dst->h; y++) {
-			csp = sp;
-			csax = sax;
-			for (x = 0; x < dst->w; x++) {
-				/*
-				* Setup color source pointers 
-				*/
-				ex = (*csax & 0xffff);
-				ey = (*csay & 0xffff);
-				cx = (*csax >> 16);
-				cy = (*csay >> 16);
-				sstepx = cx < spixelw;
-				sstepy = cy < spixelh;
-				c00 = sp;
-				c01 = sp;
-				c10 = sp;
-				if (sstepy) {
-					if (flipy) {
-						c10 -= spixelgap;
-					} else {
-						c10 += spixelgap;
-					}
-				}
-				c11 = c10;
-				if (sstepx) {
-					if (flipx) {
-						c01--;
-						c11--;
-					} else {
-						c01++;
-						c11++;
-					}
-				}
+/*!
+\brief Span kernel of the smooth rotozoomer interpolating in premultiplied alpha space.
 
-				/*
-				* Draw and interpolate colors 
-				*/
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;				
-				/*
-				* Advance source pointer x
-				*/
-				salast = csax;
-				csax++;				
-				sstep = (*csax >> 16) - (*salast >> 16);
-				if (flipx) {
-					sp -= sstep;
-				} else {
-					sp += sstep;
-				}
+Same as _transformRowRGBAFunc; ashift is the bit position of the alpha channel.
+*/
+typedef void (*_transformRowRGBAPremulFunc)(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin, int ashift);
 
-				/*
-				* Advance destination pointer x
-				*/
-				dp++;
-			}
-			/*
-			* Advance source pointer y
-			*/
-			salast = csay;
-			csay++;
-			sstep = (*csay >> 16) - (*salast >> 16);
-			sstep *= spixelgap;
-			if (flipy) { 
-				sp = csp - sstep;
-			} else {
-				sp = csp + sstep;
-			}
+/*!
+\brief Internal multiplication of the color channels of one 32bit pixel by its alpha.
 
-			/*
-			* Advance destination pointer y
-			*/
-			dp = (SDL_Color *) ((Uint8 *) dp + dgap);
-		}
-	} else {
-		/*
-		* Non-Interpolating Zoom 
-		*/		
-		csay = say;
-		for (y = 0; y < dst->h; y++) {
-			csp = sp;
-			csax = sax;
-			for (x = 0; x < dst->w; x++) {
-				/*
-				* Draw 
-				*/
-				*dp = *sp;
-
-				/*
-				* Advance source pointer x
-				*/
-				salast = csax;
-				csax++;				
-				sstep = (*csax >> 16) - (*salast >> 16);
-				if (flipx) sstep = -sstep;
-				sp += sstep;
-
-				/*
-				* Advance destination pointer x
-				*/
-				dp++;
-			}
-			/*
-			* Advance source pointer y
-			*/
-			salast = csay;
-			csay++;
-			sstep = (*csay >> 16) - (*salast >> 16);
-			sstep *= spixelgap;
-			if (flipy) sstep = -sstep;			
-			sp = csp + sstep;
+Every color channel c becomes c * a / 255, rounded to nearest; the alpha channel is kept.
 
-			/*
-			* Advance destination pointer y
-			*/
-			dp = (SDL_Color *) ((Uint8 *) dp + dgap);
+\param c The pixel with straight alpha.
+\param ashift The bit position of the alpha channel.
+
+\return The premultiplied pixel.
+*/
+static Uint32 _premultiplyRGBA(Uint32 c, int ashift)
+{
+	Uint32 result;
+	int shift, a, t;
+
+	a = (int) ((c >> ashift) & 0xff);
+	result = c & (0xffu << ashift);
+	for (shift = 0; shift < 32; shift += 8) {
+		if (shift != ashift) {
+			t = (int) ((c >> shift) & 0xff) * a + 128;
+			result |= (Uint32) ((t + (t >> 8)) >> 8) << shift;
 		}
 	}
-
-	/*
-	* Remove temp arrays 
-	*/
-	free(sax);
-	free(say);
-
-	return (0);
+	return result;
 }
 
-/*! 
-
-\brief Internal 8 bit Zoomer without smoothing.
+/*!
+\brief Internal division of the color channels of one premultiplied 32bit pixel by its alpha.
 
-Zooms 8bit palette/Y 'src' surface to 'dst' surface.
-Assumes src and dst surfaces are of 8 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+Fully transparent pixels become 0.
 
-\param src The surface to zoom (input).
-\param dst The zoomed surface (output).
-\param flipx Flag indicating if the image should be horizontally flipped.
-\param flipy Flag indicating if the image should be vertically flipped.
+\param c The premultiplied pixel.
+\param ashift The bit position of the alpha channel.
 
-\return 0 for success or -1 for error.
+\return The pixel with straight alpha.
 */
-int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+static Uint32 _unpremultiplyRGBA(Uint32 c, int ashift)
 {
-	int x, y;
-	Uint32 *sax, *say, *csax, *csay;
-	int csx, csy;
-	Uint8 *sp, *dp, *csp;
-	int dgap;
+	Uint32 result, scale, v;
+	int shift, a;
 
-	/*
-	* Allocate memory for row increments 
-	*/
-	if ((sax = (Uint32 *) malloc((dst->w + 1) * sizeof(Uint32))) == NULL) {
-		return (-1);
+	a = (int) ((c >> ashift) & 0xff);
+	if (a == 0) {
+		return 0;
 	}
-	if ((say = (Uint32 *) malloc((dst->h + 1) * sizeof(Uint32))) == NULL) {
-		free(sax);
-		return (-1);
+	if (a == 255) {
+		return c;
 	}
+	scale = ((255u << 16) + (Uint32) (a >> 1)) / (Uint32) a;
+	result = c & (0xffu << ashift);
+	for (shift = 0; shift < 32; shift += 8) {
+		if (shift != ashift) {
+			v = (((c >> shift) & 0xff) * scale + 0x8000) >> 16;
+			result |= ((v > 255) ? 255 : v) << shift;
+		}
+	}
+	return result;
+}
 
-	/*
-	* Pointer setup 
+/*!
+\brief Scalar (reference) premultiplied row kernel of the smooth zoomer.
+*/
+static void _zoomRowRGBAPremul_C(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w, int ashift)
+{
+	int x;
+
+	for (x = 0; x < w; x++) {
+		d[x] = _unpremultiplyRGBA(_interpolateRGBA(
+			_premultiplyRGBA(r0[ox0[x]], ashift), _premultiplyRGBA(r0[ox1[x]], ashift),
+			_premultiplyRGBA(r1[ox0[x]], ashift), _premultiplyRGBA(r1[ox1[x]], ashift),
+			fx[x], fy), ashift);
+	}
+}
+
+/*!
+\brief Scalar (reference) premultiplied span kernel of the smooth rotozoomer.
+*/
+static void _transformRowRGBAPremul_C(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin, int ashift)
+{
+	int x, o;
+
+	for (x = 0; x < w; x++) {
+		o = base + (sdy >> 16) * rowstep + (sdx >> 16) * colstep;
+		d[x] = _unpremultiplyRGBA(_interpolateRGBA(
+			_premultiplyRGBA(sp[o], ashift), _premultiplyRGBA(sp[o + colstep], ashift),
+			_premultiplyRGBA(sp[o + rowstep], ashift), _premultiplyRGBA(sp[o + rowstep + colstep], ashift),
+			sdx & 0xffff, sdy & 0xffff), ashift);
+		sdx = (int) ((Uint32) sdx + (Uint32) icos);
+		sdy = (int) ((Uint32) sdy + (Uint32) isin);
+	}
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 premultiplication of four pixels; see _premultiplyRGBA().
+
+\param c The pixels with straight alpha.
+\param ashift The bit position of the alpha channel as shift count.
+\param amask The mask of the alpha channel in every 32bit lane.
+
+\return The premultiplied pixels.
+*/
+static __m128i _premultiply4_SSE2(__m128i c, __m128i ashift, __m128i amask)
+{
+	__m128i zero, round, a, lo, hi;
+
+	zero = _mm_setzero_si128();
+	round = _mm_set1_epi16(128);
+
+	/* Replicate each alpha into the four 16bit lanes of its pixel */
+	a = _mm_and_si128(_mm_srl_epi32(c, ashift), _mm_set1_epi32(0xff));
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+	lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi32(a, a)), round);
+	hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi32(a, a)), round);
+	lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+	hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+	return _mm_or_si128(_mm_andnot_si128(amask, _mm_packus_epi16(lo, hi)), _mm_and_si128(c, amask));
+}
+
+/*!
+\brief SSE2 premultiplied row kernel of the smooth zoomer (four pixels per step).
+*/
+static void _zoomRowRGBAPremul_SSE2(const Uint32 *r0, const Uint32 *r1, Uint32 *d, const int *ox0, const int *ox1, const int *fx, int fy, int w, int ashift)
+{
+	int x, k;
+	__m128i ey, count, amask;
+	SDL_ALIGNED(16) Uint32 p[4];
+
+	ey = _mm_set1_epi32(fy);
+	count = _mm_cvtsi32_si128(ashift);
+	amask = _mm_set1_epi32((int) (0xffu << ashift));
+	for (x = 0; x + 4 <= w; x += 4) {
+		_mm_store_si128((__m128i *)p, _interpolate4_SSE2(
+			_premultiply4_SSE2(_mm_setr_epi32((int)r0[ox0[x]], (int)r0[ox0[x + 1]], (int)r0[ox0[x + 2]], (int)r0[ox0[x + 3]]), count, amask),
+			_premultiply4_SSE2(_mm_setr_epi32((int)r0[ox1[x]], (int)r0[ox1[x + 1]], (int)r0[ox1[x + 2]], (int)r0[ox1[x + 3]]), count, amask),
+			_premultiply4_SSE2(_mm_setr_epi32((int)r1[ox0[x]], (int)r1[ox0[x + 1]], (int)r1[ox0[x + 2]], (int)r1[ox0[x + 3]]), count, amask),
+			_premultiply4_SSE2(_mm_setr_epi32((int)r1[ox1[x]], (int)r1[ox1[x + 1]], (int)r1[ox1[x + 2]], (int)r1[ox1[x + 3]]), count, amask),
+			_mm_loadu_si128((const __m128i *)(fx + x)), ey));
+		for (k = 0; k < 4; k++) {
+			d[x + k] = _unpremultiplyRGBA(p[k], ashift);
+		}
+	}
+	_zoomRowRGBAPremul_C(r0, r1, d + x, ox0 + x, ox1 + x, fx + x, fy, w - x, ashift);
+}
+
+/*!
+\brief SSE2 premultiplied span kernel of the smooth rotozoomer (four pixels per step).
+*/
+static void _transformRowRGBAPremul_SSE2(const Uint32 *sp, int base, int colstep, int rowstep, Uint32 *d, int w, int sdx, int sdy, int icos, int isin, int ashift)
+{
+	int x, k, o;
+	__m128i count, amask;
+	SDL_ALIGNED(16) Uint32 c00[4], c01[4], c10[4], c11[4], p[4];
+	SDL_ALIGNED(16) int ex[4], ey[4];
+
+	count = _mm_cvtsi32_si128(ashift);
+	amask = _mm_set1_epi32((int) (0xffu << ashift));
+	for (x = 0; x + 4 <= w; x += 4) {
+		for (k = 0; k < 4; k++) {
+			o = base + (sdy >> 16) * rowstep + (sdx >> 16) * colstep;
+			c00[k] = sp[o];
+			c01[k] = sp[o + colstep];
+			c10[k] = sp[o + rowstep];
+			c11[k] = sp[o + rowstep + colstep];
+			ex[k] = sdx & 0xffff;
+			ey[k] = sdy & 0xffff;
+			sdx = (int) ((Uint32) sdx + (Uint32) icos);
+			sdy = (int) ((Uint32) sdy + (Uint32) isin);
+		}
+		_mm_store_si128((__m128i *)p, _interpolate4_SSE2(
+			_premultiply4_SSE2(_mm_load_si128((const __m128i *)c00), count, amask),
+			_premultiply4_SSE2(_mm_load_si128((const __m128i *)c01), count, amask),
+			_premultiply4_SSE2(_mm_load_si128((const __m128i *)c10), count, amask),
+			_premultiply4_SSE2(_mm_load_si128((const __m128i *)c11), count, amask),
+			_mm_load_si128((const __m128i *)ex), _mm_load_si128((const __m128i *)ey)));
+		for (k = 0; k < 4; k++) {
+			d[x + k] = _unpremultiplyRGBA(p[k], ashift);
+		}
+	}
+	_transformRowRGBAPremul_C(sp, base, colstep, rowstep, d + x, w - x, sdx, sdy, icos, isin, ashift);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+/*!
+\brief Internal selection of the premultiplied smooth zoomer row kernel for the current CPU.
+*/
+static _zoomRowRGBAPremulFunc _zoomRowRGBAPremulKernel(void)
+{
+#ifdef SDL_SSE2_INTRINSICS
+	if ((rotozoomSIMDEnabled) && (SDL_HasSSE2())) {
+		return _zoomRowRGBAPremul_SSE2;
+	}
+#endif
+	return _zoomRowRGBAPremul_C;
+}
+
+/*!
+\brief Internal selection of the premultiplied smooth rotozoomer row kernel for the current CPU.
+*/
+static _transformRowRGBAPremulFunc _transformRowRGBAPremulKernel(void)
+{
+#ifdef SDL_SSE2_INTRINSICS
+	if ((rotozoomSIMDEnabled) && (SDL_HasSSE2())) {
+		return _transformRowRGBAPremul_SSE2;
+	}
+#endif
+	return _transformRowRGBAPremul_C;
+}
+
+/*!
+\brief Internal check for premultiplied interpolation of a 32bit source.
+
+\param src The 32bit source surface.
+\param smooth The smoothing mode and flags.
+
+\return The bit position of the alpha channel if SMOOTHING_PREMULTIPLIED is set
+and the source has an 8bit alpha channel, -1 otherwise.
+*/
+static int _premultiplyShift(SDL_Surface * src, int smooth)
+{
+	const SDL_PixelFormatDetails* details;
+
+	if ((smooth & SMOOTHING_PREMULTIPLIED) == 0) {
+		return -1;
+	}
+	details = SDL_GetPixelFormatDetails(src->format);
+	if ((details == NULL) || (details->bytes_per_pixel != 4) || (details->Abits != 8)) {
+		return -1;
+	}
+	return details->Ashift;
+}
+
+/* ---- Thread pool */
+
+/*!
+\brief Band worker; processes destination rows ystart to yend-1.
+*/
+typedef void (*_rotozoomBandFunc)(void *data, int ystart, int yend);
+
+/*!
+\brief Number of threads (including the caller) used for the row loops; 1 disables threading.
+*/
+static int rotozoomThreads = 1;
+
+/*!
+\brief Minimum number of destination rows per band.
+*/
+static int rotozoomMinRowsPerBand = 64;
+
+/*!
+\brief Persistent pool of worker threads processing row bands.
+*/
+static struct {
+	SDL_Mutex *submit;
+	SDL_Mutex *lock;
+	SDL_Condition *wake;
+	SDL_Condition *done;
+	SDL_Thread **threads;
+	int numThreads;
+	int quit;
+	int active;
+	int generation;
+	_rotozoomBandFunc func;
+	void *data;
+	int rows;
+	int bandRows;
+	int numBands;
+	int nextBand;
+	int finishedBands;
+} rotozoomPool;
+
+/*!
+\brief Internal claiming and processing of bands of the current job until none are left.
+
+Must be called with the pool lock held; returns with the lock held.
+*/
+static void _rotozoomPoolRunBands(void)
+{
+	int band, ystart, yend;
+
+	while (rotozoomPool.nextBand < rotozoomPool.numBands) {
+		band = rotozoomPool.nextBand++;
+		ystart = band * rotozoomPool.bandRows;
+		yend = ystart + rotozoomPool.bandRows;
+		if (yend > rotozoomPool.rows) {
+			yend = rotozoomPool.rows;
+		}
+		SDL_UnlockMutex(rotozoomPool.lock);
+		rotozoomPool.func(rotozoomPool.data, ystart, yend);
+		SDL_LockMutex(rotozoomPool.lock);
+		rotozoomPool.finishedBands++;
+		if (rotozoomPool.finishedBands == rotozoomPool.numBands) {
+			SDL_SignalCondition(rotozoomPool.done);
+		}
+	}
+}
+
+/*!
+\brief Worker thread of the pool.
+*/
+static int _rotozoomPoolWorker(void *data)
+{
+	int generation;
+
+	(void)data;
+	SDL_LockMutex(rotozoomPool.lock);
+	generation = rotozoomPool.generation;
+	while (!rotozoomPool.quit) {
+		if (rotozoomPool.generation == generation) {
+			SDL_WaitCondition(rotozoomPool.wake, rotozoomPool.lock);
+			continue;
+		}
+		generation = rotozoomPool.generation;
+		_rotozoomPoolRunBands();
+	}
+	SDL_UnlockMutex(rotozoomPool.lock);
+	return 0;
+}
+
+/*!
+\brief Internal shutdown of the worker threads.
+
+Must be called with the submit lock held.
+*/
+static void _rotozoomPoolStop(void)
+{
+	int i;
+
+	if (rotozoomPool.threads == NULL) {
+		return;
+	}
+	SDL_LockMutex(rotozoomPool.lock);
+	rotozoomPool.quit = 1;
+	SDL_BroadcastCondition(rotozoomPool.wake);
+	SDL_UnlockMutex(rotozoomPool.lock);
+	for (i = 0; i < rotozoomPool.numThreads; i++) {
+		SDL_WaitThread(rotozoomPool.threads[i], NULL);
+	}
+	SDL_free(rotozoomPool.threads);
+	rotozoomPool.threads = NULL;
+	rotozoomPool.numThreads = 0;
+	rotozoomPool.quit = 0;
+}
+
+/*!
+\brief Internal startup of the worker threads.
+
+Must be called with the submit lock held.
+
+\param numThreads Number of worker threads to start.
+
+\return 0 for success or -1 for error.
+*/
+static int _rotozoomPoolStart(int numThreads)
+{
+	int i;
+
+	if (rotozoomPool.lock == NULL) {
+		rotozoomPool.lock = SDL_CreateMutex();
+		rotozoomPool.wake = SDL_CreateCondition();
+		rotozoomPool.done = SDL_CreateCondition();
+		if ((rotozoomPool.lock == NULL) || (rotozoomPool.wake == NULL) || (rotozoomPool.done == NULL)) {
+			return (-1);
+		}
+	}
+	if ((rotozoomPool.threads = (SDL_Thread **) SDL_malloc(numThreads * sizeof(SDL_Thread *))) == NULL) {
+		return (-1);
+	}
+	for (i = 0; i < numThreads; i++) {
+		rotozoomPool.threads[i] = SDL_CreateThread(_rotozoomPoolWorker, "rotozoom", NULL);
+		if (rotozoomPool.threads[i] == NULL) {
+			break;
+		}
+		rotozoomPool.numThreads++;
+	}
+	if (rotozoomPool.numThreads == 0) {
+		SDL_free(rotozoomPool.threads);
+		rotozoomPool.threads = NULL;
+		return (-1);
+	}
+	return (0);
+}
+
+/*!
+\brief Internal execution of a row loop, split into a given number of bands across the thread pool.
+
+The calling thread processes bands as well. Falls back to a single call of func
+when threading is disabled, fewer than 2 bands are requested, or the pool is
+busy with a job from another thread or with the job calling this function.
+
+\param rows Number of destination rows.
+\param bands Number of bands; at most the configured number of threads are used.
+\param func The band worker.
+\param data Context passed to the band worker.
+*/
+static void _rotozoomParallelBands(int rows, int bands, _rotozoomBandFunc func, void *data)
+{
+	if ((rotozoomThreads < 2) || (bands < 2) || (rotozoomPool.submit == NULL) || !SDL_TryLockMutex(rotozoomPool.submit)) {
+		func(data, 0, rows);
+		return;
+	}
+
+	/*
+	* Run row loops of a job nested in the job on the calling thread 
+	*/
+	if (bands > rotozoomThreads) {
+		bands = rotozoomThreads;
+	}
+	if (rotozoomPool.active || ((rotozoomPool.threads == NULL) && (_rotozoomPoolStart(rotozoomThreads - 1) != 0))) {
+		SDL_UnlockMutex(rotozoomPool.submit);
+		func(data, 0, rows);
+		return;
+	}
+
+	SDL_LockMutex(rotozoomPool.lock);
+	rotozoomPool.active = 1;
+	rotozoomPool.func = func;
+	rotozoomPool.data = data;
+	rotozoomPool.rows = rows;
+	rotozoomPool.bandRows = (rows + bands - 1) / bands;
+	rotozoomPool.numBands = (rows + rotozoomPool.bandRows - 1) / rotozoomPool.bandRows;
+	rotozoomPool.nextBand = 0;
+	rotozoomPool.finishedBands = 0;
+	rotozoomPool.generation++;
+	SDL_BroadcastCondition(rotozoomPool.wake);
+	_rotozoomPoolRunBands();
+	while (rotozoomPool.finishedBands < rotozoomPool.numBands) {
+		SDL_WaitCondition(rotozoomPool.done, rotozoomPool.lock);
+	}
+	rotozoomPool.active = 0;
+	SDL_UnlockMutex(rotozoomPool.lock);
+
+	SDL_UnlockMutex(rotozoomPool.submit);
+}
+
+/*!
+\brief Internal execution of a row loop, split into bands across the thread pool.
+
+The rows are partitioned into contiguous bands of at least rotozoomMinRowsPerBand
+rows, one per thread at most; see _rotozoomParallelBands().
+
+\param rows Number of destination rows.
+\param func The band worker.
+\param data Context passed to the band worker.
+*/
+static void _rotozoomParallelFor(int rows, _rotozoomBandFunc func, void *data)
+{
+	_rotozoomParallelBands(rows, rows / rotozoomMinRowsPerBand, func, data);
+}
+
+/*!
+\brief Configure multi-threading of the zoomer and rotozoomer.
+
+Destination rows are split into horizontal bands which are processed by a pool
+of worker threads and the calling thread. The output is identical to the
+single-threaded code. Changing the thread count stops the current workers;
+new ones are started on the next large enough job.
+
+\param numThreads Number of threads to use including the caller; 1 disables threading (default), 0 uses one thread per logical CPU core.
+\param minRowsPerBand Minimum number of destination rows per band (default 64); smaller jobs use fewer threads.
+*/
+void rotozoomSetThreads(int numThreads, int minRowsPerBand)
+{
+	if (numThreads <= 0) {
+		numThreads = SDL_GetNumLogicalCPUCores();
+	}
+	if (numThreads < 1) {
+		numThreads = 1;
+	}
+	if (minRowsPerBand < 1) {
+		minRowsPerBand = 1;
+	}
+
+	if (rotozoomPool.submit == NULL) {
+		if (numThreads == 1) {
+			rotozoomThreads = 1;
+			rotozoomMinRowsPerBand = minRowsPerBand;
+			return;
+		}
+		if ((rotozoomPool.submit = SDL_CreateMutex()) == NULL) {
+			return;
+		}
+	}
+
+	SDL_LockMutex(rotozoomPool.submit);
+	if (numThreads != rotozoomThreads) {
+		_rotozoomPoolStop();
+	}
+	rotozoomThreads = numThreads;
+	rotozoomMinRowsPerBand = minRowsPerBand;
+	SDL_UnlockMutex(rotozoomPool.submit);
+}
+
+
+/* ---- Area-averaging shrink */
+
+/*!
+\brief Internal coverage table of the area-averaging shrinker for one axis.
+
+Source sample i contributes the fraction weight[i]/256 of its area to destination
+sample index[i] and the rest to destination sample index[i] + 1.
+
+\param srcn The number of source samples.
+\param dstn The number of destination samples; must not exceed srcn.
+\param index Array of srcn destination indices (output).
+\param weight Array of srcn coverage weights (output).
+*/
+static void _shrinkAreaTable(int srcn, int dstn, int *index, int *weight)
+{
+	int i, d;
+	Sint64 s0, s1, b;
+
+	for (i = 0; i < srcn; i++) {
+		/* Source sample i covers [s0, s1), destination sample d ends at b (both scaled by srcn*dstn) */
+		s0 = (Sint64) i * dstn;
+		s1 = s0 + dstn;
+		d = (int) (s0 / srcn);
+		b = (Sint64) (d + 1) * srcn;
+		index[i] = d;
+		weight[i] = (s1 <= b) ? 256 : (int) (((b - s0) * 256 + dstn / 2) / dstn);
+	}
+}
+
+/*!
+\brief Context of the area-averaging shrinker bands.
+*/
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	const int *xindex;
+	const int *xweight;
+	const int *yindex;
+	const int *yweight;
+	Uint32 xrecip;
+	Uint32 yrecip;
+	int bpp;
+	SDL_AtomicInt failed;
+} _shrinkAreaContext;
+
+/*!
+\brief Internal area-averaging shrinker band; produces destination rows ystart to yend-1.
+
+Source rows are streamed once: each row is summed horizontally with the column
+coverage weights, normalized by a reciprocal multiply and added to the
+accumulators of the one or two destination rows it covers. A destination row is
+written as soon as its last source row was added.
+
+\param data The _shrinkAreaContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _shrinkAreaBand(void *data, int ystart, int yend)
+{
+	_shrinkAreaContext *ctx = (_shrinkAreaContext *) data;
+	SDL_Surface *src = ctx->src;
+	SDL_Surface *dst = ctx->dst;
+	int bpp = ctx->bpp;
+	int n = dst->w * bpp;
+	int x, y, r, k, w0, w1, wc, wn;
+	Uint32 *hsum, *hp, h;
+	Uint64 *acc, *cur, *next, *t, v;
+	Uint8 *sp, *dp;
+
+	hsum = (Uint32 *) SDL_malloc((n + bpp) * sizeof(Uint32));
+	acc = (Uint64 *) SDL_calloc(2 * (size_t) n, sizeof(Uint64));
+	if ((hsum == NULL) || (acc == NULL)) {
+		SDL_SetAtomicInt(&ctx->failed, 1);
+		SDL_free(hsum);
+		SDL_free(acc);
+		return;
+	}
+	cur = acc;
+	next = acc + n;
+
+	y = ystart;
+	for (r = (int) (((Sint64) ystart * src->h) / dst->h); (r < src->h) && (y < yend); r++) {
+		/*
+		* Horizontal coverage sums of the source row 
+		*/
+		memset(hsum, 0, (n + bpp) * sizeof(Uint32));
+		sp = (Uint8 *) src->pixels + r * src->pitch;
+		if (bpp == 4) {
+			for (x = 0; x < src->w; x++) {
+				hp = hsum + ctx->xindex[x] * 4;
+				w0 = ctx->xweight[x];
+				w1 = 256 - w0;
+				hp[0] += sp[0] * w0;
+				hp[1] += sp[1] * w0;
+				hp[2] += sp[2] * w0;
+				hp[3] += sp[3] * w0;
+				hp[4] += sp[0] * w1;
+				hp[5] += sp[1] * w1;
+				hp[6] += sp[2] * w1;
+				hp[7] += sp[3] * w1;
+				sp += 4;
+			}
+		} else {
+			for (x = 0; x < src->w; x++) {
+				hp = hsum + ctx->xindex[x];
+				w0 = ctx->xweight[x];
+				hp[0] += sp[x] * w0;
+				hp[1] += sp[x] * (256 - w0);
+			}
+		}
+
+		/*
+		* Add the row to the destination rows it covers; a row started in
+		* the previous band only contributes its remainder 
+		*/
+		if (ctx->yindex[r] < y) {
+			wc = 256 - ctx->yweight[r];
+			wn = 0;
+		} else {
+			wc = ctx->yweight[r];
+			wn = 256 - wc;
+		}
+		for (k = 0; k < n; k++) {
+			h = (Uint32) (((Uint64) hsum[k] * ctx->xrecip + (1 << 23)) >> 24);
+			cur[k] += (Uint64) h * wc;
+			next[k] += (Uint64) h * wn;
+		}
+
+		/*
+		* Store the destination row once its last source row was added 
+		*/
+		if ((Sint64) (r + 1) * dst->h >= (Sint64) (y + 1) * src->h) {
+			dp = (Uint8 *) dst->pixels + y * dst->pitch;
+			for (k = 0; k < n; k++) {
+				v = (cur[k] * ctx->yrecip + ((Uint64) 1 << 39)) >> 40;
+				dp[k] = (Uint8) ((v > 255) ? 255 : v);
+			}
+			t = cur;
+			cur = next;
+			next = t;
+			memset(next, 0, n * sizeof(Uint64));
+			y++;
+		}
+	}
+
+	SDL_free(hsum);
+	SDL_free(acc);
+}
+
+/*!
+\brief Internal area-averaging shrinker for arbitrary ratios.
+
+Shrinks a 32bit RGBA/ABGR or 8bit Y 'src' surface to 'dst' surface. Every
+destination pixel is the average of the source area it covers, with source
+pixels on the border weighted by their fractional coverage.
+Assumes dst surface is not larger than src and of the same depth.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+
+\return 0 for success or -1 for error.
+*/
+static int _shrinkSurfaceArea(SDL_Surface * src, SDL_Surface * dst)
+{
+	_shrinkAreaContext ctx;
+	int *tables;
+
+	/*
+	* Allocate memory for the column and row coverage tables 
+	*/
+	if ((tables = (int *) SDL_malloc(2 * ((size_t) src->w + src->h) * sizeof(int))) == NULL) {
+		return (-1);
+	}
+	ctx.src = src;
+	ctx.dst = dst;
+	ctx.xindex = tables;
+	ctx.xweight = tables + src->w;
+	ctx.yindex = tables + 2 * src->w;
+	ctx.yweight = tables + 2 * src->w + src->h;
+	_shrinkAreaTable(src->w, dst->w, tables, tables + src->w);
+	_shrinkAreaTable(src->h, dst->h, tables + 2 * src->w, tables + 2 * src->w + src->h);
+
+	/*
+	* Reciprocals of the covered areas (in units of 1/256 pixel) 
+	*/
+	ctx.xrecip = (Uint32) ((((Uint64) dst->w << 24) + src->w / 2) / src->w);
+	ctx.yrecip = (Uint32) ((((Uint64) dst->h << 24) + src->h / 2) / src->h);
+	ctx.bpp = SDL_BYTESPERPIXEL(dst->format);
+	SDL_SetAtomicInt(&ctx.failed, 0);
+
+	_rotozoomParallelFor(dst->h, _shrinkAreaBand, &ctx);
+
+	SDL_free(tables);
+
+	return (SDL_GetAtomicInt(&ctx.failed) ? -1 : 0);
+}
+
+/* ---- Mipmap chains */
+
+/*!
+\brief Row kernel of the 2x2 box filter; averages rows s0 and s1 into w destination pixels.
+*/
+typedef void (*_shrinkRow2x2Func)(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w);
+
+/*!
+\brief Scalar (reference) 2x2 box filter row kernel for 32bit pixels.
+*/
+static void _shrinkRow2x2RGBA_C(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x, c;
+
+	for (x = 0; x < w; x++) {
+		for (c = 0; c < 4; c++) {
+			d[c] = (Uint8) ((s0[c] + s0[c + 4] + s1[c] + s1[c + 4]) >> 2);
+		}
+		s0 += 8;
+		s1 += 8;
+		d += 4;
+	}
+}
+
+/*!
+\brief Scalar (reference) 2x2 box filter row kernel for 8bit pixels.
+*/
+static void _shrinkRow2x2Y_C(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x;
+
+	for (x = 0; x < w; x++) {
+		d[x] = (Uint8) ((s0[2 * x] + s0[2 * x + 1] + s1[2 * x] + s1[2 * x + 1]) >> 2);
+	}
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 2x2 box filter row kernel for 32bit pixels (four destination pixels per step).
+*/
+static void _shrinkRow2x2RGBA_SSE2(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x;
+	__m128i zero, a, b, lo, hi, r0, r1;
+
+	zero = _mm_setzero_si128();
+	for (x = 0; x + 4 <= w; x += 4) {
+		/* Vertical sums of source pixels 0-1, 2-3 (r0) and 4-5, 6-7 (r1) */
+		a = _mm_loadu_si128((const __m128i *) (s0 + 8 * x));
+		b = _mm_loadu_si128((const __m128i *) (s1 + 8 * x));
+		lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		r0 = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		a = _mm_loadu_si128((const __m128i *) (s0 + 8 * x + 16));
+		b = _mm_loadu_si128((const __m128i *) (s1 + 8 * x + 16));
+		lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		r1 = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		_mm_storeu_si128((__m128i *) (d + 4 * x), _mm_packus_epi16(_mm_srli_epi16(r0, 2), _mm_srli_epi16(r1, 2)));
+	}
+	_shrinkRow2x2RGBA_C(s0 + 8 * x, s1 + 8 * x, d + 4 * x, w - x);
+}
+
+/*!
+\brief SSE2 2x2 box filter row kernel for 8bit pixels (sixteen destination pixels per step).
+*/
+static void _shrinkRow2x2Y_SSE2(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x;
+	__m128i mask, a, b, r0, r1;
+
+	mask = _mm_set1_epi16(0xff);
+	for (x = 0; x + 16 <= w; x += 16) {
+		/* Even plus odd source bytes of both rows */
+		a = _mm_loadu_si128((const __m128i *) (s0 + 2 * x));
+		b = _mm_loadu_si128((const __m128i *) (s1 + 2 * x));
+		r0 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8)),
+			_mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8)));
+		a = _mm_loadu_si128((const __m128i *) (s0 + 2 * x + 16));
+		b = _mm_loadu_si128((const __m128i *) (s1 + 2 * x + 16));
+		r1 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8)),
+			_mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8)));
+		_mm_storeu_si128((__m128i *) (d + x), _mm_packus_epi16(_mm_srli_epi16(r0, 2), _mm_srli_epi16(r1, 2)));
+	}
+	_shrinkRow2x2Y_C(s0 + 2 * x, s1 + 2 * x, d + x, w - x);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_NEON_INTRINSICS
+/*!
+\brief NEON 2x2 box filter row kernel for 32bit pixels (two destination pixels per step).
+*/
+static void _shrinkRow2x2RGBA_NEON(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x;
+	uint8x16_t a, b;
+	uint16x8_t lo, hi;
+
+	for (x = 0; x + 2 <= w; x += 2) {
+		a = vld1q_u8(s0 + 8 * x);
+		b = vld1q_u8(s1 + 8 * x);
+		lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+		hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+		lo = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)), vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+		vst1_u8(d + 4 * x, vshrn_n_u16(lo, 2));
+	}
+	_shrinkRow2x2RGBA_C(s0 + 8 * x, s1 + 8 * x, d + 4 * x, w - x);
+}
+
+/*!
+\brief NEON 2x2 box filter row kernel for 8bit pixels (eight destination pixels per step).
+*/
+static void _shrinkRow2x2Y_NEON(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w)
+{
+	int x;
+
+	for (x = 0; x + 8 <= w; x += 8) {
+		vst1_u8(d + x, vshrn_n_u16(vaddq_u16(vpaddlq_u8(vld1q_u8(s0 + 2 * x)), vpaddlq_u8(vld1q_u8(s1 + 2 * x))), 2));
+	}
+	_shrinkRow2x2Y_C(s0 + 2 * x, s1 + 2 * x, d + x, w - x);
+}
+#endif /* SDL_NEON_INTRINSICS */
+
+/*!
+\brief Internal selection of the 2x2 box filter row kernel for the current CPU.
+
+\param bpp The number of bytes per pixel (4 or 1).
+*/
+static _shrinkRow2x2Func _shrinkRow2x2Kernel(int bpp)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return (bpp == 4) ? _shrinkRow2x2RGBA_SSE2 : _shrinkRow2x2Y_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return (bpp == 4) ? _shrinkRow2x2RGBA_NEON : _shrinkRow2x2Y_NEON;
+		}
+#endif
+	}
+	return (bpp == 4) ? _shrinkRow2x2RGBA_C : _shrinkRow2x2Y_C;
+}
+
+/* ---- Integer-factor shrink */
+
+/*!
+\brief Largest number of source rows summed in the 16bit column sums of the integer shrinkers.
+*/
+#define SHRINK_MAX_ROWS	257
+
+/*!
+\brief Largest box size (factorx * factory) whose average is taken by a reciprocal multiply.
+
+For sums s <= 255 * n the truncated product (s * ceil(2^32 / n)) >> 32 equals s / n
+as long as 255 * n * (n - 1) < 2^32.
+*/
+#define SHRINK_MAX_RECIP	4096
+
+/*!
+\brief Row kernel of the integer shrinkers; adds n source bytes to 16bit column sums.
+*/
+typedef void (*_shrinkAddRowFunc)(const Uint8 *s, Uint16 *v, int n);
+
+/*!
+\brief Reduce kernel of the integer shrinkers; adds the factorx column sums of each of w destination pixels to h.
+*/
+typedef void (*_shrinkReduceFunc)(const Uint16 *v, Uint32 *h, int w, int factorx);
+
+/*!
+\brief Store kernel of the integer shrinkers; writes the n box sums divided by the box size.
+*/
+typedef void (*_shrinkStoreFunc)(const Uint32 *h, Uint8 *d, int n, Uint32 recip, int n_average);
+
+/*!
+\brief Scalar (reference) row kernel of the integer shrinkers.
+*/
+static void _shrinkAddRow_C(const Uint8 *s, Uint16 *v, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		v[i] += s[i];
+	}
+}
+
+/*!
+\brief Scalar (reference) reduce kernel of the 32bit integer shrinker.
+*/
+static void _shrinkReduceRGBA_C(const Uint16 *v, Uint32 *h, int w, int factorx)
+{
+	int x, dx;
+
+	for (x = 0; x < w; x++) {
+		for (dx = 0; dx < factorx; dx++) {
+			h[0] += v[0];
+			h[1] += v[1];
+			h[2] += v[2];
+			h[3] += v[3];
+			v += 4;
+		}
+		h += 4;
+	}
+}
+
+/*!
+\brief Scalar reduce kernel of the 8bit integer shrinker.
+*/
+static void _shrinkReduceY_C(const Uint16 *v, Uint32 *h, int w, int factorx)
+{
+	int x, dx;
+	Uint32 a;
+
+	for (x = 0; x < w; x++) {
+		a = 0;
+		for (dx = 0; dx < factorx; dx++) {
+			a += v[dx];
+		}
+		h[x] += a;
+		v += factorx;
+	}
+}
+
+/*!
+\brief Scalar (reference) store kernel of the integer shrinkers; divides if recip is 0.
+*/
+static void _shrinkStore_C(const Uint32 *h, Uint8 *d, int n, Uint32 recip, int n_average)
+{
+	int i;
+
+	if (recip == 0) {
+		for (i = 0; i < n; i++) {
+			d[i] = (Uint8) (h[i] / n_average);
+		}
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		d[i] = (Uint8) (((Uint64) h[i] * recip) >> 32);
+	}
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 row kernel of the integer shrinkers (sixteen bytes per step).
+*/
+static void _shrinkAddRow_SSE2(const Uint8 *s, Uint16 *v, int n)
+{
+	int i;
+	__m128i zero, a;
+
+	zero = _mm_setzero_si128();
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = _mm_loadu_si128((const __m128i *) (s + i));
+		_mm_storeu_si128((__m128i *) (v + i), _mm_add_epi16(_mm_loadu_si128((const __m128i *) (v + i)), _mm_unpacklo_epi8(a, zero)));
+		_mm_storeu_si128((__m128i *) (v + i + 8), _mm_add_epi16(_mm_loadu_si128((const __m128i *) (v + i + 8)), _mm_unpackhi_epi8(a, zero)));
+	}
+	_shrinkAddRow_C(s + i, v + i, n - i);
+}
+
+/*!
+\brief SSE2 reduce kernel of the 32bit integer shrinker (two source pixels per step).
+*/
+static void _shrinkReduceRGBA_SSE2(const Uint16 *v, Uint32 *h, int w, int factorx)
+{
+	int x, dx;
+	__m128i zero, a, sum;
+
+	zero = _mm_setzero_si128();
+	for (x = 0; x < w; x++) {
+		sum = _mm_loadu_si128((const __m128i *) h);
+		for (dx = 0; dx + 2 <= factorx; dx += 2) {
+			a = _mm_loadu_si128((const __m128i *) v);
+			sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpackhi_epi16(a, zero)));
+			v += 8;
+		}
+		if (dx < factorx) {
+			sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) v), zero));
+			v += 4;
+		}
+		_mm_storeu_si128((__m128i *) h, sum);
+		h += 4;
+	}
+}
+
+/*!
+\brief SSE2 store kernel of the integer shrinkers (four values per step).
+*/
+static void _shrinkStore_SSE2(const Uint32 *h, Uint8 *d, int n, Uint32 recip, int n_average)
+{
+	int i;
+	__m128i m, a, even, odd, q;
+
+	if (recip == 0) {
+		_shrinkStore_C(h, d, n, recip, n_average);
+		return;
+	}
+	m = _mm_set1_epi32((int) recip);
+	for (i = 0; i + 4 <= n; i += 4) {
+		/* High halves of the 64bit products of lanes 0, 2 and 1, 3 */
+		a = _mm_loadu_si128((const __m128i *) (h + i));
+		even = _mm_srli_epi64(_mm_mul_epu32(a, m), 32);
+		odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+		q = _mm_or_si128(even, _mm_and_si128(odd, _mm_set_epi32(-1, 0, -1, 0)));
+		q = _mm_packs_epi32(q, q);
+		*(Uint32 *) (d + i) = (Uint32) _mm_cvtsi128_si32(_mm_packus_epi16(q, q));
+	}
+	_shrinkStore_C(h + i, d + i, n - i, recip, n_average);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_NEON_INTRINSICS
+/*!
+\brief NEON row kernel of the integer shrinkers (sixteen bytes per step).
+*/
+static void _shrinkAddRow_NEON(const Uint8 *s, Uint16 *v, int n)
+{
+	int i;
+	uint8x16_t a;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		a = vld1q_u8(s + i);
+		vst1q_u16(v + i, vaddw_u8(vld1q_u16(v + i), vget_low_u8(a)));
+		vst1q_u16(v + i + 8, vaddw_u8(vld1q_u16(v + i + 8), vget_high_u8(a)));
+	}
+	_shrinkAddRow_C(s + i, v + i, n - i);
+}
+
+/*!
+\brief NEON reduce kernel of the 32bit integer shrinker (one source pixel per step).
+*/
+static void _shrinkReduceRGBA_NEON(const Uint16 *v, Uint32 *h, int w, int factorx)
+{
+	int x, dx;
+	uint32x4_t sum;
+
+	for (x = 0; x < w; x++) {
+		sum = vld1q_u32(h);
+		for (dx = 0; dx < factorx; dx++) {
+			sum = vaddw_u16(sum, vld1_u16(v));
+			v += 4;
+		}
+		vst1q_u32(h, sum);
+		h += 4;
+	}
+}
+
+/*!
+\brief NEON store kernel of the integer shrinkers (four values per step).
+*/
+static void _shrinkStore_NEON(const Uint32 *h, Uint8 *d, int n, Uint32 recip, int n_average)
+{
+	int i;
+	uint32x2_t m;
+	uint16x4_t q;
+
+	if (recip == 0) {
+		_shrinkStore_C(h, d, n, recip, n_average);
+		return;
+	}
+	m = vdup_n_u32(recip);
+	for (i = 0; i + 4 <= n; i += 4) {
+		uint32x4_t a = vld1q_u32(h + i);
+		q = vmovn_u32(vcombine_u32(vshrn_n_u64(vmull_u32(vget_low_u32(a), m), 32), vshrn_n_u64(vmull_u32(vget_high_u32(a), m), 32)));
+		d[i] = (Uint8) vget_lane_u16(q, 0);
+		d[i + 1] = (Uint8) vget_lane_u16(q, 1);
+		d[i + 2] = (Uint8) vget_lane_u16(q, 2);
+		d[i + 3] = (Uint8) vget_lane_u16(q, 3);
+	}
+	_shrinkStore_C(h + i, d + i, n - i, recip, n_average);
+}
+#endif /* SDL_NEON_INTRINSICS */
+
+/*!
+\brief Context of the integer shrinker bands.
+*/
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	int factorx;
+	int factory;
+	int bpp;
+	int n_average;
+	Uint32 recip;
+	_shrinkAddRowFunc addRow;
+	_shrinkReduceFunc reduce;
+	_shrinkStoreFunc store;
+	_shrinkRow2x2Func row2x2;
+	SDL_AtomicInt failed;
+} _shrinkBoxContext;
+
+/*!
+\brief Internal integer shrinker band; produces destination rows ystart to yend-1.
+
+The source rows of a destination row are added into 16bit column sums (at most
+SHRINK_MAX_ROWS at a time), which are reduced to one sum per destination
+channel and divided by the box size with a reciprocal multiply.
+
+\param data The _shrinkBoxContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _shrinkBoxBand(void *data, int ystart, int yend)
+{
+	_shrinkBoxContext *ctx = (_shrinkBoxContext *) data;
+	SDL_Surface *src = ctx->src;
+	SDL_Surface *dst = ctx->dst;
+	int y, dy, i, rows, n, sn;
+	Uint16 *v;
+	Uint32 *h;
+	Uint8 *sp, *dp;
+
+	n = dst->w * ctx->bpp;
+	sn = n * ctx->factorx;
+
+	/*
+	* 2x2 boxes: average pairs of rows directly 
+	*/
+	if (ctx->row2x2) {
+		for (y = ystart; y < yend; y++) {
+			sp = (Uint8 *) src->pixels + (size_t) (2 * y) * src->pitch;
+			ctx->row2x2(sp, sp + src->pitch, (Uint8 *) dst->pixels + (size_t) y * dst->pitch, dst->w);
+		}
+		return;
+	}
+
+	v = (Uint16 *) SDL_malloc((size_t) sn * sizeof(Uint16));
+	h = (Uint32 *) SDL_malloc((size_t) n * sizeof(Uint32));
+	if ((v == NULL) || (h == NULL)) {
+		SDL_SetAtomicInt(&ctx->failed, 1);
+		SDL_free(v);
+		SDL_free(h);
+		return;
+	}
+
+	for (y = ystart; y < yend; y++) {
+		memset(h, 0, (size_t) n * sizeof(Uint32));
+		for (dy = 0; dy < ctx->factory; dy += rows) {
+			rows = SDL_min(ctx->factory - dy, SHRINK_MAX_ROWS);
+			memset(v, 0, (size_t) sn * sizeof(Uint16));
+			sp = (Uint8 *) src->pixels + ((size_t) y * ctx->factory + dy) * src->pitch;
+			for (i = 0; i < rows; i++) {
+				ctx->addRow(sp, v, sn);
+				sp += src->pitch;
+			}
+			ctx->reduce(v, h, dst->w, ctx->factorx);
+		}
+		dp = (Uint8 *) dst->pixels + (size_t) y * dst->pitch;
+		ctx->store(h, dp, n, ctx->recip, ctx->n_average);
+	}
+
+	SDL_free(v);
+	SDL_free(h);
+}
+
+/*!
+\brief Internal integer-factor averaging shrinker for 32bit and 8bit surfaces.
+
+Sets up the kernels for the current CPU and runs the bands across the thread pool.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return 0 for success or -1 for error.
+*/
+static int _shrinkSurfaceBox(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+	_shrinkBoxContext ctx;
+
+	ctx.src = src;
+	ctx.dst = dst;
+	ctx.factorx = factorx;
+	ctx.factory = factory;
+	ctx.bpp = SDL_BYTESPERPIXEL(dst->format);
+	ctx.n_average = factorx * factory;
+	ctx.recip = ((ctx.n_average > 1) && (ctx.n_average <= SHRINK_MAX_RECIP)) ? (Uint32) (0xFFFFFFFFu / (Uint32) ctx.n_average + 1) : 0;
+	ctx.addRow = _shrinkAddRow_C;
+	ctx.reduce = (ctx.bpp == 4) ? _shrinkReduceRGBA_C : _shrinkReduceY_C;
+	ctx.store = _shrinkStore_C;
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			ctx.addRow = _shrinkAddRow_SSE2;
+			ctx.reduce = (ctx.bpp == 4) ? _shrinkReduceRGBA_SSE2 : _shrinkReduceY_C;
+			ctx.store = _shrinkStore_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			ctx.addRow = _shrinkAddRow_NEON;
+			ctx.reduce = (ctx.bpp == 4) ? _shrinkReduceRGBA_NEON : _shrinkReduceY_C;
+			ctx.store = _shrinkStore_NEON;
+		}
+#endif
+	}
+	ctx.row2x2 = ((factorx == 2) && (factory == 2)) ? _shrinkRow2x2Kernel(ctx.bpp) : NULL;
+	SDL_SetAtomicInt(&ctx.failed, 0);
+
+	_rotozoomParallelFor(dst->h, _shrinkBoxBand, &ctx);
+
+	return (SDL_GetAtomicInt(&ctx.failed) ? -1 : 0);
+}
+
+/*! 
+\brief Internal 32 bit integer-factor averaging Shrinker.
+
+Shrinks 32 bit RGBA/ABGR 'src' surface to 'dst' surface.
+Averages color and alpha values values of src pixels to calculate dst pixels.
+Rows are summed with SIMD kernels where available and split into bands across
+the thread pool; the result equals the truncated average of every box.
+Assumes src and dst surfaces are of 32 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return 0 for success or -1 for error.
+*/
+int _shrinkSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+	return _shrinkSurfaceBox(src, dst, factorx, factory);
+}
+
+/*! 
+\brief Internal 8 bit integer-factor averaging shrinker.
+
+Shrinks 8bit Y 'src' surface to 'dst' surface.
+Averages color (brightness) values values of src pixels to calculate dst pixels.
+Rows are summed with SIMD kernels where available and split into bands across
+the thread pool; the result equals the truncated average of every box.
+Assumes src and dst surfaces are of 8 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return 0 for success or -1 for error.
+*/
+int _shrinkSurfaceY(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+	return _shrinkSurfaceBox(src, dst, factorx, factory);
+}
+
+/* ---- Separable filters */
+
+/*!
+\brief Number of fractional bits of the separable filter weights.
+*/
+#define ZOOM_FILTER_BITS	14
+
+/*!
+\brief Precalculated weights of a separable resampling filter along one axis.
+
+Destination sample i is the weighted sum of the source samples start[i] to
+start[i] + taps - 1 with the weights weights[i * taps] to weights[i * taps + taps - 1],
+which are fixed point numbers with ZOOM_FILTER_BITS fractional bits summing to 1.
+*/
+typedef struct {
+	int taps;
+	int *start;
+	Sint16 *weights;
+} _zoomFilterTable;
+
+/*!
+\brief Horizontal pass kernel; filters one row of 32bit pixels.
+*/
+typedef void (*_zoomFilterRowHFunc)(const Uint32 *s, Uint32 *d, int w, const int *start, const Sint16 *weights, int taps);
+
+/*!
+\brief Vertical pass kernel; filters taps rows, spitch pixels apart, into one row of 32bit pixels.
+*/
+typedef void (*_zoomFilterRowVFunc)(const Uint32 *s, int spitch, Uint32 *d, int w, const Sint16 *weights, int taps);
+
+/*!
+\brief Bicubic (Catmull-Rom) filter kernel with support 2.
+*/
+static double _zoomFilterBicubic(double x)
+{
+	x = fabs(x);
+	if (x < 1.0) {
+		return (1.5 * x - 2.5) * x * x + 1.0;
+	}
+	if (x < 2.0) {
+		return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+	}
+	return 0.0;
+}
+
+/*!
+\brief Lanczos filter kernel with support 3.
+*/
+static double _zoomFilterLanczos3(double x)
+{
+	double px;
+
+	x = fabs(x);
+	if (x < 1e-8) {
+		return 1.0;
+	}
+	if (x >= 3.0) {
+		return 0.0;
+	}
+	px = M_PI * x;
+	return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+}
+
+/*!
+\brief Internal calculation of the filter weights for one axis.
+
+Source and destination samples are aligned at their centers. For downscales the
+kernel is widened by the scale factor so every source sample contributes.
+Samples beyond the edges are clamped to the edge sample.
+
+\param table The table to fill; free with _zoomFilterTableFree().
+\param srcn The number of source samples.
+\param dstn The number of destination samples.
+\param flip Flag indicating the axis should be mirrored.
+\param mode SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomFilterTableInit(_zoomFilterTable *table, int srcn, int dstn, int flip, int mode)
+{
+	double (*kernel)(double);
+	double support, scale, fscale, center, w, sum, maxw, *fw;
+	int i, j, k, idx, left, right, start, isum, maxk, taps;
+	Sint16 *wt;
+
+	kernel = ((mode & ~SMOOTHING_PREMULTIPLIED) == SMOOTHING_LANCZOS3) ? _zoomFilterLanczos3 : _zoomFilterBicubic;
+	support = ((mode & ~SMOOTHING_PREMULTIPLIED) == SMOOTHING_LANCZOS3) ? 3.0 : 2.0;
+	scale = (double) srcn / (double) dstn;
+	fscale = (scale > 1.0) ? scale : 1.0;
+	support *= fscale;
+	taps = 2 * (int) ceil(support) + 1;
+	if (taps > srcn) {
+		taps = srcn;
+	}
+
+	table->taps = taps;
+	table->start = (int *) SDL_malloc(dstn * sizeof(int));
+	table->weights = (Sint16 *) SDL_malloc((size_t) dstn * taps * sizeof(Sint16));
+	fw = (double *) SDL_malloc(taps * sizeof(double));
+	if ((table->start == NULL) || (table->weights == NULL) || (fw == NULL)) {
+		SDL_free(table->start);
+		SDL_free(table->weights);
+		SDL_free(fw);
+		table->start = NULL;
+		table->weights = NULL;
+		return (-1);
+	}
+
+	for (i = 0; i < dstn; i++) {
+		center = ((double) (flip ? dstn - 1 - i : i) + 0.5) * scale - 0.5;
+		left = (int) ceil(center - support);
+		right = (int) floor(center + support);
+		start = left;
+		if (start > srcn - taps) start = srcn - taps;
+		if (start < 0) start = 0;
+
+		/*
+		* Accumulate the kernel, clamping samples beyond the edges 
+		*/
+		for (k = 0; k < taps; k++) {
+			fw[k] = 0.0;
+		}
+		sum = 0.0;
+		for (j = left; j <= right; j++) {
+			w = kernel(((double) j - center) / fscale);
+			idx = (j < 0) ? 0 : ((j > srcn - 1) ? srcn - 1 : j);
+			idx -= start;
+			if (idx < 0) idx = 0;
+			if (idx > taps - 1) idx = taps - 1;
+			fw[idx] += w;
+			sum += w;
+		}
+
+		/*
+		* Normalize to fixed point, putting the rounding error on the largest weight 
+		*/
+		wt = table->weights + (size_t) i * taps;
+		isum = 0;
+		maxk = 0;
+		maxw = 0.0;
+		for (k = 0; k < taps; k++) {
+			wt[k] = (Sint16) floor(fw[k] / sum * (1 << ZOOM_FILTER_BITS) + 0.5);
+			isum += wt[k];
+			if (fabs(fw[k]) > maxw) {
+				maxw = fabs(fw[k]);
+				maxk = k;
+			}
+		}
+		wt[maxk] += (Sint16) ((1 << ZOOM_FILTER_BITS) - isum);
+		table->start[i] = start;
+	}
+
+	SDL_free(fw);
+	return (0);
+}
+
+/*!
+\brief Internal check for the smoothing modes of the separable filter.
+*/
+static int _zoomFilterMode(int smooth)
+{
+	smooth &= ~SMOOTHING_PREMULTIPLIED;
+	return ((smooth == SMOOTHING_BICUBIC) || (smooth == SMOOTHING_LANCZOS3)) ? 1 : 0;
+}
+
+/*!
+\brief Internal release of the memory of a filter table.
+*/
+static void _zoomFilterTableFree(_zoomFilterTable *table)
+{
+	SDL_free(table->start);
+	SDL_free(table->weights);
+	table->start = NULL;
+	table->weights = NULL;
+}
+
+/*!
+\brief Internal conversion of a filter sum to an 8bit channel value.
+*/
+static Uint8 _zoomFilterClamp(int acc)
+{
+	acc >>= ZOOM_FILTER_BITS;
+	return (Uint8) ((acc < 0) ? 0 : ((acc > 255) ? 255 : acc));
+}
+
+/*!
+\brief Scalar (reference) horizontal pass kernel.
+*/
+static void _zoomFilterRowH_C(const Uint32 *s, Uint32 *d, int w, const int *start, const Sint16 *weights, int taps)
+{
+	int x, k, a0, a1, a2, a3;
+	const Uint8 *p;
+	Uint8 *dp;
+
+	for (x = 0; x < w; x++) {
+		p = (const Uint8 *) (s + start[x]);
+		a0 = a1 = a2 = a3 = 1 << (ZOOM_FILTER_BITS - 1);
+		for (k = 0; k < taps; k++) {
+			a0 += p[0] * weights[k];
+			a1 += p[1] * weights[k];
+			a2 += p[2] * weights[k];
+			a3 += p[3] * weights[k];
+			p += 4;
+		}
+		dp = (Uint8 *) (d + x);
+		dp[0] = _zoomFilterClamp(a0);
+		dp[1] = _zoomFilterClamp(a1);
+		dp[2] = _zoomFilterClamp(a2);
+		dp[3] = _zoomFilterClamp(a3);
+		weights += taps;
+	}
+}
+
+/*!
+\brief Scalar (reference) vertical pass kernel.
+*/
+static void _zoomFilterRowV_C(const Uint32 *s, int spitch, Uint32 *d, int w, const Sint16 *weights, int taps)
+{
+	int x, k, a0, a1, a2, a3;
+	const Uint8 *p;
+	Uint8 *dp;
+
+	for (x = 0; x < w; x++) {
+		p = (const Uint8 *) (s + x);
+		a0 = a1 = a2 = a3 = 1 << (ZOOM_FILTER_BITS - 1);
+		for (k = 0; k < taps; k++) {
+			a0 += p[0] * weights[k];
+			a1 += p[1] * weights[k];
+			a2 += p[2] * weights[k];
+			a3 += p[3] * weights[k];
+			p += spitch * 4;
+		}
+		dp = (Uint8 *) (d + x);
+		dp[0] = _zoomFilterClamp(a0);
+		dp[1] = _zoomFilterClamp(a1);
+		dp[2] = _zoomFilterClamp(a2);
+		dp[3] = _zoomFilterClamp(a3);
+	}
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 weight pair for _mm_madd_epi16, replicated for four channels.
+*/
+static __m128i _zoomFilterWeights_SSE2(Sint16 w0, Sint16 w1)
+{
+	return _mm_set1_epi32((int) (((Uint32) (Uint16) w1 << 16) | (Uint16) w0));
+}
+
+/*!
+\brief SSE2 horizontal pass kernel (two taps per multiply-add).
+*/
+static void _zoomFilterRowH_SSE2(const Uint32 *s, Uint32 *d, int w, const int *start, const Sint16 *weights, int taps)
+{
+	int x, k;
+	const Uint32 *p;
+	__m128i zero, round, acc, v;
+
+	zero = _mm_setzero_si128();
+	round = _mm_set1_epi32(1 << (ZOOM_FILTER_BITS - 1));
+	for (x = 0; x < w; x++) {
+		p = s + start[x];
+		acc = round;
+		for (k = 0; k + 2 <= taps; k += 2) {
+			/* r0 g0 b0 a0 r1 g1 b1 a1 -> r0 r1 g0 g1 b0 b1 a0 a1 */
+			v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (p + k)), zero);
+			v = _mm_unpacklo_epi16(v, _mm_srli_si128(v, 8));
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(v, _zoomFilterWeights_SSE2(weights[k], weights[k + 1])));
+		}
+		if (k < taps) {
+			v = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) p[k]), zero);
+			v = _mm_unpacklo_epi16(v, zero);
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(v, _zoomFilterWeights_SSE2(weights[k], 0)));
+		}
+		acc = _mm_srai_epi32(acc, ZOOM_FILTER_BITS);
+		acc = _mm_packs_epi32(acc, acc);
+		d[x] = (Uint32) _mm_cvtsi128_si32(_mm_packus_epi16(acc, acc));
+		weights += taps;
+	}
+}
+
+/*!
+\brief SSE2 vertical pass kernel (four pixels and two rows per step).
+*/
+static void _zoomFilterRowV_SSE2(const Uint32 *s, int spitch, Uint32 *d, int w, const Sint16 *weights, int taps)
+{
+	int x, k;
+	const Uint32 *p;
+	__m128i zero, round, wk, a, b, lo, hi, acc0, acc1, acc2, acc3;
+
+	zero = _mm_setzero_si128();
+	round = _mm_set1_epi32(1 << (ZOOM_FILTER_BITS - 1));
+	for (x = 0; x + 4 <= w; x += 4) {
+		acc0 = acc1 = acc2 = acc3 = round;
+		p = s + x;
+		for (k = 0; k < taps; k += 2) {
+			a = _mm_loadu_si128((const __m128i *) p);
+			if (k + 1 < taps) {
+				b = _mm_loadu_si128((const __m128i *) (p + spitch));
+				wk = _zoomFilterWeights_SSE2(weights[k], weights[k + 1]);
+			} else {
+				b = zero;
+				wk = _zoomFilterWeights_SSE2(weights[k], 0);
+			}
+			/* Interleave the two rows per channel */
+			lo = _mm_unpacklo_epi8(a, b);
+			hi = _mm_unpackhi_epi8(a, b);
+			acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), wk));
+			acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), wk));
+			acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), wk));
+			acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), wk));
+			p += 2 * spitch;
+		}
+		acc0 = _mm_packs_epi32(_mm_srai_epi32(acc0, ZOOM_FILTER_BITS), _mm_srai_epi32(acc1, ZOOM_FILTER_BITS));
+		acc2 = _mm_packs_epi32(_mm_srai_epi32(acc2, ZOOM_FILTER_BITS), _mm_srai_epi32(acc3, ZOOM_FILTER_BITS));
+		_mm_storeu_si128((__m128i *) (d + x), _mm_packus_epi16(acc0, acc2));
+	}
+	_zoomFilterRowV_C(s + x, spitch, d + x, w - x, weights, taps);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_AVX2_INTRINSICS
+/*!
+\brief AVX2 vertical pass kernel (eight pixels and two rows per step).
+*/
+static void SDL_TARGETING("avx2") _zoomFilterRowV_AVX2(const Uint32 *s, int spitch, Uint32 *d, int w, const Sint16 *weights, int taps)
+{
+	int x, k;
+	const Uint32 *p;
+	__m256i zero, round, wk, a, b, lo, hi, acc0, acc1, acc2, acc3;
+
+	zero = _mm256_setzero_si256();
+	round = _mm256_set1_epi32(1 << (ZOOM_FILTER_BITS - 1));
+	for (x = 0; x + 8 <= w; x += 8) {
+		acc0 = acc1 = acc2 = acc3 = round;
+		p = s + x;
+		for (k = 0; k < taps; k += 2) {
+			a = _mm256_loadu_si256((const __m256i *) p);
+			if (k + 1 < taps) {
+				b = _mm256_loadu_si256((const __m256i *) (p + spitch));
+				wk = _mm256_set1_epi32((int) (((Uint32) (Uint16) weights[k + 1] << 16) | (Uint16) weights[k]));
+			} else {
+				b = zero;
+				wk = _mm256_set1_epi32((int) (Uint16) weights[k]);
+			}
+			lo = _mm256_unpacklo_epi8(a, b);
+			hi = _mm256_unpackhi_epi8(a, b);
+			acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), wk));
+			acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), wk));
+			acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), wk));
+			acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), wk));
+			p += 2 * spitch;
+		}
+		/* The unpacks and packs work within 128bit lanes and restore the pixel order */
+		acc0 = _mm256_packs_epi32(_mm256_srai_epi32(acc0, ZOOM_FILTER_BITS), _mm256_srai_epi32(acc1, ZOOM_FILTER_BITS));
+		acc2 = _mm256_packs_epi32(_mm256_srai_epi32(acc2, ZOOM_FILTER_BITS), _mm256_srai_epi32(acc3, ZOOM_FILTER_BITS));
+		_mm256_storeu_si256((__m256i *) (d + x), _mm256_packus_epi16(acc0, acc2));
+	}
+	_zoomFilterRowV_C(s + x, spitch, d + x, w - x, weights, taps);
+}
+#endif /* SDL_AVX2_INTRINSICS */
+
+#ifdef SDL_NEON_INTRINSICS
+/*!
+\brief NEON conversion of four channel sums to a 32bit pixel.
+*/
+static Uint32 _zoomFilterPack_NEON(int32x4_t acc)
+{
+	int16x4_t v;
+
+	v = vqmovn_s32(vshrq_n_s32(acc, ZOOM_FILTER_BITS));
+	return vget_lane_u32(vreinterpret_u32_u8(vqmovun_s16(vcombine_s16(v, v))), 0);
+}
+
+/*!
+\brief NEON horizontal pass kernel.
+*/
+static void _zoomFilterRowH_NEON(const Uint32 *s, Uint32 *d, int w, const int *start, const Sint16 *weights, int taps)
+{
+	int x, k;
+	const Uint32 *p;
+	int32x4_t acc;
+	int16x4_t v;
+
+	for (x = 0; x < w; x++) {
+		p = s + start[x];
+		acc = vdupq_n_s32(1 << (ZOOM_FILTER_BITS - 1));
+		for (k = 0; k < taps; k++) {
+			v = vreinterpret_s16_u16(vget_low_u16(vmovl_u8(vcreate_u8((Uint64) p[k]))));
+			acc = vmlal_n_s16(acc, v, weights[k]);
+		}
+		d[x] = _zoomFilterPack_NEON(acc);
+		weights += taps;
+	}
+}
+
+/*!
+\brief NEON vertical pass kernel (four pixels per step).
+*/
+static void _zoomFilterRowV_NEON(const Uint32 *s, int spitch, Uint32 *d, int w, const Sint16 *weights, int taps)
+{
+	int x, k;
+	const Uint32 *p;
+	int32x4_t acc0, acc1, acc2, acc3;
+	uint8x16_t v;
+	int16x8_t lo, hi;
+
+	for (x = 0; x + 4 <= w; x += 4) {
+		acc0 = acc1 = acc2 = acc3 = vdupq_n_s32(1 << (ZOOM_FILTER_BITS - 1));
+		p = s + x;
+		for (k = 0; k < taps; k++) {
+			v = vld1q_u8((const Uint8 *) p);
+			lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(v)));
+			hi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(v)));
+			acc0 = vmlal_n_s16(acc0, vget_low_s16(lo), weights[k]);
+			acc1 = vmlal_n_s16(acc1, vget_high_s16(lo), weights[k]);
+			acc2 = vmlal_n_s16(acc2, vget_low_s16(hi), weights[k]);
+			acc3 = vmlal_n_s16(acc3, vget_high_s16(hi), weights[k]);
+			p += spitch;
+		}
+		d[x] = _zoomFilterPack_NEON(acc0);
+		d[x + 1] = _zoomFilterPack_NEON(acc1);
+		d[x + 2] = _zoomFilterPack_NEON(acc2);
+		d[x + 3] = _zoomFilterPack_NEON(acc3);
+	}
+	_zoomFilterRowV_C(s + x, spitch, d + x, w - x, weights, taps);
+}
+#endif /* SDL_NEON_INTRINSICS */
+
+/*!
+\brief Internal selection of the horizontal pass kernel for the current CPU.
+*/
+static _zoomFilterRowHFunc _zoomFilterRowHKernel(void)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return _zoomFilterRowH_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return _zoomFilterRowH_NEON;
+		}
+#endif
+	}
+	return _zoomFilterRowH_C;
+}
+
+/*!
+\brief Internal selection of the vertical pass kernel for the current CPU.
+*/
+static _zoomFilterRowVFunc _zoomFilterRowVKernel(void)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_AVX2_INTRINSICS
+		if (SDL_HasAVX2()) {
+			return _zoomFilterRowV_AVX2;
+		}
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return _zoomFilterRowV_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return _zoomFilterRowV_NEON;
+		}
+#endif
+	}
+	return _zoomFilterRowV_C;
+}
+
+/*!
+\brief Context of the separable filter passes.
+*/
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	const _zoomFilterTable *htable;
+	const _zoomFilterTable *vtable;
+	Uint32 *tmp;
+	_zoomFilterRowHFunc hkernel;
+	_zoomFilterRowVFunc vkernel;
+	int ashift;
+	SDL_AtomicInt failed;
+} _zoomFilterContext;
+
+/*!
+\brief Internal horizontal pass band; filters source rows ystart to yend-1 into the intermediate buffer.
+
+For premultiplied filtering every source row is premultiplied into a row
+buffer first, so the intermediate buffer holds premultiplied pixels.
+*/
+static void _zoomFilterBandH(void *data, int ystart, int yend)
+{
+	_zoomFilterContext *ctx = (_zoomFilterContext *) data;
+	int x, y;
+	const Uint32 *sp;
+	Uint32 *row = NULL;
+
+	if (ctx->ashift >= 0) {
+		if ((row = (Uint32 *) SDL_malloc((size_t) ctx->src->w * sizeof(Uint32))) == NULL) {
+			SDL_SetAtomicInt(&ctx->failed, 1);
+			return;
+		}
+	}
+
+	for (y = ystart; y < yend; y++) {
+		sp = (const Uint32 *) ((Uint8 *) ctx->src->pixels + y * ctx->src->pitch);
+		if (row != NULL) {
+			for (x = 0; x < ctx->src->w; x++) {
+				row[x] = _premultiplyRGBA(sp[x], ctx->ashift);
+			}
+			sp = row;
+		}
+		ctx->hkernel(sp, ctx->tmp + (size_t) y * ctx->dst->w, ctx->dst->w,
+			ctx->htable->start, ctx->htable->weights, ctx->htable->taps);
+	}
+
+	SDL_free(row);
+}
+
+/*!
+\brief Internal vertical pass band; filters the intermediate buffer into destination rows ystart to yend-1.
+
+For premultiplied filtering the destination rows are converted back to straight alpha.
+*/
+static void _zoomFilterBandV(void *data, int ystart, int yend)
+{
+	_zoomFilterContext *ctx = (_zoomFilterContext *) data;
+	int x, y;
+	Uint32 *dp;
+
+	for (y = ystart; y < yend; y++) {
+		dp = (Uint32 *) ((Uint8 *) ctx->dst->pixels + y * ctx->dst->pitch);
+		ctx->vkernel(ctx->tmp + (size_t) ctx->vtable->start[y] * ctx->dst->w, ctx->dst->w,
+			dp, ctx->dst->w,
+			ctx->vtable->weights + (size_t) y * ctx->vtable->taps, ctx->vtable->taps);
+		if (ctx->ashift >= 0) {
+			for (x = 0; x < ctx->dst->w; x++) {
+				dp[x] = _unpremultiplyRGBA(dp[x], ctx->ashift);
+			}
+		}
+	}
+}
+
+/*!
+\brief Internal execution of the separable filter with precalculated tables.
+
+Filters every source row horizontally into the intermediate buffer, then
+filters the buffer vertically into the destination.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param htable The horizontal filter table (src->w to dst->w).
+\param vtable The vertical filter table (src->h to dst->h).
+\param tmp Intermediate buffer of src->h * dst->w pixels.
+\param smooth The smoothing mode; SMOOTHING_PREMULTIPLIED filters sources with alpha in premultiplied space.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomFilterExecute(SDL_Surface * src, SDL_Surface * dst, const _zoomFilterTable *htable, const _zoomFilterTable *vtable, Uint32 *tmp, int smooth)
+{
+	_zoomFilterContext ctx;
+
+	ctx.src = src;
+	ctx.dst = dst;
+	ctx.htable = htable;
+	ctx.vtable = vtable;
+	ctx.tmp = tmp;
+	ctx.hkernel = _zoomFilterRowHKernel();
+	ctx.vkernel = _zoomFilterRowVKernel();
+	ctx.ashift = _premultiplyShift(src, smooth);
+	SDL_SetAtomicInt(&ctx.failed, 0);
+	_rotozoomParallelFor(src->h, _zoomFilterBandH, &ctx);
+	if (SDL_GetAtomicInt(&ctx.failed)) {
+		return (-1);
+	}
+	_rotozoomParallelFor(dst->h, _zoomFilterBandV, &ctx);
+	return (0);
+}
+
+/*!
+\brief Internal 32 bit Zoomer with bicubic or Lanczos-3 resampling.
+
+Zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface with separable
+horizontal and vertical filter passes.
+Assumes src and dst surfaces are of 32 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param mode SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfaceRGBAFilter(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int mode)
+{
+	_zoomFilterTable htable, vtable;
+	Uint32 *tmp;
+	int result;
+
+	result = -1;
+	tmp = NULL;
+	if (_zoomFilterTableInit(&htable, src->w, dst->w, flipx, mode) != 0) {
+		return (-1);
+	}
+	if (_zoomFilterTableInit(&vtable, src->h, dst->h, flipy, mode) != 0) {
+		_zoomFilterTableFree(&htable);
+		return (-1);
+	}
+	if ((tmp = (Uint32 *) SDL_malloc((size_t) src->h * dst->w * sizeof(Uint32))) != NULL) {
+		result = _zoomFilterExecute(src, dst, &htable, &vtable, tmp, mode);
+	}
+
+	/*
+	* Remove temp arrays 
+	*/
+	SDL_free(tmp);
+	_zoomFilterTableFree(&htable);
+	_zoomFilterTableFree(&vtable);
+
+	return (result);
+}
+
+static int _zoomSurfaceRGBATables(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth, int *tables);
+static int _zoomSurfaceYTables(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int *tables);
+
+/*!
+\brief Context of the 32bit and 8bit zoomer row loops.
+
+'src' may hold a window of the source rows: srcy is the source row held in its
+first row and srch the height of the whole source.
+*/
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	const int *say;
+	const int *ox0;
+	const int *ox1;
+	const int *fx;
+	const int *fy;
+	int flipy;
+	int srcy;
+	int srch;
+	int run;
+	_zoomRowRGBAFunc kernel;
+	_zoomRowRGBAPremulFunc premul;
+	int ashift;
+} _zoomContext;
+
+/*!
+\brief Internal check if a source column table repeats every source column equally often.
+
+\param ox0 The source column of each destination pixel.
+\param w The destination width.
+
+\return The repeat count k if ox0[x] is x / k for all x (1 for a plain copy), 0 otherwise.
+*/
+static int _zoomRunLength(const int *ox0, int w)
+{
+	int x, k;
+
+	k = 0;
+	while ((k < w) && (ox0[k] == 0)) {
+		k++;
+	}
+	if (k == 0) {
+		return 0;
+	}
+	for (x = k; x < w; x++) {
+		if (ox0[x] != x / k) {
+			return 0;
+		}
+	}
+	return k;
+}
+
+/*!
+\brief Internal 32 bit row zoom by pixel replication; every source pixel is written k times.
+*/
+static void _zoomRowReplicate32(const Uint32 *s, Uint32 *d, int w, int k)
+{
+	int x, i;
+	Uint32 p;
+
+	if (k == 1) {
+		memcpy(d, s, (size_t) w * 4);
+		return;
+	}
+	for (x = 0; x + k <= w; x += k) {
+		p = *s++;
+		for (i = 0; i < k; i++) {
+			d[x + i] = p;
+		}
+	}
+	for (; x < w; x++) {
+		d[x] = *s;
+	}
+}
+
+/*!
+\brief Internal 8 bit row zoom by pixel replication; every source pixel is written k times.
+*/
+static void _zoomRowReplicate8(const Uint8 *s, Uint8 *d, int w, int k)
+{
+	int x, i;
+	Uint8 p;
+
+	if (k == 1) {
+		memcpy(d, s, (size_t) w);
+		return;
+	}
+	for (x = 0; x + k <= w; x += k) {
+		p = *s++;
+		for (i = 0; i < k; i++) {
+			d[x + i] = p;
+		}
+	}
+	for (; x < w; x++) {
+		d[x] = *s;
+	}
+}
+
+/*!
+\brief Internal 32 bit zoomer band; zooms destination rows ystart to yend-1.
+
+Uses the premultiplied or the plain interpolating row kernel if one is set,
+otherwise copies the nearest pixels: rows with the same source row as the
+previous one are copied from it and replicating column tables use
+_zoomRowReplicate32().
+
+\param data The _zoomContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _zoomSurfaceRGBABand(void *data, int ystart, int yend)
+{
+	_zoomContext *ctx = (_zoomContext *) data;
+	int x, y, cy, row0, row1, spixelh;
+	Uint8 *sp, *dp;
+	Uint32 *r0, *d;
+
+	sp = (Uint8 *) ctx->src->pixels;
+	dp = (Uint8 *) ctx->dst->pixels;
+	spixelh = ctx->srch - 1;
+	for (y = ystart; y < yend; y++) {
+		cy = ctx->say[y];
+		row0 = (ctx->flipy) ? spixelh - cy : cy;
+		d = (Uint32 *) (dp + (size_t) y * ctx->dst->pitch);
+		if ((ctx->kernel) || (ctx->premul)) {
+			row1 = row0;
+			if (cy < spixelh) {
+				row1 += (ctx->flipy) ? -1 : 1;
+			}
+			if (ctx->premul) {
+				ctx->premul((Uint32 *) (sp + (size_t) (row0 - ctx->srcy) * ctx->src->pitch), (Uint32 *) (sp + (size_t) (row1 - ctx->srcy) * ctx->src->pitch),
+					d, ctx->ox0, ctx->ox1, ctx->fx, ctx->fy[y], ctx->dst->w, ctx->ashift);
+			} else {
+				ctx->kernel((Uint32 *) (sp + (size_t) (row0 - ctx->srcy) * ctx->src->pitch), (Uint32 *) (sp + (size_t) (row1 - ctx->srcy) * ctx->src->pitch),
+					d, ctx->ox0, ctx->ox1, ctx->fx, ctx->fy[y], ctx->dst->w);
+			}
+		} else if ((y > ystart) && (ctx->say[y] == ctx->say[y - 1])) {
+			memcpy(d, (Uint8 *) d - ctx->dst->pitch, (size_t) ctx->dst->w * 4);
+		} else {
+			r0 = (Uint32 *) (sp + (size_t) (row0 - ctx->srcy) * ctx->src->pitch);
+			if (ctx->run > 0) {
+				_zoomRowReplicate32(r0, d, ctx->dst->w, ctx->run);
+				continue;
+			}
+			for (x = 0; x < ctx->dst->w; x++) {
+				d[x] = r0[ctx->ox0[x]];
+			}
+		}
+	}
+}
+
+/*! 
+\brief Internal 32 bit Zoomer with optional anti-aliasing by bilinear interpolation.
+
+Zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface.
+Assumes src and dst surfaces are of 32 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return 0 for success or -1 for error.
+*/
+int _zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
+{
+	return _zoomSurfaceRGBATables(src, dst, flipx, flipy, smooth, NULL);
+}
+
+/*!
+\brief Internal precalculation of the tables of the 32 bit Zoomer.
+
+Fills the source columns (sax) and rows (say), the source columns of the
+left/right neighbours (ox0, ox1) and the horizontal and vertical weights (fx, fy).
+The 16.16 source coordinates are accumulated in 64bit, so sources wider or
+higher than 32767 pixels do not overflow. The tables depend only on the source
+and destination sizes and the flip/smooth flags.
+
+\param srcw The source width.
+\param srch The source height.
+\param dstw The destination width.
+\param dsth The destination height.
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param tables Memory for ZOOM_TABLE_INTS(dstw, dsth) ints.
+*/
+static void _zoomTablesRGBA(int srcw, int srch, int dstw, int dsth, int flipx, int smooth, int *tables)
+{
+	int x, y, *sax, *say, cx;
+	int *ox0, *ox1, *fx, *fy;
+	int spixelw, spixelh;
+	Sint64 sx, sy, ssx, ssy, csx, csy;
+
+	sax = tables;
+	say = sax + dstw + 1;
+	ox0 = say + dsth + 1;
+	ox1 = ox0 + dstw;
+	fx = ox1 + dstw;
+	fy = fx + dstw;
+
+	/*
+	* Precalculate row increments 
+	*/
+	spixelw = (srcw - 1);
+	spixelh = (srch - 1);
+	if (smooth) {
+		sx = (dstw > 1) ? (Sint64) (65536.0 * (float) spixelw / (float) (dstw - 1)) : 0;
+		sy = (dsth > 1) ? (Sint64) (65536.0 * (float) spixelh / (float) (dsth - 1)) : 0;
+	} else {
+		sx = (Sint64) (65536.0 * (float) (srcw) / (float) (dstw));
+		sy = (Sint64) (65536.0 * (float) (srch) / (float) (dsth));
+	}
+
+	/* Maximum scaled source size */
+	ssx = ((Sint64) srcw << 16) - 1;
+	ssy = ((Sint64) srch << 16) - 1;
+
+	/* Precalculate horizontal row increments */
+	csx = 0;
+	for (x = 0; x <= dstw; x++) {
+		sax[x] = (int) (csx >> 16);
+		if (x < dstw) {
+			fx[x] = (int) (csx & 0xffff);
+		}
+		csx += sx;
+
+		/* Guard from overflows */
+		if (csx > ssx) { 
+			csx = ssx; 
+		}
+	}
+
+	/* Precalculate vertical row increments */
+	csy = 0;
+	for (y = 0; y <= dsth; y++) {
+		say[y] = (int) (csy >> 16);
+		fy[y] = (int) (csy & 0xffff);
+		csy += sy;
+
+		/* Guard from overflows */
+		if (csy > ssy) {
+			csy = ssy;
+		}
+	}
+
+	/*
+	* Precalculate source columns of the left/right neighbours
+	*/
+	for (x = 0; x < dstw; x++) {
+		cx = sax[x];
+		ox0[x] = (flipx) ? spixelw - cx : cx;
+		ox1[x] = ox0[x];
+		if (cx < spixelw) {
+			ox1[x] += (flipx) ? -1 : 1;
+		}
+	}
+}
+
+/*!
+\brief Internal check if all horizontal and vertical weights of the 32 bit Zoomer are zero.
+*/
+static int _zoomWholePixels(const int *fx, int w, const int *fy, int h)
+{
+	int i;
+
+	for (i = 0; i < w; i++) {
+		if (fx[i] != 0) {
+			return 0;
+		}
+	}
+	for (i = 0; i < h; i++) {
+		if (fy[i] != 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*!
+\brief Internal execution of the 32 bit Zoomer with precalculated tables.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param tables The tables filled by _zoomTablesRGBA().
+*/
+static void _zoomExecuteRGBA(SDL_Surface * src, SDL_Surface * dst, int flipy, int smooth, const int *tables)
+{
+	_zoomContext ctx;
+
+	/*
+	* Interpolating or non-interpolating zoom, split into bands of rows
+	*/
+	ctx.src = src;
+	ctx.dst = dst;
+	ctx.say = tables + dst->w + 1;
+	ctx.ox0 = ctx.say + dst->h + 1;
+	ctx.ox1 = ctx.ox0 + dst->w;
+	ctx.fx = ctx.ox1 + dst->w;
+	ctx.fy = ctx.fx + dst->w;
+	ctx.flipy = flipy;
+	ctx.srcy = 0;
+	ctx.srch = src->h;
+	ctx.run = _zoomRunLength(ctx.ox0, dst->w);
+	ctx.kernel = (smooth) ? _zoomRowRGBAKernel() : NULL;
+	ctx.ashift = _premultiplyShift(src, smooth);
+	ctx.premul = (ctx.ashift >= 0) ? _zoomRowRGBAPremulKernel() : NULL;
+
+	/*
+	* Without fractional weights the interpolation returns the nearest pixels (unit zoom) 
+	*/
+	if ((ctx.kernel) && (ctx.premul == NULL) && (_zoomWholePixels(ctx.fx, dst->w, ctx.fy, dst->h))) {
+		ctx.kernel = NULL;
+	}
+	_rotozoomParallelFor(dst->h, _zoomSurfaceRGBABand, &ctx);
+}
+
+/*!
+\brief Internal 32 bit Zoomer using caller-provided table memory.
+
+See _zoomSurfaceRGBA().
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; SMOOTHING_BICUBIC and SMOOTHING_LANCZOS3 use _zoomSurfaceRGBAFilter().
+\param tables Memory for ZOOM_TABLE_INTS(dst->w, dst->h) ints or NULL to allocate the tables.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfaceRGBATables(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth, int *tables)
+{
+	int *allocated = NULL;
+
+	if (_zoomFilterMode(smooth)) {
+		return _zoomSurfaceRGBAFilter(src, dst, flipx, flipy, smooth);
+	}
+
+	/*
+	* Allocate memory for row/column increments, column offsets and weights
+	*/
+	if (tables == NULL) {
+		if ((allocated = (int *) SDL_malloc(ZOOM_TABLE_INTS(dst->w, dst->h) * sizeof(int))) == NULL) {
+			return (-1);
+		}
+		tables = allocated;
+	}
+
+	_zoomTablesRGBA(src->w, src->h, dst->w, dst->h, flipx, smooth, tables);
+	_zoomExecuteRGBA(src, dst, flipy, smooth, tables);
+
+	/*
+	* Remove temp arrays 
+	*/
+	SDL_free(allocated);
+
+	return (0);
+}
+
+/*!
+\brief Internal 8 bit zoomer band; zooms destination rows ystart to yend-1.
+
+Rows with the same source row as the previous one are copied from it and
+replicating column tables use _zoomRowReplicate8().
+
+\param data The _zoomContext; say holds source rows and ox0 source columns.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _zoomSurfaceYBand(void *data, int ystart, int yend)
+{
+	_zoomContext *ctx = (_zoomContext *) data;
+	int x, y;
+	Uint8 *sp, *dp;
+
+	for (y = ystart; y < yend; y++) {
+		sp = (Uint8 *) ctx->src->pixels + (size_t) (ctx->say[y] - ctx->srcy) * ctx->src->pitch;
+		dp = (Uint8 *) ctx->dst->pixels + (size_t) y * ctx->dst->pitch;
+		if ((y > ystart) && (ctx->say[y] == ctx->say[y - 1])) {
+			memcpy(dp, dp - ctx->dst->pitch, (size_t) ctx->dst->w);
+		} else if (ctx->run > 0) {
+			_zoomRowReplicate8(sp, dp, ctx->dst->w, ctx->run);
+		} else {
+			for (x = 0; x < ctx->dst->w; x++) {
+				dp[x] = sp[ctx->ox0[x]];
+			}
+		}
+	}
+}
+
+/*! 
+
+\brief Internal 8 bit Zoomer without smoothing.
+
+Zooms 8bit palette/Y 'src' surface to 'dst' surface.
+Assumes src and dst surfaces are of 8 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+
+\return 0 for success or -1 for error.
+*/
+int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+{
+	return _zoomSurfaceYTables(src, dst, flipx, flipy, NULL);
+}
+
+/*!
+\brief Internal precalculation of the source column and row tables of the 8 bit Zoomer.
+
+\param srcw The source width.
+\param srch The source height.
+\param dstw The destination width.
+\param dsth The destination height.
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param tables Memory for ZOOM_TABLE_INTS(dstw, dsth) ints.
+*/
+static void _zoomTablesY(int srcw, int srch, int dstw, int dsth, int flipx, int flipy, int *tables)
+{
+	int x, y, step, col, row;
+	int *sax, *say, *csax, *csay;
+	int csx, csy;
+
+	sax = tables;
+	say = sax + dstw + 1;
+
+	/*
+	* Precalculate source columns and rows 
+	*/
+	csx = 0;
+	col = (flipx) ? srcw - 1 : 0;
+	csax = sax;
+	for (x = 0; x < dstw; x++) {
+		*csax = col;
+		csax++;
+		csx += srcw;
+		step = 0;
+		while (csx >= dstw) {
+			csx -= dstw;
+			step++;
+		}
+		col += (flipx) ? -step : step;
+	}
+	csy = 0;
+	row = (flipy) ? srch - 1 : 0;
+	csay = say;
+	for (y = 0; y < dsth; y++) {
+		*csay = row;
+		csay++;
+		csy += srch;
+		step = 0;
+		while (csy >= dsth) {
+			csy -= dsth;
+			step++;
+		}
+		row += (flipy) ? -step : step;
+	}
+}
+
+/*!
+\brief Internal execution of the 8 bit Zoomer with precalculated tables.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param tables The tables filled by _zoomTablesY().
+*/
+static void _zoomExecuteY(SDL_Surface * src, SDL_Surface * dst, const int *tables)
+{
+	_zoomContext ctx;
+
+	/*
+	* Draw, split into bands of rows 
+	*/
+	ctx.src = src;
+	ctx.dst = dst;
+	ctx.say = tables + dst->w + 1;
+	ctx.ox0 = tables;
+	ctx.srcy = 0;
+	ctx.run = _zoomRunLength(ctx.ox0, dst->w);
+	_rotozoomParallelFor(dst->h, _zoomSurfaceYBand, &ctx);
+}
+
+/*!
+\brief Internal 8 bit Zoomer using caller-provided table memory.
+
+See _zoomSurfaceY().
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param tables Memory for ZOOM_TABLE_INTS(dst->w, dst->h) ints or NULL to allocate the tables.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfaceYTables(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int *tables)
+{
+	int *allocated = NULL;
+
+	/*
+	* Allocate memory for source column/row tables 
+	*/
+	if (tables == NULL) {
+		if ((allocated = (int *) SDL_malloc(ZOOM_TABLE_INTS(dst->w, dst->h) * sizeof(int))) == NULL) {
+			return (-1);
+		}
+		tables = allocated;
+	}
+
+	_zoomTablesY(src->w, src->h, dst->w, dst->h, flipx, flipy, tables);
+	_zoomExecuteY(src, dst, tables);
+
+	/*
+	* Remove temp arrays 
+	*/
+	SDL_free(allocated);
+
+	return (0);
+}
+
+/*!
+\brief Largest source width or height the rotozoomer handles with 16.16 coordinates in int.
+*/
+#define TRANSFORM_SAFE_SIZE	32766
+
+/*!
+\brief Context of the 32bit and 8bit rotozoomer row loops.
+
+The row start coordinates are calculated in 64bit. If 'wide' is set, the
+source is too large for 16.16 coordinates and offsets in int and the spans
+are cut into chunks of at most 'chunk' pixels, each addressed relative to
+its first source pixel; see _transformChunk().
+*/
+typedef struct {
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	int cy;
+	int isin;
+	int icos;
+	Sint64 xd;
+	Sint64 yd;
+	Sint64 ax;
+	Sint64 ay;
+	int lox;
+	int hix;
+	int loy;
+	int hiy;
+	Sint64 base;
+	int colstep;
+	int rowstep;
+	int wide;
+	int chunk;
+	Uint32 background;
+	_transformRowRGBAFunc kernel;
+	_transformRowRGBAPremulFunc premul;
+	int ashift;
+} _transformContext;
+
+/*!
+\brief Internal floor of the quotient of two 64bit integers.
+*/
+static Sint64 _floorDiv64(Sint64 n, Sint64 d)
+{
+	Sint64 q = n / d;
+
+	if ((n % d != 0) && ((n < 0) != (d < 0))) {
+		q--;
+	}
+	return q;
+}
+
+/*!
+\brief Internal clipping of a destination span against one source axis.
+
+Narrows the span [x0, x1) to the destination pixels x for which the integer
+part of the 16.16 source coordinate sd + x * step lies in [lo, hi].
+
+\param sd The source coordinate of destination pixel 0.
+\param step The source coordinate increment per destination pixel.
+\param lo The lowest allowed integer source coordinate.
+\param hi The highest allowed integer source coordinate.
+\param x0 Pointer to the first pixel of the span.
+\param x1 Pointer to the pixel after the last one of the span.
+*/
+static void _transformClipSpan(Sint64 sd, int step, int lo, int hi, int *x0, int *x1)
+{
+	Sint64 l, h, xmin, xmax;
+
+	if (lo > hi) {
+		*x1 = *x0;
+		return;
+	}
+	l = (Sint64) lo * 65536 - sd;
+	h = (Sint64) hi * 65536 + 65535 - sd;
+	if (step == 0) {
+		if ((l > 0) || (h < 0)) {
+			*x1 = *x0;
+		}
+		return;
+	}
+	if (step > 0) {
+		xmin = -_floorDiv64(-l, step);
+		xmax = _floorDiv64(h, step);
+	} else {
+		xmin = -_floorDiv64(-h, step);
+		xmax = _floorDiv64(l, step);
+	}
+	if (xmin > *x0) {
+		*x0 = (xmin < *x1) ? (int) xmin : *x1;
+	}
+	if (xmax + 1 < *x1) {
+		*x1 = (xmax + 1 > *x0) ? (int) (xmax + 1) : *x0;
+	}
+}
+
+/*!
+\brief Internal setup of the row independent parts of a rotozoomer context for a window of rows.
+
+Calculates the source start point, the allowed integer source coordinates and
+the tap offsets with the mirroring folded in. 'src' holds the source rows from
+srcy on and 'dst' the destination rows from dsty on of a transform of a srch
+rows high source into a dsth rows high destination; both have the full width.
+
+\param ctx The context to set up.
+\param src Source surface (window).
+\param dst Destination surface (window).
+\param srch The height of the whole source.
+\param dsth The height of the whole destination.
+\param srcy The source row held in the first row of 'src'.
+\param dsty The destination row held in the first row of 'dst'.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param smooth Flag indicating the 2x2 footprint of anti-aliasing must be inside the source.
+*/
+static void _transformSetupWindow(_transformContext *ctx, SDL_Surface * src, SDL_Surface * dst, int srch, int dsth, int srcy, int dsty,
+	int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	int spitch, cstep, bx, by, step, range;
+	Sint64 chunk;
+
+	ctx->src = src;
+	ctx->dst = dst;
+	ctx->cy = cy - dsty;
+	ctx->isin = isin;
+	ctx->icos = icos;
+	ctx->xd = (Sint64) (src->w - dst->w) * 32768;
+	ctx->yd = (Sint64) (srch - dsth) * 32768;
+	ctx->ax = (Sint64) cx * 65536 - (Sint64) icos * cx;
+	ctx->ay = (Sint64) cy * 65536 - (Sint64) isin * cx;
+
+	/* 32bit sources are addressed in pixels, all others in bytes */
+	if (SDL_BYTESPERPIXEL(src->format) == 4) {
+		spitch = src->pitch / 4;
+		cstep = 1;
+	} else {
+		spitch = src->pitch;
+		cstep = SDL_BYTESPERPIXEL(src->format);
+	}
+	if (smooth) {
+		/*
+		* The mirrored top left tap of integer position x is (w - 1) - x + 1 
+		*/
+		ctx->lox = (flipx) ? 1 : 0;
+		ctx->hix = (flipx) ? src->w - 1 : src->w - 2;
+		ctx->loy = (flipy) ? 1 : 0;
+		ctx->hiy = (flipy) ? srch - 1 : srch - 2;
+		bx = (flipx) ? src->w : 0;
+		by = (flipy) ? srch : 0;
+	} else {
+		ctx->lox = 0;
+		ctx->hix = src->w - 1;
+		ctx->loy = 0;
+		ctx->hiy = srch - 1;
+		bx = (flipx) ? src->w - 1 : 0;
+		by = (flipy) ? srch - 1 : 0;
+	}
+	ctx->colstep = (flipx) ? -cstep : cstep;
+	ctx->rowstep = (flipy) ? -spitch : spitch;
+	ctx->base = (Sint64) (by - srcy) * spitch + (Sint64) bx * cstep;
+
+	/*
+	* Large sources need the chunked path; a chunk may move at most 'range' source pixels on each axis 
+	*/
+	ctx->wide = ((src->w > TRANSFORM_SAFE_SIZE) || (srch > TRANSFORM_SAFE_SIZE) ||
+		((Sint64) (srch + 1) * spitch + (Sint64) (src->w + 1) * cstep > SDL_MAX_SINT32)) ? 1 : 0;
+	range = SDL_MAX_SINT32 / (spitch + cstep) - 2;
+	if (range > TRANSFORM_SAFE_SIZE) {
+		range = TRANSFORM_SAFE_SIZE;
+	}
+	step = SDL_max(SDL_abs(icos), SDL_abs(isin));
+	chunk = (step > 0) ? (Sint64) SDL_max(range, 1) * 65536 / step : SDL_MAX_SINT32;
+	ctx->chunk = (int) SDL_clamp(chunk, 1, SDL_MAX_SINT32);
+}
+
+/*!
+\brief Internal setup of the row independent parts of the rotozoomer context.
+
+See _transformSetupWindow(); 'src' and 'dst' hold the whole images.
+*/
+static void _transformSetup(_transformContext *ctx, SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	_transformSetupWindow(ctx, src, dst, src->h, dst->h, 0, 0, cx, cy, isin, icos, flipx, flipy, smooth);
+}
+
+/*!
+\brief Internal calculation of the source start point and the in-bounds span of a destination row.
+
+\param ctx The rotozoomer context.
+\param y The destination row.
+\param sdx Pointer to store the 16.16 horizontal source coordinate of pixel 0.
+\param sdy Pointer to store the 16.16 vertical source coordinate of pixel 0.
+\param x0 Pointer to store the first pixel of the span.
+\param x1 Pointer to store the pixel after the last one of the span.
+*/
+static void _transformRowSpan(_transformContext *ctx, int y, Sint64 *sdx, Sint64 *sdy, int *x0, int *x1)
+{
+	int dy;
+
+	dy = ctx->cy - y;
+	*sdx = (ctx->ax + ((Sint64) ctx->isin * dy)) + ctx->xd;
+	*sdy = (ctx->ay - ((Sint64) ctx->icos * dy)) + ctx->yd;
+	*x0 = 0;
+	*x1 = ctx->dst->w;
+	_transformClipSpan(*sdx, ctx->icos, ctx->lox, ctx->hix, x0, x1);
+	_transformClipSpan(*sdy, ctx->isin, ctx->loy, ctx->hiy, x0, x1);
+}
+
+/*!
+\brief Internal narrowing of the next chunk of an in-bounds span to int coordinates.
+
+Without the wide path the whole span is one chunk, addressed as before with
+ctx->base. Otherwise the chunk is at most ctx->chunk pixels long and addressed
+relative to the source pixel of its first destination pixel, so its 16.16
+coordinates and source offsets fit in int. The 64bit coordinates are advanced
+past the chunk.
+
+\param ctx The rotozoomer context.
+\param sdx Pointer to the 16.16 horizontal source coordinate of the first pixel.
+\param sdy Pointer to the 16.16 vertical source coordinate of the first pixel.
+\param w Number of pixels left in the span.
+\param offset Pointer to store the source offset of the chunk.
+\param base Pointer to store the base of the chunk, relative to offset.
+\param csdx Pointer to store the int horizontal source coordinate of the first pixel.
+\param csdy Pointer to store the int vertical source coordinate of the first pixel.
+
+\return The number of pixels of the chunk.
+*/
+static int _transformChunk(_transformContext *ctx, Sint64 *sdx, Sint64 *sdy, int w, ptrdiff_t *offset, int *base, int *csdx, int *csdy)
+{
+	Sint64 ix, iy;
+
+	if (!ctx->wide) {
+		*offset = 0;
+		*base = (int) ctx->base;
+		*csdx = (int) *sdx;
+		*csdy = (int) *sdy;
+		return w;
+	}
+	if (w > ctx->chunk) {
+		w = ctx->chunk;
+	}
+	ix = *sdx >> 16;
+	iy = *sdy >> 16;
+	*offset = (ptrdiff_t) (ctx->base + iy * ctx->rowstep + ix * ctx->colstep);
+	*base = 0;
+	*csdx = (int) (*sdx & 0xffff);
+	*csdy = (int) (*sdy & 0xffff);
+	*sdx += (Sint64) w * ctx->icos;
+	*sdy += (Sint64) w * ctx->isin;
+	return w;
+}
+
+/*!
+\brief Internal 32 bit rotozoomer band; transforms destination rows ystart to yend-1.
+
+Uses the interpolating span kernel if one is set, otherwise copies the nearest pixels.
+
+\param data The _transformContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _transformSurfaceRGBABand(void *data, int ystart, int yend)
+{
+	_transformContext *ctx = (_transformContext *) data;
+	int x, y, x0, x1, n, i, base, csdx, csdy;
+	Sint64 sdx, sdy;
+	ptrdiff_t offset;
+	const Uint32 *sp;
+	Uint32 *pc;
+
+	for (y = ystart; y < yend; y++) {
+		_transformRowSpan(ctx, y, &sdx, &sdy, &x0, &x1);
+		pc = (Uint32 *) ((Uint8 *) ctx->dst->pixels + (size_t) y * ctx->dst->pitch);
+
+		/*
+		* Clear the parts of the row outside the source 
+		*/
+		memset(pc, 0, x0 * 4);
+		memset(pc + x1, 0, (ctx->dst->w - x1) * 4);
+
+		sdx += (Sint64) x0 * ctx->icos;
+		sdy += (Sint64) x0 * ctx->isin;
+		for (x = x0; x < x1; x += n) {
+			n = _transformChunk(ctx, &sdx, &sdy, x1 - x, &offset, &base, &csdx, &csdy);
+			sp = (const Uint32 *) ctx->src->pixels + offset;
+			if (ctx->premul) {
+				ctx->premul(sp, base, ctx->colstep, ctx->rowstep, pc + x, n, csdx, csdy, ctx->icos, ctx->isin, ctx->ashift);
+				continue;
+			}
+			if (ctx->kernel) {
+				ctx->kernel(sp, base, ctx->colstep, ctx->rowstep, pc + x, n, csdx, csdy, ctx->icos, ctx->isin);
+				continue;
+			}
+			for (i = 0; i < n; i++) {
+				pc[x + i] = sp[base + (csdy >> 16) * ctx->rowstep + (csdx >> 16) * ctx->colstep];
+				csdx = (int) ((Uint32) csdx + (Uint32) ctx->icos);
+				csdy = (int) ((Uint32) csdy + (Uint32) ctx->isin);
+			}
+		}
+	}
+}
+
+/*! 
+\brief Internal 32 bit rotozoomer with optional anti-aliasing.
+
+Rotates and zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control 
+parameters by scanning the destination surface and applying optionally anti-aliasing
+by bilinear interpolation. The in-bounds span of each row is calculated up front;
+pixels outside the source are cleared to 0.
+Assumes src and dst surfaces are of 32 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param smooth Flag indicating anti-aliasing should be used; SMOOTHING_PREMULTIPLIED interpolates in premultiplied space.
+*/
+void _transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	_transformContext ctx;
+
+	/*
+	* Variable setup 
+	*/
+	_transformSetup(&ctx, src, dst, cx, cy, isin, icos, flipx, flipy, smooth);
+
+	/*
+	* Interpolating or non-interpolating transform, split into bands of rows
+	*/
+	ctx.kernel = (smooth) ? _transformRowRGBAKernel() : NULL;
+	ctx.ashift = _premultiplyShift(src, smooth);
+	ctx.premul = (ctx.ashift >= 0) ? _transformRowRGBAPremulKernel() : NULL;
+	_rotozoomParallelFor(dst->h, _transformSurfaceRGBABand, &ctx);
+}
+
+/*!
+\brief Internal 8 bit rotozoomer band; transforms destination rows ystart to yend-1.
+
+\param data The _transformContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _transformSurfaceYBand(void *data, int ystart, int yend)
+{
+	_transformContext *ctx = (_transformContext *) data;
+	int x, y, x0, x1, n, i, base, csdx, csdy;
+	Sint64 sdx, sdy;
+	ptrdiff_t offset;
+	const Uint8 *sp;
+	Uint8 *pc;
+
+	for (y = ystart; y < yend; y++) {
+		_transformRowSpan(ctx, y, &sdx, &sdy, &x0, &x1);
+		pc = (Uint8 *) ctx->dst->pixels + (size_t) y * ctx->dst->pitch;
+
+		/*
+		* Fill the parts of the row outside the source with the colorkey 
+		*/
+		memset(pc, (int) ctx->background, x0);
+		memset(pc + x1, (int) ctx->background, ctx->dst->w - x1);
+
+		sdx += (Sint64) x0 * ctx->icos;
+		sdy += (Sint64) x0 * ctx->isin;
+		for (x = x0; x < x1; x += n) {
+			n = _transformChunk(ctx, &sdx, &sdy, x1 - x, &offset, &base, &csdx, &csdy);
+			sp = (const Uint8 *) ctx->src->pixels + offset;
+			for (i = 0; i < n; i++) {
+				pc[x + i] = sp[base + (csdy >> 16) * ctx->rowstep + (csdx >> 16) * ctx->colstep];
+				csdx = (int) ((Uint32) csdx + (Uint32) ctx->icos);
+				csdy = (int) ((Uint32) csdy + (Uint32) ctx->isin);
+			}
+		}
+	}
+}
+
+/*!
+
+\brief Rotates and zooms 8 bit palette/Y 'src' surface to 'dst' surface without smoothing.
+
+Rotates and zooms 8 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control 
+parameters by scanning the destination surface. Pixels outside the source are set
+to the colorkey of the source.
+Assumes src and dst surfaces are of 8 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+*/
+void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy)
+{
+	_transformContext ctx;
+
+	/*
+	* Variable setup 
+	*/
+	_transformSetup(&ctx, src, dst, cx, cy, isin, icos, flipx, flipy, 0);
+	ctx.background = _colorkey(src) & 0xff;
+
+	/*
+	* Iterate through destination surface, split into bands of rows 
+	*/
+	_rotozoomParallelFor(dst->h, _transformSurfaceYBand, &ctx);
+}
+
+/* ---- 16bit and 24bit pixels */
+
+/*!
+\brief Channel layout of 16bit and 24bit pixels.
+
+24bit pixels are handled as three byte channels in memory order, so RGB24 and
+BGR24 share one layout; 16bit pixels use the channel masks of their format.
+*/
+typedef struct {
+	int bpp;
+	int channels;
+	Uint32 mask[4];
+	int shift[4];
+} _pixelLayout;
+
+/*!
+\brief Internal check for formats with native 16bit or 24bit kernels.
+
+\param format The pixel format.
+
+\return 1 for packed 16bit and 24bit RGB(A) formats, 0 otherwise.
+*/
+static int _rotozoomNativeFormat(SDL_PixelFormat format)
+{
+	const SDL_PixelFormatDetails* details;
+
+	if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+		return 0;
+	}
+	details = SDL_GetPixelFormatDetails(format);
+	if (details == NULL) {
+		return 0;
+	}
+	return ((details->bytes_per_pixel == 2) || (details->bytes_per_pixel == 3)) ? 1 : 0;
+}
+
+/*!
+\brief Internal check if a smoothing mode is supported by the native 16bit and 24bit kernels.
+
+\param format The pixel format of the source.
+\param smooth The smoothing mode and flags.
+
+\return 0 for the separable filters and for premultiplied smoothing of sources with alpha, 1 otherwise.
+*/
+static int _rotozoomNativeSmooth(SDL_PixelFormat format, int smooth)
+{
+	if (_zoomFilterMode(smooth)) {
+		return 0;
+	}
+	if ((smooth & SMOOTHING_PREMULTIPLIED) && (SDL_ISPIXELFORMAT_ALPHA(format))) {
+		return 0;
+	}
+	return 1;
+}
+
+/*!
+\brief Internal setup of the channel layout of a native 16bit or 24bit format.
+*/
+static void _pixelLayoutInit(_pixelLayout *layout, SDL_PixelFormat format)
+{
+	const SDL_PixelFormatDetails* details;
+	Uint32 masks[4];
+	int shifts[4], i;
+
+	details = SDL_GetPixelFormatDetails(format);
+	layout->bpp = details->bytes_per_pixel;
+	layout->channels = 0;
+	if (layout->bpp == 3) {
+		for (i = 0; i < 3; i++) {
+			layout->mask[i] = 0xffu << (8 * i);
+			layout->shift[i] = 8 * i;
+		}
+		layout->channels = 3;
+		return;
+	}
+	masks[0] = details->Rmask;
+	masks[1] = details->Gmask;
+	masks[2] = details->Bmask;
+	masks[3] = details->Amask;
+	shifts[0] = details->Rshift;
+	shifts[1] = details->Gshift;
+	shifts[2] = details->Bshift;
+	shifts[3] = details->Ashift;
+	for (i = 0; i < 4; i++) {
+		if (masks[i] != 0) {
+			layout->mask[layout->channels] = masks[i];
+			layout->shift[layout->channels] = shifts[i];
+			layout->channels++;
+		}
+	}
+}
+
+/*!
+\brief Internal read of a 16bit or 24bit pixel (24bit pixels in memory order).
+*/
+static Uint32 _getPixelN(const Uint8 *p, int bpp)
+{
+	if (bpp == 2) {
+		return *(const Uint16 *) p;
+	}
+	return (Uint32) p[0] | ((Uint32) p[1] << 8) | ((Uint32) p[2] << 16);
+}
+
+/*!
+\brief Internal write of a 16bit or 24bit pixel (24bit pixels in memory order).
+*/
+static void _putPixelN(Uint8 *p, int bpp, Uint32 v)
+{
+	if (bpp == 2) {
+		*(Uint16 *) p = (Uint16) v;
+		return;
+	}
+	p[0] = (Uint8) v;
+	p[1] = (Uint8) (v >> 8);
+	p[2] = (Uint8) (v >> 16);
+}
+
+/*!
+\brief Internal copy of a 16bit or 24bit pixel.
+*/
+static void _copyPixelN(Uint8 *d, const Uint8 *s, int bpp)
+{
+	if (bpp == 2) {
+		*(Uint16 *) d = *(const Uint16 *) s;
+		return;
+	}
+	d[0] = s[0];
+	d[1] = s[1];
+	d[2] = s[2];
+}
+
+/*!
+\brief Internal bilinear interpolation of one 16bit or 24bit pixel.
+
+Uses the math of _interpolateRGBA() on every channel in its native bit width.
+
+\param c00 Top left source pixel.
+\param c01 Top right source pixel.
+\param c10 Bottom left source pixel.
+\param c11 Bottom right source pixel.
+\param ex Horizontal weight (16bit fraction).
+\param ey Vertical weight (16bit fraction).
+\param layout The channel layout of the pixels.
+
+\return The interpolated pixel.
+*/
+static Uint32 _interpolateN(Uint32 c00, Uint32 c01, Uint32 c10, Uint32 c11, int ex, int ey, const _pixelLayout *layout)
+{
+	Uint32 result, mask;
+	int i, shift, max, p00, p01, p10, p11, t1, t2;
+
+	result = 0;
+	for (i = 0; i < layout->channels; i++) {
+		mask = layout->mask[i];
+		shift = layout->shift[i];
+		max = (int) (mask >> shift);
+		p00 = (int) ((c00 & mask) >> shift);
+		p01 = (int) ((c01 & mask) >> shift);
+		p10 = (int) ((c10 & mask) >> shift);
+		p11 = (int) ((c11 & mask) >> shift);
+		t1 = ((((p01 - p00) * ex) >> 16) + p00) & max;
+		t2 = ((((p11 - p10) * ex) >> 16) + p10) & max;
+		result |= ((Uint32) (((((t2 - t1) * ey) >> 16) + t1) & max) << shift);
+	}
+	return result;
+}
+
+/*!
+\brief Internal 16bit and 24bit row zoom by pixel replication; every source pixel is written k times.
+*/
+static void _zoomRowReplicateN(const Uint8 *s, Uint8 *d, int w, int k, int bpp)
+{
+	int x, i;
+
+	if (k == 1) {
+		memcpy(d, s, (size_t) w * bpp);
+		return;
+	}
+	for (x = 0; x + k <= w; x += k) {
+		for (i = 0; i < k; i++) {
+			_copyPixelN(d + (x + i) * bpp, s, bpp);
+		}
+		s += bpp;
+	}
+	for (; x < w; x++) {
+		_copyPixelN(d + x * bpp, s, bpp);
+	}
+}
+
+/*!
+\brief Context of the 16bit and 24bit zoomer row loops.
+*/
+typedef struct {
+	_zoomContext zoom;
+	_pixelLayout layout;
+	int smooth;
+} _zoomNContext;
+
+/*!
+\brief Internal 16bit and 24bit zoomer band; zooms destination rows ystart to yend-1.
+
+Interpolates if smoothing is set, otherwise copies the nearest pixels like
+_zoomSurfaceRGBABand(): rows with the same source row as the previous one are
+copied from it and replicating column tables use _zoomRowReplicateN().
+
+\param data The _zoomNContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _zoomSurfaceNBand(void *data, int ystart, int yend)
+{
+	_zoomNContext *nctx = (_zoomNContext *) data;
+	_zoomContext *ctx = &nctx->zoom;
+	int x, y, cy, row0, row1, spixelh, bpp, fy;
+	const Uint8 *r0, *r1;
+	Uint8 *d;
+
+	bpp = nctx->layout.bpp;
+	spixelh = ctx->srch - 1;
+	for (y = ystart; y < yend; y++) {
+		cy = ctx->say[y];
+		row0 = (ctx->flipy) ? spixelh - cy : cy;
+		r0 = (const Uint8 *) ctx->src->pixels + (size_t) (row0 - ctx->srcy) * ctx->src->pitch;
+		d = (Uint8 *) ctx->dst->pixels + (size_t) y * ctx->dst->pitch;
+		if (nctx->smooth) {
+			row1 = row0;
+			if (cy < spixelh) {
+				row1 += (ctx->flipy) ? -1 : 1;
+			}
+			r1 = (const Uint8 *) ctx->src->pixels + (size_t) (row1 - ctx->srcy) * ctx->src->pitch;
+			fy = ctx->fy[y];
+			for (x = 0; x < ctx->dst->w; x++) {
+				_putPixelN(d + x * bpp, bpp, _interpolateN(
+					_getPixelN(r0 + ctx->ox0[x] * bpp, bpp), _getPixelN(r0 + ctx->ox1[x] * bpp, bpp),
+					_getPixelN(r1 + ctx->ox0[x] * bpp, bpp), _getPixelN(r1 + ctx->ox1[x] * bpp, bpp),
+					ctx->fx[x], fy, &nctx->layout));
+			}
+		} else if ((y > ystart) && (ctx->say[y] == ctx->say[y - 1])) {
+			memcpy(d, d - ctx->dst->pitch, (size_t) ctx->dst->w * bpp);
+		} else if (ctx->run > 0) {
+			_zoomRowReplicateN(r0, d, ctx->dst->w, ctx->run, bpp);
+		} else {
+			for (x = 0; x < ctx->dst->w; x++) {
+				_copyPixelN(d + x * bpp, r0 + ctx->ox0[x] * bpp, bpp);
+			}
+		}
+	}
+}
+
+/*!
+\brief Internal execution of the 16bit and 24bit Zoomer with precalculated tables.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param tables The tables filled by _zoomTablesRGBA().
+*/
+static void _zoomExecuteN(SDL_Surface * src, SDL_Surface * dst, int flipy, int smooth, const int *tables)
+{
+	_zoomNContext ctx;
+
+	ctx.zoom.src = src;
+	ctx.zoom.dst = dst;
+	ctx.zoom.say = tables + dst->w + 1;
+	ctx.zoom.ox0 = ctx.zoom.say + dst->h + 1;
+	ctx.zoom.ox1 = ctx.zoom.ox0 + dst->w;
+	ctx.zoom.fx = ctx.zoom.ox1 + dst->w;
+	ctx.zoom.fy = ctx.zoom.fx + dst->w;
+	ctx.zoom.flipy = flipy;
+	ctx.zoom.srcy = 0;
+	ctx.zoom.srch = src->h;
+	ctx.zoom.run = _zoomRunLength(ctx.zoom.ox0, dst->w);
+	ctx.zoom.kernel = NULL;
+	_pixelLayoutInit(&ctx.layout, src->format);
+	ctx.smooth = smooth;
+
+	/*
+	* Without fractional weights the interpolation returns the nearest pixels (unit zoom) 
+	*/
+	if ((ctx.smooth) && (_zoomWholePixels(ctx.zoom.fx, dst->w, ctx.zoom.fy, dst->h))) {
+		ctx.smooth = 0;
+	}
+	_rotozoomParallelFor(dst->h, _zoomSurfaceNBand, &ctx);
+}
+
+/*!
+\brief Internal 16bit and 24bit Zoomer with optional anti-aliasing by bilinear interpolation.
+
+Zooms 'src' surface to 'dst' surface of the same native 16bit or 24bit format,
+using the tables of the 32bit Zoomer.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param tables Memory for ZOOM_TABLE_INTS(dst->w, dst->h) ints or NULL to allocate the tables.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfaceNTables(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth, int *tables)
+{
+	int *allocated = NULL;
+
+	if (tables == NULL) {
+		if ((allocated = (int *) SDL_malloc(ZOOM_TABLE_INTS(dst->w, dst->h) * sizeof(int))) == NULL) {
+			return (-1);
+		}
+		tables = allocated;
+	}
+
+	_zoomTablesRGBA(src->w, src->h, dst->w, dst->h, flipx, smooth, tables);
+	_zoomExecuteN(src, dst, flipy, smooth, tables);
+
+	/*
+	* Remove temp arrays 
+	*/
+	SDL_free(allocated);
+
+	return (0);
+}
+
+/*!
+\brief Context of the 16bit and 24bit rotozoomer row loops.
+*/
+typedef struct {
+	_transformContext transform;
+	_pixelLayout layout;
+	int smooth;
+} _transformNContext;
+
+/*!
+\brief Internal 16bit and 24bit rotozoomer band; transforms destination rows ystart to yend-1.
+
+\param data The _transformNContext.
+\param ystart First destination row.
+\param yend Destination row after the last one.
+*/
+static void _transformSurfaceNBand(void *data, int ystart, int yend)
+{
+	_transformNContext *nctx = (_transformNContext *) data;
+	_transformContext *ctx = &nctx->transform;
+	int x, y, x0, x1, n, i, base, csdx, csdy, o, bpp;
+	Sint64 sdx, sdy;
+	ptrdiff_t offset;
+	const Uint8 *sp;
+	Uint8 *pc;
+
+	bpp = nctx->layout.bpp;
+	for (y = ystart; y < yend; y++) {
+		_transformRowSpan(ctx, y, &sdx, &sdy, &x0, &x1);
+		pc = (Uint8 *) ctx->dst->pixels + (size_t) y * ctx->dst->pitch;
+
+		/*
+		* Clear the parts of the row outside the source 
+		*/
+		memset(pc, 0, x0 * bpp);
+		memset(pc + x1 * bpp, 0, (ctx->dst->w - x1) * bpp);
+
+		sdx += (Sint64) x0 * ctx->icos;
+		sdy += (Sint64) x0 * ctx->isin;
+		for (x = x0; x < x1; x += n) {
+			n = _transformChunk(ctx, &sdx, &sdy, x1 - x, &offset, &base, &csdx, &csdy);
+			sp = (const Uint8 *) ctx->src->pixels + offset;
+			for (i = x; i < x + n; i++) {
+				o = base + (csdy >> 16) * ctx->rowstep + (csdx >> 16) * ctx->colstep;
+				if (nctx->smooth) {
+					_putPixelN(pc + i * bpp, bpp, _interpolateN(
+						_getPixelN(sp + o, bpp), _getPixelN(sp + o + ctx->colstep, bpp),
+						_getPixelN(sp + o + ctx->rowstep, bpp), _getPixelN(sp + o + ctx->rowstep + ctx->colstep, bpp),
+						csdx & 0xffff, csdy & 0xffff, &nctx->layout));
+				} else {
+					_copyPixelN(pc + i * bpp, sp + o, bpp);
+				}
+				csdx = (int) ((Uint32) csdx + (Uint32) ctx->icos);
+				csdy = (int) ((Uint32) csdy + (Uint32) ctx->isin);
+			}
+		}
+	}
+}
+
+/*! 
+\brief Internal 16bit and 24bit rotozoomer with optional anti-aliasing.
+
+Like _transformSurfaceRGBA() for 'src' and 'dst' surfaces of the same native
+16bit or 24bit format. Pixels outside the source are cleared to 0.
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param smooth Flag indicating anti-aliasing should be used.
+*/
+static void _transformSurfaceN(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	_transformNContext ctx;
+
+	_transformSetup(&ctx.transform, src, dst, cx, cy, isin, icos, flipx, flipy, smooth);
+	_pixelLayoutInit(&ctx.layout, src->format);
+	ctx.smooth = smooth;
+	_rotozoomParallelFor(dst->h, _transformSurfaceNBand, &ctx);
+}
+
+/*! 
+\brief Internal 16bit and 24bit integer-factor averaging Shrinker.
+
+Shrinks 'src' surface to 'dst' surface of the same native 16bit or 24bit
+format by averaging every channel over the source box.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return 0 for success or -1 for error.
+*/
+static int _shrinkSurfaceN(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+	_pixelLayout layout;
+	int x, y, dx, dy, i, n_average, bpp;
+	int sum[4];
+	Uint32 v, result;
+	const Uint8 *sp;
+	Uint8 *dp;
+
+	_pixelLayoutInit(&layout, src->format);
+	bpp = layout.bpp;
+	n_average = factorx * factory;
+	for (y = 0; y < dst->h; y++) {
+		dp = (Uint8 *) dst->pixels + y * dst->pitch;
+		for (x = 0; x < dst->w; x++) {
+			/* Trace out source box and accumulate */
+			sum[0] = sum[1] = sum[2] = sum[3] = 0;
+			for (dy = 0; dy < factory; dy++) {
+				sp = (const Uint8 *) src->pixels + (y * factory + dy) * src->pitch + x * factorx * bpp;
+				for (dx = 0; dx < factorx; dx++) {
+					v = _getPixelN(sp, bpp);
+					for (i = 0; i < layout.channels; i++) {
+						sum[i] += (int) ((v & layout.mask[i]) >> layout.shift[i]);
+					}
+					sp += bpp;
+				}
+			}
+
+			/* Store result in destination */
+			result = 0;
+			for (i = 0; i < layout.channels; i++) {
+				result |= ((Uint32) (sum[i] / n_average) << layout.shift[i]) & layout.mask[i];
+			}
+			_putPixelN(dp, bpp, result);
+			dp += bpp;
+		}
+	}
+
+	return (0);
+}
+
+/*!
+\brief Edge length in pixels of the tiles of the 90 degree rotator.
+*/
+#define ROTATE90_TILE	16
+
+/*!
+\brief Tile kernel of the 90 degree rotator.
+
+Copies a rows x cols tile from 'sp' to 'dp', where source pixel (r, c) goes to
+dp + c * colstep + r * rowstep (in bytes).
+*/
+typedef void (*_rotate90TileFunc)(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols);
+
+/*!
+\brief Scalar tile kernel of the 90 degree rotator with fixed pixel size.
+
+Walks the tile along destination rows so writes are sequential while the few
+source rows of the tile stay in the cache.
+*/
+static void _rotate90Tile(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols, int bpp)
+{
+	int r, c;
+	const Uint8 *s;
+	Uint8 *d;
+
+	switch (bpp) {
+	case 1:
+		for (c = 0; c < cols; c++) {
+			s = sp + c;
+			d = dp + c * colstep;
+			for (r = 0; r < rows; r++) {
+				*d = *s;
+				s += spitch;
+				d += rowstep;
+			}
+		}
+		break;
+	case 2:
+		for (c = 0; c < cols; c++) {
+			s = sp + 2 * c;
+			d = dp + c * colstep;
+			for (r = 0; r < rows; r++) {
+				*(Uint16 *) d = *(const Uint16 *) s;
+				s += spitch;
+				d += rowstep;
+			}
+		}
+		break;
+	case 3:
+		for (c = 0; c < cols; c++) {
+			s = sp + 3 * c;
+			d = dp + c * colstep;
+			for (r = 0; r < rows; r++) {
+				d[0] = s[0];
+				d[1] = s[1];
+				d[2] = s[2];
+				s += spitch;
+				d += rowstep;
+			}
+		}
+		break;
+	case 4:
+		for (c = 0; c < cols; c++) {
+			s = sp + 4 * c;
+			d = dp + c * colstep;
+			for (r = 0; r < rows; r++) {
+				*(Uint32 *) d = *(const Uint32 *) s;
+				s += spitch;
+				d += rowstep;
+			}
+		}
+		break;
+	}
+}
+
+/*!
+\brief Scalar tile kernel of the 90 degree rotator for 32bit pixels.
+*/
+static void _rotate90Tile32_C(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols)
+{
+	_rotate90Tile(sp, spitch, dp, colstep, rowstep, rows, cols, 4);
+}
+
+/*!
+\brief Internal copy of the tile parts not covered by 4x4 blocks.
+*/
+static void _rotate90TileEdges32(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols)
+{
+	int rb = rows & ~3;
+	int cb = cols & ~3;
+
+	_rotate90Tile(sp + cb * 4, spitch, dp + cb * colstep, colstep, rowstep, rb, cols - cb, 4);
+	_rotate90Tile(sp + rb * spitch, spitch, dp + rb * rowstep, colstep, rowstep, rows - rb, cols, 4);
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*!
+\brief SSE2 tile kernel of the 90 degree rotator for 32bit pixels (4x4 register transposes).
+
+Assumes rowstep is 4 or -4, i.e. a quarter turn.
+*/
+static void _rotate90Tile32_SSE2(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols)
+{
+	int r, c, k;
+	const Uint8 *s;
+	__m128i a, b, e, f, t0, t1, t2, t3, o[4];
+
+	for (r = 0; r + 4 <= rows; r += 4) {
+		for (c = 0; c + 4 <= cols; c += 4) {
+			s = sp + r * spitch + c * 4;
+			a = _mm_loadu_si128((const __m128i *) s);
+			b = _mm_loadu_si128((const __m128i *) (s + spitch));
+			e = _mm_loadu_si128((const __m128i *) (s + 2 * spitch));
+			f = _mm_loadu_si128((const __m128i *) (s + 3 * spitch));
+			t0 = _mm_unpacklo_epi32(a, b);
+			t1 = _mm_unpackhi_epi32(a, b);
+			t2 = _mm_unpacklo_epi32(e, f);
+			t3 = _mm_unpackhi_epi32(e, f);
+			o[0] = _mm_unpacklo_epi64(t0, t2);
+			o[1] = _mm_unpackhi_epi64(t0, t2);
+			o[2] = _mm_unpacklo_epi64(t1, t3);
+			o[3] = _mm_unpackhi_epi64(t1, t3);
+			for (k = 0; k < 4; k++) {
+				if (rowstep < 0) {
+					/* Source rows run right to left in the destination */
+					_mm_storeu_si128((__m128i *) (dp + (c + k) * colstep + (r + 3) * rowstep), _mm_shuffle_epi32(o[k], _MM_SHUFFLE(0, 1, 2, 3)));
+				} else {
+					_mm_storeu_si128((__m128i *) (dp + (c + k) * colstep + r * rowstep), o[k]);
+				}
+			}
+		}
+	}
+	_rotate90TileEdges32(sp, spitch, dp, colstep, rowstep, rows, cols);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_NEON_INTRINSICS
+/*!
+\brief NEON tile kernel of the 90 degree rotator for 32bit pixels (4x4 register transposes).
+
+Assumes rowstep is 4 or -4, i.e. a quarter turn.
+*/
+static void _rotate90Tile32_NEON(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols)
+{
+	int r, c, k;
+	const Uint8 *s;
+	uint32x4x2_t t, u;
+	uint32x4_t o[4];
+
+	for (r = 0; r + 4 <= rows; r += 4) {
+		for (c = 0; c + 4 <= cols; c += 4) {
+			s = sp + r * spitch + c * 4;
+			t = vtrnq_u32(vld1q_u32((const Uint32 *) s), vld1q_u32((const Uint32 *) (s + spitch)));
+			u = vtrnq_u32(vld1q_u32((const Uint32 *) (s + 2 * spitch)), vld1q_u32((const Uint32 *) (s + 3 * spitch)));
+			o[0] = vcombine_u32(vget_low_u32(t.val[0]), vget_low_u32(u.val[0]));
+			o[1] = vcombine_u32(vget_low_u32(t.val[1]), vget_low_u32(u.val[1]));
+			o[2] = vcombine_u32(vget_high_u32(t.val[0]), vget_high_u32(u.val[0]));
+			o[3] = vcombine_u32(vget_high_u32(t.val[1]), vget_high_u32(u.val[1]));
+			for (k = 0; k < 4; k++) {
+				if (rowstep < 0) {
+					o[k] = vrev64q_u32(o[k]);
+					vst1q_u32((Uint32 *) (dp + (c + k) * colstep + (r + 3) * rowstep), vcombine_u32(vget_high_u32(o[k]), vget_low_u32(o[k])));
+				} else {
+					vst1q_u32((Uint32 *) (dp + (c + k) * colstep + r * rowstep), o[k]);
+				}
+			}
+		}
+	}
+	_rotate90TileEdges32(sp, spitch, dp, colstep, rowstep, rows, cols);
+}
+#endif /* SDL_NEON_INTRINSICS */
+
+/*!
+\brief Internal selection of the 32bit quarter turn tile kernel for the current CPU.
+*/
+static _rotate90TileFunc _rotate90Tile32Kernel(void)
+{
+	if (rotozoomSIMDEnabled) {
+#ifdef SDL_SSE2_INTRINSICS
+		if (SDL_HasSSE2()) {
+			return _rotate90Tile32_SSE2;
+		}
+#endif
+#ifdef SDL_NEON_INTRINSICS
+		if (SDL_HasNEON()) {
+			return _rotate90Tile32_NEON;
+		}
+#endif
+	}
+	return _rotate90Tile32_C;
+}
+
+/*!
+\brief Internal tiled copy of a source rectangle into a rotated and/or mirrored destination.
+
+Processes the rectangle in ROTATE90_TILE x ROTATE90_TILE tiles so both the source
+and the destination lines of a tile stay in the cache. Rectangles whose rows
+stay destination rows (plain or mirrored) are copied row by row.
+
+\param sp The top left pixel of the source rectangle.
+\param spitch The pitch of the source.
+\param dp The destination of the top left source pixel.
+\param colstep The destination offset in bytes of the next source column.
+\param rowstep The destination offset in bytes of the next source row.
+\param rows The number of source rows.
+\param cols The number of source columns.
+\param bpp The number of bytes per pixel (1 to 4).
+*/
+static void _rotate90Blocks(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols, int bpp)
+{
+	int r, c, tr, tc;
+	_rotate90TileFunc kernel;
+
+	if ((colstep == bpp) || (colstep == -bpp)) {
+		for (r = 0; r < rows; r++) {
+			if (colstep == bpp) {
+				memcpy(dp + r * rowstep, sp + r * spitch, cols * bpp);
+			} else {
+				_rotate90Tile(sp + r * spitch, spitch, dp + r * rowstep, colstep, rowstep, 1, cols, bpp);
+			}
+		}
+		return;
+	}
+	kernel = ((bpp == 4) && ((rowstep == 4) || (rowstep == -4))) ? _rotate90Tile32Kernel() : NULL;
+
+	for (r = 0; r < rows; r += ROTATE90_TILE) {
+		tr = SDL_min(ROTATE90_TILE, rows - r);
+		for (c = 0; c < cols; c += ROTATE90_TILE) {
+			tc = SDL_min(ROTATE90_TILE, cols - c);
+			if (kernel != NULL) {
+				kernel(sp + r * spitch + c * bpp, spitch, dp + c * colstep + r * rowstep, colstep, rowstep, tr, tc);
+			} else {
+				_rotate90Tile(sp + r * spitch + c * bpp, spitch, dp + c * colstep + r * rowstep, colstep, rowstep, tr, tc, bpp);
+			}
+		}
+	}
+}
+
+/*!
+\brief Context of the tiled copy bands.
+*/
+typedef struct {
+	const Uint8 *sp;
+	int spitch;
+	Uint8 *dp;
+	int colstep;
+	int rowstep;
+	int cols;
+	int bpp;
+} _rotate90Context;
+
+/*!
+\brief Internal tiled copy band; copies source rows ystart to yend-1 of the rectangle.
+
+\param data The _rotate90Context.
+\param ystart First source row.
+\param yend Source row after the last one.
+*/
+static void _rotate90Band(void *data, int ystart, int yend)
+{
+	_rotate90Context *ctx = (_rotate90Context *) data;
+
+	_rotate90Blocks(ctx->sp + ystart * ctx->spitch, ctx->spitch, ctx->dp + ystart * ctx->rowstep,
+		ctx->colstep, ctx->rowstep, yend - ystart, ctx->cols, ctx->bpp);
+}
+
+/*!
+\brief Internal tiled copy of a source rectangle, split into bands of source rows across the thread pool.
+
+See _rotate90Blocks().
+*/
+static void _rotate90Parallel(const Uint8 *sp, int spitch, Uint8 *dp, int colstep, int rowstep, int rows, int cols, int bpp)
+{
+	_rotate90Context ctx;
+
+	ctx.sp = sp;
+	ctx.spitch = spitch;
+	ctx.dp = dp;
+	ctx.colstep = colstep;
+	ctx.rowstep = rowstep;
+	ctx.cols = cols;
+	ctx.bpp = bpp;
+	_rotozoomParallelFor(rows, _rotate90Band, &ctx);
+}
+
+/*!
+\brief Internal tiled rotation of a surface by one to three clockwise quarter turns.
+
+\param src The source surface.
+\param dst The destination surface of the rotated size.
+\param bpp The number of bytes per pixel (1 to 4).
+\param turns The number of clockwise quarter turns (1, 2 or 3).
+*/
+static void _rotate90Tiled(SDL_Surface * src, SDL_Surface * dst, int bpp, int turns)
+{
+	int base, colstep, rowstep;
+
+	/*
+	* Destination offset of source pixel (r, c) is base + c * colstep + r * rowstep 
+	*/
+	switch (turns) {
+	case 1:
+		base = (dst->w - 1) * bpp;
+		colstep = dst->pitch;
+		rowstep = -bpp;
+		break;
+	case 2:
+		base = (dst->h - 1) * dst->pitch + (dst->w - 1) * bpp;
+		colstep = -bpp;
+		rowstep = -dst->pitch;
+		break;
+	default:
+		base = (dst->h - 1) * dst->pitch;
+		colstep = -dst->pitch;
+		rowstep = bpp;
+		break;
+	}
+	_rotate90Parallel((const Uint8 *) src->pixels, src->pitch, (Uint8 *) dst->pixels + base, colstep, rowstep, src->h, src->w, bpp);
+}
+
+/*!
+\brief Internal rotozoomer for quarter turns at unit scale.
+
+If the source steps are whole pixels along the destination axes (rotations by
+multiples of 90 degrees without zoom) and every destination pixel is a copy of
+one source pixel (no smoothing, or smoothing at whole pixel positions), the
+in-bounds rectangle of the destination is copied with the tiled 90 degree
+rotator and the rest is cleared like the scanning rotozoomers do. The result
+is identical to _transformSurfaceRGBA(), _transformSurfaceN() and
+transformSurfaceY().
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param smooth Flag indicating anti-aliasing should be used.
+
+\return 1 if the surface was transformed, 0 if the scanning rotozoomer is needed.
+*/
+static int _transformQuarterTurn(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	_transformContext ctx;
+	int bpp, y, x0, x1, y0, y1, sx0, sx1, w, h, background;
+	int ux, uy, a, b, c, d, sc0, sr0, scmin, srmin, colstep, rowstep;
+	Sint64 sdx, sdy, offset;
+	Uint8 *pc;
+
+	if (!(((isin == 0) && ((icos == 65536) || (icos == -65536))) ||
+		((icos == 0) && ((isin == 65536) || (isin == -65536))))) {
+		return 0;
+	}
+	bpp = SDL_BYTESPERPIXEL(dst->format);
+	if (bpp == 1) {
+		smooth = 0;
+	} else if ((bpp == 4) && (_premultiplyShift(src, smooth) >= 0)) {
+		return 0;
+	}
+	_transformSetup(&ctx, src, dst, cx, cy, isin, icos, flipx, flipy, smooth);
+	if (ctx.wide) {
+		return 0;
+	}
+
+	/*
+	* Bilinear taps at whole pixel positions return the top left pixel 
+	*/
+	if ((smooth) && ((((ctx.ax + ctx.xd) & 0xffff) != 0) || (((ctx.ay + ctx.yd) & 0xffff) != 0))) {
+		return 0;
+	}
+
+	/*
+	* The in-bounds rows are contiguous and share one span 
+	*/
+	y0 = -1;
+	y1 = 0;
+	sx0 = sx1 = 0;
+	for (y = 0; y < dst->h; y++) {
+		_transformRowSpan(&ctx, y, &sdx, &sdy, &x0, &x1);
+		if (x0 < x1) {
+			if (y0 < 0) {
+				y0 = y;
+				sx0 = x0;
+				sx1 = x1;
+			}
+			y1 = y + 1;
+		}
+	}
+
+	/*
+	* Clear the parts outside the source 
+	*/
+	background = (bpp == 1) ? (int) (_colorkey(src) & 0xff) : 0;
+	for (y = 0; y < dst->h; y++) {
+		pc = (Uint8 *) dst->pixels + (size_t) y * dst->pitch;
+		if ((y < y0) || (y >= y1)) {
+			memset(pc, background, (size_t) dst->w * bpp);
+		} else {
+			memset(pc, background, (size_t) sx0 * bpp);
+			memset(pc + (size_t) sx1 * bpp, background, (size_t) (dst->w - sx1) * bpp);
+		}
+	}
+	if (y0 < 0) {
+		return 1;
+	}
+
+	/*
+	* Source pixel of destination (sx0, y0) and the source steps per destination column (a, c) and row (b, d) 
+	*/
+	_transformRowSpan(&ctx, y0, &sdx, &sdy, &x0, &x1);
+	offset = ctx.base + ((sdy + (Sint64) sx0 * isin) >> 16) * ctx.rowstep + ((sdx + (Sint64) sx0 * icos) >> 16) * ctx.colstep;
+	if (bpp == 4) {
+		offset *= 4;
+	}
+	sr0 = (int) (offset / src->pitch);
+	sc0 = (int) ((offset % src->pitch) / bpp);
+	ux = (flipx) ? -1 : 1;
+	uy = (flipy) ? -1 : 1;
+	a = ux * (icos / 65536);
+	c = uy * (isin / 65536);
+	b = -ux * (isin / 65536);
+	d = uy * (icos / 65536);
+
+	/*
+	* Copy the source rectangle; source column and row steps are the transposed destination steps 
+	*/
+	w = sx1 - sx0;
+	h = y1 - y0;
+	scmin = sc0 + SDL_min(0, a * (w - 1)) + SDL_min(0, b * (h - 1));
+	srmin = sr0 + SDL_min(0, c * (w - 1)) + SDL_min(0, d * (h - 1));
+	colstep = a * bpp + b * dst->pitch;
+	rowstep = c * bpp + d * dst->pitch;
+	_rotate90Parallel((const Uint8 *) src->pixels + (size_t) srmin * src->pitch + (size_t) scmin * bpp, src->pitch,
+		(Uint8 *) dst->pixels + (size_t) y0 * dst->pitch + (size_t) sx0 * bpp + (scmin - sc0) * colstep + (srmin - sr0) * rowstep,
+		colstep, rowstep, (c != 0) ? w : h, (a != 0) ? w : h, bpp);
+
+	return 1;
+}
+
+/*!
+\brief Rotates a 8/16/24/32 bit surface in increments of 90 degrees.
+
+Specialized 90 degree rotator which rotates a 'src' surface in 90 degree 
+increments clockwise returning a new surface. Faster than rotozoomer since
+no scanning or interpolation takes place. Input surface must be 8/16/24/32 bit.
+(code contributed by J. Schiller, improved by C. Allport and A. Schiffler)
+
+\param src Source surface to rotate.
+\param numClockwiseTurns Number of clockwise 90 degree turns to apply to the source.
+
+\returns The new, rotated surface; or NULL for surfaces with incorrect input format.
+*/
+SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns) 
+{
+	int row, newWidth, newHeight;
+	int bpp, bpr;
+	SDL_Surface* dst;
+	Uint8* srcBuf;
+	Uint8* dstBuf;
+	int normalizedClockwiseTurns;
+	const SDL_PixelFormatDetails* details;
+
+	/* Has to be a valid surface pointer and be a Nbit surface where n is divisible by 8 */
+	if (!src || 
+	    !src->format) {
+		SDL_SetError("NULL source surface or source surface format");
+	    return NULL; 
+	}
+
+	details = SDL_GetPixelFormatDetails(src->format);
+	if ((details->bits_per_pixel % 8) != 0) {
+		SDL_SetError("Invalid source surface bit depth");
+	    return NULL; 
+	}
+
+	/* normalize numClockwiseTurns */
+	normalizedClockwiseTurns = (numClockwiseTurns % 4);
+	if (normalizedClockwiseTurns < 0) {
+		normalizedClockwiseTurns += 4;
+	}
+
+	/* If turns are even, our new width/height will be the same as the source surface */
+	if (normalizedClockwiseTurns % 2) {
+		newWidth = src->h;
+		newHeight = src->w;
+	} else {
+		newWidth = src->w;
+		newHeight = src->h;
+	}
+
+	dst = SDL_CreateSurface(newWidth, newHeight, src->format);
+	if(!dst) {
+		SDL_SetError("Could not create destination surface"); 
+		return NULL;
+	}
+
+	if (SDL_MUSTLOCK(src)) {
+		SDL_LockSurface(src);
+	}
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_LockSurface(dst);
+	}
+
+	/* Calculate byte-per-pixel */
+	bpp = details->bits_per_pixel / 8;
+
+	switch(normalizedClockwiseTurns) {
+	case 0: /* Make a copy of the surface */
+		{
+			/* Unfortunately SDL_BlitSurface cannot be used to make a copy of the surface
+			since it does not preserve alpha. */
+
+			if (src->pitch == dst->pitch) {
+				/* If the pitch is the same for both surfaces, the memory can be copied all at once. */
+				memcpy(dst->pixels, src->pixels, (src->h * src->pitch));
+			}
+			else
+			{
+				/* If the pitch differs, copy each row separately */
+				srcBuf = (Uint8*)(src->pixels);
+				dstBuf = (Uint8*)(dst->pixels);
+				bpr = src->w * bpp;
+				for (row = 0; row < src->h; row++) {
+					memcpy(dstBuf, srcBuf, bpr);
+					srcBuf += src->pitch;
+					dstBuf += dst->pitch;
+				}
+			}
+		}
+		break;
+
+	default: /* rotated 90, 180 or 270 degrees clockwise */
+		_rotate90Tiled(src, dst, bpp, normalizedClockwiseTurns);
+		break;
+	} 
+	/* end switch */
+
+	if (SDL_MUSTLOCK(src)) {
+		SDL_UnlockSurface(src);
+	}
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+
+	return dst;
+}
+
+
+/*!
+\brief Internal target surface sizing function for rotozooms with trig result return. 
+
+\param width The source surface width.
+\param height The source surface height.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param dstwidth The calculated width of the destination surface.
+\param dstheight The calculated height of the destination surface.
+\param canglezoom The sine of the angle adjusted by the zoom factor.
+\param sanglezoom The cosine of the angle adjusted by the zoom factor.
+
+*/
+void _rotozoomSurfaceSizeTrig(int width, int height, double angle, double zoomx, double zoomy, 
+	int *dstwidth, int *dstheight, 
+	double *canglezoom, double *sanglezoom)
+{
+	double x, y, cx, cy, sx, sy;
+	double radangle;
+	int dstwidthhalf, dstheighthalf;
+
+	/*
+	* Determine destination width and height by rotating a centered source box 
+	*/
+	radangle = angle * (M_PI / 180.0);
+	*sanglezoom = sin(radangle);
+	*canglezoom = cos(radangle);
+	*sanglezoom *= zoomx;
+	*canglezoom *= zoomy;
+	x = (double)(width / 2);
+	y = (double)(height / 2);
+	cx = *canglezoom * x;
+	cy = *canglezoom * y;
+	sx = *sanglezoom * x;
+	sy = *sanglezoom * y;
+
+	dstwidthhalf = MAX((int)
+		ceil(MAX(MAX(MAX(fabs(cx + sy), fabs(cx - sy)), fabs(-cx + sy)), fabs(-cx - sy))), 1);
+	dstheighthalf = MAX((int)
+		ceil(MAX(MAX(MAX(fabs(sx + cy), fabs(sx - cy)), fabs(-sx + cy)), fabs(-sx - cy))), 1);
+	*dstwidth = 2 * dstwidthhalf;
+	*dstheight = 2 * dstheighthalf;
+}
+
+/*! 
+\brief Returns the size of the resulting target surface for a rotozoomSurfaceXY() call. 
+
+\param width The source surface width.
+\param height The source surface height.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param dstwidth The calculated width of the rotozoomed destination surface.
+\param dstheight The calculated height of the rotozoomed destination surface.
+*/
+void rotozoomSurfaceSizeXY(int width, int height, double angle, double zoomx, double zoomy, int *dstwidth, int *dstheight)
+{
+	double dummy_sanglezoom, dummy_canglezoom;
+
+	_rotozoomSurfaceSizeTrig(width, height, angle, zoomx, zoomy, dstwidth, dstheight, &dummy_sanglezoom, &dummy_canglezoom);
+}
+
+/*! 
+\brief Returns the size of the resulting target surface for a rotozoomSurface() call. 
+
+\param width The source surface width.
+\param height The source surface height.
+\param angle The angle to rotate in degrees.
+\param zoom The scaling factor.
+\param dstwidth The calculated width of the rotozoomed destination surface.
+\param dstheight The calculated height of the rotozoomed destination surface.
+*/
+void rotozoomSurfaceSize(int width, int height, double angle, double zoom, int *dstwidth, int *dstheight)
+{
+	double dummy_sanglezoom, dummy_canglezoom;
+
+	_rotozoomSurfaceSizeTrig(width, height, angle, zoom, zoom, dstwidth, dstheight, &dummy_sanglezoom, &dummy_canglezoom);
+}
+
+/*!
+\brief Internal determination of the target surface format for a source surface.
+
+\param src The source surface.
+\param native Flag indicating the operation has native 16bit and 24bit kernels.
+
+\return The source format for 32bit sources and (if native is set) packed 16bit and 24bit sources,
+SDL_PIXELFORMAT_INDEX8 for 8bit sources and SDL_PIXELFORMAT_RGBA32 otherwise.
+*/
+static SDL_PixelFormat _rotozoomTargetFormat(SDL_Surface * src, int native)
+{
+	const SDL_PixelFormatDetails* details;
+
+	details = SDL_GetPixelFormatDetails(src->format);
+	if (details == NULL) {
+		return SDL_PIXELFORMAT_UNKNOWN;
+	}
+	if (details->bits_per_pixel == 32) {
+		return src->format;
+	}
+	if (details->bits_per_pixel == 8) {
+		return SDL_PIXELFORMAT_INDEX8;
+	}
+	if ((native) && (_rotozoomNativeFormat(src->format))) {
+		return src->format;
+	}
+	return SDL_PIXELFORMAT_RGBA32;
+}
+
+/*!
+\brief Internal allocation of a target surface (with added guard rows) for a source surface.
+
+\param src The source surface.
+\param width The width of the target surface.
+\param height The height of the target surface.
+\param native Flag indicating the operation has native 16bit and 24bit kernels.
+
+\return The new target surface or NULL on error.
+*/
+static SDL_Surface *_rotozoomCreateTarget(SDL_Surface * src, int width, int height, int native)
+{
+	SDL_Surface *dst;
+
+	dst = SDL_CreateSurface(width, height + GUARD_ROWS, _rotozoomTargetFormat(src, native));
+	if (dst == NULL) {
+		return NULL;
+	}
+	if (SDL_ISPIXELFORMAT_INDEXED(dst->format)) {
+		SDL_CreateSurfacePalette(dst);
+	}
+
+	/* Adjust for guard rows */
+	dst->h = height;
+
+	return dst;
+}
+
+/*!
+\brief Internal setup of the source and target surfaces of a rotozoom, zoom or shrink operation.
+
+Checks the target surface, converts sources which are not 8bit or 32bit to
+RGBA32 (into the scratch buffer if it is large enough) unless the target has the
+source format, locks the surfaces and
+copies the palette of 8bit sources. The remainder of the scratch buffer is
+handed out as memory for the zoomer tables if it is large enough.
+
+\param src The source surface.
+\param dst The target surface.
+\param dstwidth The expected width of the target surface.
+\param dstheight The expected height of the target surface.
+\param native Flag indicating the operation has native 16bit and 24bit kernels.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+\param rz_src Pointer to store the (possibly converted) source surface.
+\param tables Pointer to store the zoomer table memory or NULL if none is available.
+
+\return 0 for success or -1 for error.
+*/
+static int _rotozoomBegin(SDL_Surface * src, SDL_Surface * dst, int dstwidth, int dstheight, int native,
+	void *scratch, size_t scratchSize, SDL_Surface **rz_src, int **tables)
+{
+	const SDL_PixelFormatDetails* details;
+	SDL_Palette* pal_src;
+	SDL_Palette* pal_dst;
+	Uint8 *free_scratch;
+	size_t size, align;
+	int i;
+
+	*rz_src = NULL;
+	*tables = NULL;
+
+	/*
+	* Sanity check 
+	*/
+	if ((src == NULL) || (dst == NULL) || (dst->pixels == NULL)) {
+		return (-1);
+	}
+	if ((dst->w != dstwidth) || (dst->h != dstheight) || (dst->format != _rotozoomTargetFormat(src, native))) {
+		return (-1);
+	}
+
+	/*
+	* Determine if source surface is 32bit or 8bit 
+	*/
+	free_scratch = (Uint8 *) scratch;
+	details = SDL_GetPixelFormatDetails(src->format);
+	if ((details->bits_per_pixel == 32) || (details->bits_per_pixel == 8) || (dst->format == src->format)) {
+		/*
+		* Use source surface 'as is' 
+		*/
+		*rz_src = src;
+	} else {
+		/*
+		* New source surface is 32bit with a defined RGBA ordering 
+		*/
+		size = (size_t) src->w * 4 * src->h;
+		if ((free_scratch != NULL) && (scratchSize >= size)) {
+			*rz_src = SDL_CreateSurfaceFrom(src->w, src->h, SDL_PIXELFORMAT_RGBA32, free_scratch, src->w * 4);
+			if (*rz_src != NULL) {
+				memset(free_scratch, 0, size);
+			}
+			free_scratch += size;
+			scratchSize -= size;
+		} else {
+			*rz_src = SDL_CreateSurface(src->w, src->h, SDL_PIXELFORMAT_RGBA32);
+		}
+		if (*rz_src == NULL) {
+			return (-1);
+		}
+		SDL_BlitSurface(src, NULL, *rz_src, NULL);
+	}
+
+	/*
+	* Use the rest of the scratch buffer for the zoomer tables 
+	*/
+	if (free_scratch != NULL) {
+		align = (sizeof(int) - ((size_t) free_scratch % sizeof(int))) % sizeof(int);
+		size = ZOOM_TABLE_INTS((size_t) dstwidth, (size_t) dstheight) * sizeof(int);
+		if (scratchSize >= align + size) {
+			*tables = (int *) (free_scratch + align);
+		}
+	}
+
+	/*
+	* Lock source and target surfaces 
+	*/
+	if (SDL_MUSTLOCK(*rz_src)) {
+		if (!SDL_LockSurface(*rz_src)) {
+			if (*rz_src != src) {
+				SDL_DestroySurface(*rz_src);
+			}
+			return (-1);
+		}
+	}
+	if (SDL_MUSTLOCK(dst)) {
+		if (!SDL_LockSurface(dst)) {
+			if (SDL_MUSTLOCK(*rz_src)) {
+				SDL_UnlockSurface(*rz_src);
+			}
+			if (*rz_src != src) {
+				SDL_DestroySurface(*rz_src);
+			}
+			return (-1);
+		}
+	}
+
+	/*
+	* Copy palette and colorkey info 
+	*/
+	if (SDL_ISPIXELFORMAT_INDEXED(dst->format)) {
+		pal_src = SDL_GetSurfacePalette(*rz_src);
+		pal_dst = SDL_GetSurfacePalette(dst);
+		if (pal_dst == NULL) {
+			pal_dst = SDL_CreateSurfacePalette(dst);
+		}
+		if ((pal_src != NULL) && (pal_dst != NULL)) {
+			for (i = 0; i < pal_src->ncolors; i++) {
+				pal_dst->colors[i] = pal_src->colors[i];
+			}
+			pal_dst->ncolors = pal_src->ncolors;
+		}
+	}
+
+	return (0);
+}
+
+/*!
+\brief Internal cleanup after _rotozoomBegin().
+
+\param src The source surface.
+\param rz_src The (possibly converted) source surface.
+\param dst The target surface.
+*/
+static void _rotozoomEnd(SDL_Surface * src, SDL_Surface * rz_src, SDL_Surface * dst)
+{
+	/*
+	* Unlock source and target surfaces 
+	*/
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+	if (SDL_MUSTLOCK(rz_src)) {
+		SDL_UnlockSurface(rz_src);
+	}
+
+	/*
+	* Cleanup temp surface 
+	*/
+	if (rz_src != src) {
+		SDL_DestroySurface(rz_src);
+	}
+}
+
+/*!
+\brief Internal creation of a surface which shares the pixels of a rectangle of a source surface.
+
+The view has the pitch of the source and its palette, colorkey and blend mode,
+so the rotozoom and zoom functions read the rectangle directly from the source.
+Sources with less than 8 bits per pixel can not be addressed bytewise; their
+rectangle is copied into an RGBA32 surface instead. The source stays locked
+until _rotozoomRectEnd() is called.
+
+\param src The source surface.
+\param srcrect The source rectangle, clipped to the surface; NULL for the whole surface.
+
+\return The view, 'src' itself if 'srcrect' is NULL, or NULL on error (including an empty rectangle).
+*/
+static SDL_Surface *_rotozoomRectBegin(SDL_Surface * src, const SDL_Rect * srcrect)
+{
+	SDL_Surface *view;
+	SDL_Rect bounds, rect;
+	SDL_BlendMode blendMode;
+	Uint32 key;
+	Uint8 *pixels;
+
+	if (src == NULL) {
+		return (NULL);
+	}
+	if (srcrect == NULL) {
+		return (src);
+	}
+	bounds.x = 0;
+	bounds.y = 0;
+	bounds.w = src->w;
+	bounds.h = src->h;
+	if (!SDL_GetRectIntersection(srcrect, &bounds, &rect)) {
+		return (NULL);
+	}
+
+	/*
+	* Copy sub-byte pixels into a temporary RGBA surface 
+	*/
+	if (SDL_BITSPERPIXEL(src->format) < 8) {
+		view = SDL_CreateSurface(rect.w, rect.h, SDL_PIXELFORMAT_RGBA32);
+		if (view == NULL) {
+			return (NULL);
+		}
+		SDL_BlitSurface(src, &rect, view, NULL);
+		return (view);
+	}
+
+	/*
+	* Share the pixels of the rectangle 
+	*/
+	if (SDL_MUSTLOCK(src)) {
+		if (!SDL_LockSurface(src)) {
+			return (NULL);
+		}
+	}
+	pixels = (Uint8 *) src->pixels + (size_t) rect.y * src->pitch + (size_t) rect.x * SDL_BYTESPERPIXEL(src->format);
+	view = SDL_CreateSurfaceFrom(rect.w, rect.h, src->format, pixels, src->pitch);
+	if (view == NULL) {
+		if (SDL_MUSTLOCK(src)) {
+			SDL_UnlockSurface(src);
+		}
+		return (NULL);
+	}
+	if (SDL_ISPIXELFORMAT_INDEXED(src->format)) {
+		SDL_SetSurfacePalette(view, SDL_GetSurfacePalette(src));
+	}
+	if (SDL_SurfaceHasColorKey(src)) {
+		key = _colorkey(src);
+		SDL_SetSurfaceColorKey(view, true, key);
+	}
+	if (SDL_GetSurfaceBlendMode(src, &blendMode)) {
+		SDL_SetSurfaceBlendMode(view, blendMode);
+	}
+
+	return (view);
+}
+
+/*!
+\brief Internal cleanup after _rotozoomRectBegin().
+
+\param src The source surface.
+\param view The view returned by _rotozoomRectBegin().
+*/
+static void _rotozoomRectEnd(SDL_Surface * src, SDL_Surface * view)
+{
+	if ((view == NULL) || (view == src)) {
+		return;
+	}
+	SDL_DestroySurface(view);
+	if ((SDL_BITSPERPIXEL(src->format) >= 8) && SDL_MUSTLOCK(src)) {
+		SDL_UnlockSurface(src);
+	}
+}
+
+/*!
+\brief Returns the size of the scratch buffer that lets the *Into() functions run without allocating pixel or table memory.
+
+The scratch buffer holds the RGBA32 copy of sources which are not 8bit or
+32bit and the row/column tables of the zoomer. A converted source still
+allocates its SDL_Surface header (SDL_CreateSurfaceFrom). Not covered are the
+filter tables and intermediate buffer of SMOOTHING_BICUBIC and
+SMOOTHING_LANCZOS3 zooms, which a zoomPlan keeps instead, and the row sums of
+shrinkSurfaceInto() for ratios other than 2x2.
+
+\param src The source surface.
+\param dstwidth The width of the target surface.
+\param dstheight The height of the target surface.
+
+\return The scratch buffer size in bytes.
+*/
+size_t rotozoomSurfaceScratchSize(SDL_Surface * src, int dstwidth, int dstheight)
+{
+	const SDL_PixelFormatDetails* details;
+	size_t size;
+
+	if ((src == NULL) || (dstwidth < 1) || (dstheight < 1)) {
+		return 0;
+	}
+
+	size = ZOOM_TABLE_INTS((size_t) dstwidth, (size_t) dstheight) * sizeof(int) + sizeof(int);
+	details = SDL_GetPixelFormatDetails(src->format);
+	if ((details != NULL) && (details->bits_per_pixel != 32) && (details->bits_per_pixel != 8)) {
+		size += (size_t) src->w * 4 * src->h;
+	}
+	return size;
+}
+
+/*!
+\brief Internal calculation of the target size for a rotozoomSurfaceXY() call.
+
+\param width The source surface width.
+\param height The source surface height.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param dstwidth Pointer to store the target width.
+\param dstheight Pointer to store the target height.
+\param canglezoom Pointer to store the zoomed cosine of the angle.
+\param sanglezoom Pointer to store the zoomed sine of the angle.
+
+\return 1 if the surface is rotated, 0 if it is just zoomed.
+*/
+static int _rotozoomSurfaceXYSize(int width, int height, double angle, double zoomx, double zoomy,
+	int *dstwidth, int *dstheight, double *canglezoom, double *sanglezoom)
+{
+	/*
+	* Sanity check zoom factor 
+	*/
+	if (zoomx < 0.0) zoomx = -zoomx;
+	if (zoomy < 0.0) zoomy = -zoomy;
+	if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
+	if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
+
+	/*
+	* Check if we have a rotozoom or just a zoom 
+	*/
+	if (fabs(angle) > VALUE_LIMIT) {
+		_rotozoomSurfaceSizeTrig(width, height, angle, zoomx, zoomy, dstwidth, dstheight, canglezoom, sanglezoom);
+		return 1;
+	}
+	zoomSurfaceSize(width, height, zoomx, zoomy, dstwidth, dstheight);
+	return 0;
+}
+
+/*!
+\brief Rotates and zooms a surface and optional anti-aliasing. 
+
+Rotates and zoomes a 32bit or 8bit 'src' surface to newly created 'dst' surface.
+'angle' is the rotation in degrees and 'zoom' a scaling factor. If 'smooth' is set
+then the destination 32bit surface is anti-aliased. 16bit and 24bit RGB(A)
+surfaces are rotozoomed in their own format. Other surfaces which are not 8bit
+or 32bit RGBA/ABGR will be converted into a 32bit RGBA format on the fly.
+
+\param src The surface to rotozoom.
+\param angle The angle to rotate in degrees.
+\param zoom The scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return The new rotozoomed surface.
+*/
+SDL_Surface *rotozoomSurface(SDL_Surface * src, double angle, double zoom, int smooth)
+{
+	return rotozoomSurfaceXY(src, angle, zoom, zoom, smooth);
+}
+
+/*!
+\brief Rotates and zooms a surface with different horizontal and vertival scaling factors and optional anti-aliasing. 
+
+Rotates and zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
+'angle' is the rotation in degrees, 'zoomx and 'zoomy' scaling factors. If 'smooth' is set
+then the destination 32bit surface is anti-aliased. SMOOTHING_BICUBIC and
+SMOOTHING_LANCZOS3 apply when the surface is not rotated; rotations use
+bilinear smoothing. 16bit and 24bit RGB(A) surfaces are rotozoomed in their own
+format, except with SMOOTHING_BICUBIC and SMOOTHING_LANCZOS3. Other surfaces
+which are not 8bit or 32bit RGBA/ABGR will be converted into a 32bit RGBA
+format on the fly. Adding SMOOTHING_PREMULTIPLIED to a smoothing mode weights
+the interpolation by alpha, so transparent pixels do not darken the edges
+of the image; the result keeps straight alpha. Sources larger than 32766 pixels
+on a side are rotated in chunks addressed with 64bit coordinates. Rotations
+by multiples of 90 degrees at unit zoom are copied with the tiled 90 degree
+rotator, and unit or integer zooms without rotation copy or replicate whole
+rows; the results are the same as those of the scanning code.
+
+\param src The surface to rotozoom.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return The new rotozoomed surface.
+*/
+SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth)
+{
+	SDL_Surface *rz_dst;
+	int dstwidth, dstheight;
+	double dummy_sanglezoom, dummy_canglezoom;
+
+	/*
+	* Sanity check 
+	*/
+	if (src == NULL) {
+		return (NULL);
+	}
+
+	/*
+	* Alloc space to completely contain the rotated surface 
+	*/
+	_rotozoomSurfaceXYSize(src->w, src->h, angle, zoomx, zoomy, &dstwidth, &dstheight, &dummy_canglezoom, &dummy_sanglezoom);
+	rz_dst = _rotozoomCreateTarget(src, dstwidth, dstheight, _rotozoomNativeSmooth(src->format, smooth));
+	if (rz_dst == NULL) {
+		return (NULL);
+	}
+
+	if (rotozoomSurfaceXYInto(src, rz_dst, angle, zoomx, zoomy, smooth, NULL, 0) != 0) {
+		SDL_DestroySurface(rz_dst);
+		return (NULL);
+	}
+
+	/*
+	* Return destination surface 
+	*/
+	return (rz_dst);
+}
+
+/*!
+\brief Rotates and zooms a surface into an existing target surface.
+
+Like rotozoomSurfaceXY(), but writes into 'dst' instead of allocating a new
+surface. 'dst' must have the size returned by rotozoomSurfaceSizeXY() for
+the absolute zoom factors (or zoomSurfaceSize() if the angle is 0) and the
+format rotozoomSurfaceXY() would use: the source format for 32bit sources and
+natively handled 16bit and 24bit sources, SDL_PIXELFORMAT_INDEX8 for 8bit
+sources and SDL_PIXELFORMAT_RGBA32 otherwise.
+If a scratch buffer of rotozoomSurfaceScratchSize() bytes is passed, only the
+SDL_Surface header of a converted source is allocated, plus the filter tables
+and intermediate buffer when zooming (angle 0) with SMOOTHING_BICUBIC or
+SMOOTHING_LANCZOS3; use a zoomPlan to keep those.
+
+\param src The surface to rotozoom.
+\param dst The target surface.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
+*/
+int rotozoomSurfaceXYInto(SDL_Surface * src, SDL_Surface * dst, double angle, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
+{
+	SDL_Surface *rz_src;
+	int *tables;
+	double zoominv;
+	double sanglezoom, canglezoom, sanglezoominv, canglezoominv;
+	int dstwidth, dstheight, rotate, result;
+	int flipx, flipy;
+
+	/*
+	* Sanity check 
+	*/
+	if (src == NULL) {
+		return (-1);
+	}
+
+	/*
+	* Determine target size 
+	*/
+	rotate = _rotozoomSurfaceXYSize(src->w, src->h, angle, zoomx, zoomy, &dstwidth, &dstheight, &canglezoom, &sanglezoom);
+	if (_rotozoomBegin(src, dst, dstwidth, dstheight, _rotozoomNativeSmooth(src->format, smooth), scratch, scratchSize, &rz_src, &tables) != 0) {
+		return (-1);
+	}
+
+	/*
+	* Sanity check zoom factor 
+	*/
+	flipx = (zoomx<0.0);
+	if (flipx) zoomx=-zoomx;
+	flipy = (zoomy<0.0);
+	if (flipy) zoomy=-zoomy;
+	if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
+	if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
+	zoominv = 65536.0 / (zoomx * zoomx);
+
+	result = 0;
+	if (rotate) {
+		/*
+		* Calculate target factors from sin/cos and zoom 
+		*/
+		sanglezoominv = sanglezoom;
+		canglezoominv = canglezoom;
+		sanglezoominv *= zoominv;
+		canglezoominv *= zoominv;
+
+		/*
+		* Keep the 16.16 steps representable for extreme zoom ratios 
+		*/
+		sanglezoominv = SDL_clamp(sanglezoominv, (double) -SDL_MAX_SINT32, (double) SDL_MAX_SINT32);
+		canglezoominv = SDL_clamp(canglezoominv, (double) -SDL_MAX_SINT32, (double) SDL_MAX_SINT32);
+
+		/*
+		* Check which kind of surface we have 
+		*/
+		if (_transformQuarterTurn(rz_src, dst, dstwidth / 2, dstheight / 2,
+			(int) (sanglezoominv), (int) (canglezoominv), flipx, flipy, smooth)) {
+			/*
+			* Quarter turns at unit scale were copied with the tiled 90 degree rotator 
+			*/
+		} else if (SDL_BYTESPERPIXEL(dst->format) == 4) {
+			/*
+			* Call the 32bit transformation routine to do the rotation (using alpha) 
+			*/
+			_transformSurfaceRGBA(rz_src, dst, dstwidth / 2, dstheight / 2,
+				(int) (sanglezoominv), (int) (canglezoominv), 
+				flipx, flipy,
+				smooth);
+		} else if (SDL_BYTESPERPIXEL(dst->format) > 1) {
+			/*
+			* Call the 16bit/24bit transformation routine to do the rotation 
+			*/
+			_transformSurfaceN(rz_src, dst, dstwidth / 2, dstheight / 2,
+				(int) (sanglezoominv), (int) (canglezoominv), 
+				flipx, flipy,
+				smooth);
+		} else {
+			/*
+			* Call the 8bit transformation routine to do the rotation 
+			*/
+			transformSurfaceY(rz_src, dst, dstwidth / 2, dstheight / 2,
+				(int) (sanglezoominv), (int) (canglezoominv),
+				flipx, flipy);
+		}
+	} else {
+		/*
+		* Check which kind of surface we have 
+		*/
+		if (SDL_BYTESPERPIXEL(dst->format) == 4) {
+			/*
+			* Call the 32bit transformation routine to do the zooming (using alpha) 
+			*/
+			result = _zoomSurfaceRGBATables(rz_src, dst, flipx, flipy, smooth, tables);
+		} else if (SDL_BYTESPERPIXEL(dst->format) > 1) {
+			/*
+			* Call the 16bit/24bit transformation routine to do the zooming 
+			*/
+			result = _zoomSurfaceNTables(rz_src, dst, flipx, flipy, smooth, tables);
+		} else {
+			/*
+			* Call the 8bit transformation routine to do the zooming 
+			*/
+			result = _zoomSurfaceYTables(rz_src, dst, flipx, flipy, tables);
+		}
+	}
+
+	_rotozoomEnd(src, rz_src, dst);
+
+	return (result);
+}
+
+/*!
+\brief Rotates and zooms a surface straight into a streaming texture.
+
+Like rotozoomSurfaceXYInto(), but locks the rectangle of the destination size
+at the top left of 'texture' and writes the result directly into its pixel
+buffer, so neither a temporary surface nor a copy to the texture is needed.
+The texture must have been created with SDL_TEXTUREACCESS_STREAMING, be at least
+as large as the destination and have the format rotozoomSurfaceXY() would return
+(for a 32bit source that is the source format). The part of the texture outside
+the destination rectangle is not changed.
+
+\param src The surface to rotozoom.
+\param texture The streaming texture.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
+*/
+int rotozoomSurfaceXYToTexture(SDL_Surface * src, SDL_Texture * texture, double angle, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
+{
+	SDL_Surface *dst;
+	SDL_Rect rect;
+	double dummy_sanglezoom, dummy_canglezoom;
+	int result;
+
+	/*
+	* Sanity check 
+	*/
+	if ((src == NULL) || (texture == NULL)) {
+		return (-1);
+	}
+
+	/*
+	* Lock the destination rectangle of the texture 
+	*/
+	_rotozoomSurfaceXYSize(src->w, src->h, angle, zoomx, zoomy, &rect.w, &rect.h, &dummy_canglezoom, &dummy_sanglezoom);
+	if ((rect.w > texture->w) || (rect.h > texture->h)) {
+		return (-1);
+	}
+	rect.x = 0;
+	rect.y = 0;
+	if (!SDL_LockTextureToSurface(texture, &rect, &dst)) {
+		return (-1);
+	}
+
+	result = rotozoomSurfaceXYInto(src, dst, angle, zoomx, zoomy, smooth, scratch, scratchSize);
+
+	SDL_UnlockTexture(texture);
+
+	return (result);
+}
+
+/*!
+\brief Rotates and zooms a rectangle of a surface.
+
+Like rotozoomSurfaceXY(), but rotozooms only the 'srcrect' part of 'src',
+reading it in place with the pitch of 'src' instead of cropping it into a
+new surface first. The rectangle is clipped to the surface.
+
+\param src The surface to rotozoom.
+\param srcrect The rectangle of 'src' to rotozoom or NULL for the whole surface.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return The new rotozoomed surface or NULL on error.
+*/
+SDL_Surface *rotozoomSurfaceXYRect(SDL_Surface * src, const SDL_Rect * srcrect, double angle, double zoomx, double zoomy, int smooth)
+{
+	SDL_Surface *view, *rz_dst;
+
+	if ((view = _rotozoomRectBegin(src, srcrect)) == NULL) {
+		return (NULL);
+	}
+	rz_dst = rotozoomSurfaceXY(view, angle, zoomx, zoomy, smooth);
+	_rotozoomRectEnd(src, view);
+
+	return (rz_dst);
+}
+
+/*!
+\brief Rotates and zooms a rectangle of a surface into an existing target surface.
+
+Like rotozoomSurfaceXYInto() for the 'srcrect' part of 'src'; the target size
+is calculated from the size of the clipped rectangle.
+
+\param src The surface to rotozoom.
+\param srcrect The rectangle of 'src' to rotozoom or NULL for the whole surface.
+\param dst The target surface.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
+*/
+int rotozoomSurfaceXYRectInto(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, double angle, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
+{
+	SDL_Surface *view;
+	int result;
+
+	if ((view = _rotozoomRectBegin(src, srcrect)) == NULL) {
+		return (-1);
+	}
+	result = rotozoomSurfaceXYInto(view, dst, angle, zoomx, zoomy, smooth, scratch, scratchSize);
+	_rotozoomRectEnd(src, view);
+
+	return (result);
+}
+
+/*!
+\brief A job of a rotozoom batch, sorted by output size.
+*/
+typedef struct {
+	rotozoomJob *job;
+	SDL_Surface *src;
+	int converted;
+	int dstwidth;
+	int dstheight;
+	Sint64 pixels;
+} _rotozoomBatchItem;
+
+/*!
+\brief State of a rotozoom batch.
+*/
+typedef struct {
+	_rotozoomBatchItem *items;
+	int numItems;
+	SDL_AtomicInt nextItem;
+	SDL_AtomicInt failed;
+} _rotozoomBatch;
+
+/*!
+\brief Internal qsort callback ordering batch items by decreasing output size.
+*/
+static int _rotozoomBatchCompare(const void *a, const void *b)
+{
+	const _rotozoomBatchItem *ia = (const _rotozoomBatchItem *) a;
+	const _rotozoomBatchItem *ib = (const _rotozoomBatchItem *) b;
+
+	if (ia->pixels != ib->pixels) {
+		return (ia->pixels > ib->pixels) ? -1 : 1;
+	}
+	return (ia->job < ib->job) ? -1 : (ia->job > ib->job);
+}
+
+/*!
+\brief Band worker of rotozoomSurfaceXYBatch(); each band is one worker claiming jobs until none are left.
+
+The scratch buffer of the worker is reused for all its jobs.
+*/
+static void _rotozoomBatchBand(void *data, int ystart, int yend)
+{
+	_rotozoomBatch *batch = (_rotozoomBatch *) data;
+	_rotozoomBatchItem *item;
+	rotozoomJob *job;
+	void *scratch = NULL;
+	size_t scratchSize = 0, size;
+	int i, created;
+
+	(void)ystart;
+	(void)yend;
+	while ((i = SDL_AddAtomicInt(&batch->nextItem, 1)) < batch->numItems) {
+		item = &batch->items[i];
+		job = item->job;
+		created = 0;
+		if (job->dst == NULL) {
+			job->dst = _rotozoomCreateTarget(item->src, item->dstwidth, item->dstheight, _rotozoomNativeSmooth(item->src->format, job->smooth));
+			if (job->dst == NULL) {
+				job->result = -1;
+				SDL_SetAtomicInt(&batch->failed, 1);
+				continue;
+			}
+			created = 1;
+		}
+
+		/*
+		* Grow the scratch buffer of this worker if needed 
+		*/
+		size = rotozoomSurfaceScratchSize(item->src, item->dstwidth, item->dstheight);
+		if (size > scratchSize) {
+			SDL_free(scratch);
+			scratch = SDL_malloc(size);
+			scratchSize = (scratch) ? size : 0;
+		}
+
+		job->result = rotozoomSurfaceXYInto(item->src, job->dst, job->angle, job->zoomx, job->zoomy, job->smooth, scratch, scratchSize);
+		if (job->result != 0) {
+			if (created) {
+				SDL_DestroySurface(job->dst);
+				job->dst = NULL;
+			}
+			SDL_SetAtomicInt(&batch->failed, 1);
+		}
+	}
+	SDL_free(scratch);
+}
+
+/*!
+\brief Rotates and zooms a batch of surfaces across the thread pool.
+
+Runs rotozoomSurfaceXYInto() for each job, or rotozoomSurfaceXY() for jobs
+without a target surface, storing the new surface in the job's 'dst'. The jobs
+are distributed across the threads configured with rotozoomSetThreads(), largest
+output first, each thread claiming the next job when it is done and reusing one
+scratch buffer for all its jobs; with threading disabled the jobs run on the
+calling thread. Sources which are converted to RGBA32 are converted once on the
+calling thread before the jobs are distributed, so jobs may share source
+surfaces, unless these need locking (RLE) and are rotated without conversion.
+
+\param jobs The jobs; 'result' of each job is set to 0 for success or -1 for error.
+\param numJobs Number of jobs.
+
+\return 0 if all jobs succeeded or -1 for error.
+*/
+int rotozoomSurfaceXYBatch(rotozoomJob *jobs, int numJobs)
+{
+	_rotozoomBatch batch;
+	_rotozoomBatchItem *item;
+	const SDL_PixelFormatDetails* details;
+	double dummy_sanglezoom, dummy_canglezoom;
+	int i, j;
+
+	/*
+	* Sanity check 
+	*/
+	if ((jobs == NULL) || (numJobs < 0)) {
+		return (-1);
+	}
+	if (numJobs == 0) {
+		return (0);
+	}
+	if ((batch.items = (_rotozoomBatchItem *) SDL_malloc(numJobs * sizeof(_rotozoomBatchItem))) == NULL) {
+		return (-1);
+	}
+
+	/*
+	* Order the jobs by output size to balance the threads 
+	*/
+	batch.numItems = 0;
+	SDL_SetAtomicInt(&batch.failed, 0);
+	for (i = 0; i < numJobs; i++) {
+		if (jobs[i].src == NULL) {
+			jobs[i].result = -1;
+			SDL_SetAtomicInt(&batch.failed, 1);
+			continue;
+		}
+		batch.items[batch.numItems].job = &jobs[i];
+		batch.items[batch.numItems].src = jobs[i].src;
+		batch.items[batch.numItems].converted = 0;
+		_rotozoomSurfaceXYSize(jobs[i].src->w, jobs[i].src->h, jobs[i].angle, jobs[i].zoomx, jobs[i].zoomy,
+			&batch.items[batch.numItems].dstwidth, &batch.items[batch.numItems].dstheight, &dummy_canglezoom, &dummy_sanglezoom);
+		batch.items[batch.numItems].pixels = (Sint64) batch.items[batch.numItems].dstwidth * batch.items[batch.numItems].dstheight;
+		batch.numItems++;
+	}
+	qsort(batch.items, batch.numItems, sizeof(_rotozoomBatchItem), _rotozoomBatchCompare);
+
+	/*
+	* Convert sources to RGBA32 here as _rotozoomBegin() would; SDL_BlitSurface()
+	* updates state of the source and must not run on a shared source in parallel 
 	*/
-	sp = csp = (Uint8 *) src->pixels;
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+	for (i = 0; i < batch.numItems; i++) {
+		item = &batch.items[i];
+		details = SDL_GetPixelFormatDetails(item->src->format);
+		if ((details == NULL) || (details->bits_per_pixel == 32) || (details->bits_per_pixel == 8) ||
+			(_rotozoomTargetFormat(item->src, _rotozoomNativeSmooth(item->src->format, item->job->smooth)) == item->src->format)) {
+			continue;
+		}
+		for (j = 0; j < i; j++) {
+			if ((batch.items[j].converted) && (batch.items[j].job->src == item->src)) {
+				item->src = batch.items[j].src;
+				break;
+			}
+		}
+		if (j < i) {
+			continue;
+		}
+		if ((item->src = SDL_CreateSurface(item->job->src->w, item->job->src->h, SDL_PIXELFORMAT_RGBA32)) == NULL) {
+			item->src = item->job->src;
+			continue;
+		}
+		SDL_BlitSurface(item->job->src, NULL, item->src, NULL);
+		item->converted = 1;
+	}
+
+	SDL_SetAtomicInt(&batch.nextItem, 0);
+	_rotozoomParallelBands(batch.numItems, batch.numItems, _rotozoomBatchBand, &batch);
+
+	for (i = 0; i < batch.numItems; i++) {
+		if (batch.items[i].converted) {
+			SDL_DestroySurface(batch.items[i].src);
+		}
+	}
+	SDL_free(batch.items);
+
+	return (SDL_GetAtomicInt(&batch.failed) ? -1 : 0);
+}
+
+/*!
+\brief Calculates the size of the target surface for a zoomSurface() call.
+
+The minimum size of the target surface is 1. The input factors can be positive or negative.
+
+\param width The width of the source surface to zoom.
+\param height The height of the source surface to zoom.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param dstwidth Pointer to an integer to store the calculated width of the zoomed target surface.
+\param dstheight Pointer to an integer to store the calculated height of the zoomed target surface.
+*/
+void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dstwidth, int *dstheight)
+{
+	/*
+	* Make zoom factors positive 
+	*/
+	int flipx, flipy;
+	flipx = (zoomx<0.0);
+	if (flipx) zoomx = -zoomx;
+	flipy = (zoomy<0.0);
+	if (flipy) zoomy = -zoomy;
+
+	/*
+	* Sanity check zoom factors 
+	*/
+	if (zoomx < VALUE_LIMIT) {
+		zoomx = VALUE_LIMIT;
+	}
+	if (zoomy < VALUE_LIMIT) {
+		zoomy = VALUE_LIMIT;
+	}
+
+	/*
+	* Calculate target size 
+	*/
+	*dstwidth = (int) floor(((double) width * zoomx) + 0.5);
+	*dstheight = (int) floor(((double) height * zoomy) + 0.5);
+	if (*dstwidth < 1) {
+		*dstwidth = 1;
+	}
+	if (*dstheight < 1) {
+		*dstheight = 1;
+	}
+}
+
+/*! 
+\brief Zoom a surface by independent horizontal and vertical factors with optional smoothing.
+
+Zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
+'zoomx' and 'zoomy' are scaling factors for width and height. If 'smooth' is on
+then the destination 32bit surface is anti-aliased; SMOOTHING_BICUBIC and
+SMOOTHING_LANCZOS3 select higher quality resampling. 16bit and 24bit RGB(A)
+surfaces are zoomed in their own format, except with SMOOTHING_BICUBIC and
+SMOOTHING_LANCZOS3. Other surfaces which are not 8bit or 32bit RGBA/ABGR will
+be converted into a 32bit RGBA format on the fly. Adding SMOOTHING_PREMULTIPLIED
+to a smoothing mode weights the interpolation by alpha, so transparent
+pixels do not darken the edges of the image; the result keeps straight alpha.
+If zoom factors are negative, the image is flipped on the axes.
+
+\param src The surface to zoom.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param smooth SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
 
-	if (flipx) csp += (src->w-1);
-	if (flipy) csp  = ( (Uint8*)csp + src->pitch*(src->h-1) );
+\return The new, zoomed surface.
+*/
+SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smooth)
+{
+	SDL_Surface *rz_dst;
+	int dstwidth, dstheight;
 
 	/*
-	* Precalculate row increments 
+	* Sanity check 
 	*/
-	csx = 0;
-	csax = sax;
-	for (x = 0; x < dst->w; x++) {
-		csx += src->w;
-		*csax = 0;
-		while (csx >= dst->w) {
-			csx -= dst->w;
-			(*csax)++;
-		}
-		(*csax) = (*csax) * (flipx ? -1 : 1);
-		csax++;
+	if (src == NULL)
+		return (NULL);
+
+	/*
+	* Alloc space to completely contain the zoomed surface 
+	*/
+	zoomSurfaceSize(src->w, src->h, zoomx, zoomy, &dstwidth, &dstheight);
+	rz_dst = _rotozoomCreateTarget(src, dstwidth, dstheight, _rotozoomNativeSmooth(src->format, smooth));
+	if (rz_dst == NULL) {
+		return NULL;
 	}
-	csy = 0;
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csy += src->h;
-		*csay = 0;
-		while (csy >= dst->h) {
-			csy -= dst->h;
-			(*csay)++;
-		}
-		(*csay) = (*csay) * (flipy ? -1 : 1);
-		csay++;
+
+	if (zoomSurfaceInto(src, rz_dst, zoomx, zoomy, smooth, NULL, 0) != 0) {
+		SDL_DestroySurface(rz_dst);
+		return NULL;
 	}
 
 	/*
-	* Draw 
+	* Return destination surface 
+	*/
+	return (rz_dst);
+}
+
+/*! 
+\brief Zoom a surface into an existing target surface.
+
+Like zoomSurface(), but writes into 'dst' instead of allocating a new surface.
+'dst' must have the size returned by zoomSurfaceSize() and the format
+zoomSurface() would use: the source format for 32bit sources and natively
+handled 16bit and 24bit sources, SDL_PIXELFORMAT_INDEX8 for 8bit sources and
+SDL_PIXELFORMAT_RGBA32 otherwise.
+If a scratch buffer of rotozoomSurfaceScratchSize() bytes is passed, only the
+SDL_Surface header of a converted source is allocated, plus the filter tables
+and intermediate buffer of SMOOTHING_BICUBIC and SMOOTHING_LANCZOS3; use a
+zoomPlan to keep those.
+
+\param src The surface to zoom.
+\param dst The target surface.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param smooth SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
+*/
+int zoomSurfaceInto(SDL_Surface * src, SDL_Surface * dst, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
+{
+	SDL_Surface *rz_src;
+	int *tables;
+	int dstwidth, dstheight, result;
+	int flipx, flipy;
+
+	/*
+	* Sanity check 
 	*/
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csax = sax;
-		sp = csp;
-		for (x = 0; x < dst->w; x++) {
-			/*
-			* Draw 
-			*/
-			*dp = *sp;
-			/*
-			* Advance source pointers 
-			*/
-			sp += (*csax);
-			csax++;
-			/*
-			* Advance destination pointer 
-			*/
-			dp++;
-		}
+	if (src == NULL)
+		return (-1);
+
+	/* Get size of target */
+	zoomSurfaceSize(src->w, src->h, zoomx, zoomy, &dstwidth, &dstheight);
+	if (_rotozoomBegin(src, dst, dstwidth, dstheight, _rotozoomNativeSmooth(src->format, smooth), scratch, scratchSize, &rz_src, &tables) != 0) {
+		return (-1);
+	}
+
+	flipx = (zoomx<0.0);
+	flipy = (zoomy<0.0);
+
+	/*
+	* Check which kind of surface we have 
+	*/
+	if (SDL_BYTESPERPIXEL(dst->format) == 4) {
 		/*
-		* Advance source pointer (for row) 
+		* Call the 32bit transformation routine to do the zooming (using alpha) 
 		*/
-		csp += ((*csay) * src->pitch);
-		csay++;
-
+		result = _zoomSurfaceRGBATables(rz_src, dst, flipx, flipy, smooth, tables);
+	} else if (SDL_BYTESPERPIXEL(dst->format) > 1) {
+		/*
+		* Call the 16bit/24bit transformation routine to do the zooming 
+		*/
+		result = _zoomSurfaceNTables(rz_src, dst, flipx, flipy, smooth, tables);
+	} else {
 		/*
-		* Advance destination pointers 
+		* Call the 8bit transformation routine to do the zooming 
 		*/
-		dp += dgap;
+		result = _zoomSurfaceYTables(rz_src, dst, flipx, flipy, tables);
 	}
 
-	/*
-	* Remove temp arrays 
-	*/
-	free(sax);
-	free(say);
+	_rotozoomEnd(src, rz_src, dst);
 
-	return (0);
+	return (result);
 }
 
 /*! 
-\brief Internal 32 bit rotozoomer with optional anti-aliasing.
+\brief Zoom a surface straight into a streaming texture.
 
-Rotates and zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control 
-parameters by scanning the destination surface and applying optionally anti-aliasing
-by bilinear interpolation.
-Assumes src and dst surfaces are of 32 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+Like zoomSurfaceInto(), but locks the rectangle of the destination size at the
+top left of 'texture' and writes the result directly into its pixel buffer, so
+neither a temporary surface nor a copy to the texture is needed. The texture
+must have been created with SDL_TEXTUREACCESS_STREAMING, be at least as large as
+zoomSurfaceSize() reports and have the format zoomSurface() would return (for a
+32bit source that is the source format). The part of the texture outside the
+destination rectangle is not changed.
 
-\param src Source surface.
-\param dst Destination surface.
-\param cx Horizontal center coordinate.
-\param cy Vertical center coordinate.
-\param isin Integer version of sine of angle.
-\param icos Integer version of cosine of angle.
-\param flipx Flag indicating horizontal mirroring should be applied.
-\param flipy Flag indicating vertical mirroring should be applied.
-\param smooth Flag indicating anti-aliasing should be used.
+\param src The surface to zoom.
+\param texture The streaming texture.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param smooth SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
 */
-void _transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+int zoomSurfaceToTexture(SDL_Surface * src, SDL_Texture * texture, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
 {
-	int x, y, t1, t2, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh;
-	SDL_Color c00, c01, c10, c11, cswap;
-	SDL_Color *pc, *sp;
-	int gap;
+	SDL_Surface *dst;
+	SDL_Rect rect;
+	int result;
 
 	/*
-	* Variable setup 
+	* Sanity check 
 	*/
-	xd = ((src->w - dst->w) << 15);
-	yd = ((src->h - dst->h) << 15);
-	ax = (cx << 16) - (icos * cx);
-	ay = (cy << 16) - (isin * cx);
-	sw = src->w - 1;
-	sh = src->h - 1;
-	pc = (SDL_Color *) dst->pixels;
-	gap = dst->pitch - dst->w * 4;
+	if ((src == NULL) || (texture == NULL)) {
+		return (-1);
+	}
 
 	/*
-	* Switch between interpolating and non-interpolating code 
+	* Lock the destination rectangle of the texture 
 	*/
-	if (smooth) {
-		for (y = 0; y < dst->h; y++) {
-			dy = cy - y;
-			sdx = (ax + (isin * dy)) + xd;
-			sdy = (ay - (icos * dy)) + yd;
-			for (x = 0; x < dst->w; x++) {
-				dx = (sdx >> 16);
-				dy = (sdy >> 16);
-				if (flipx) dx = sw - dx;
-				if (flipy) dy = sh - dy;
-				if ((dx > -1) && (dy > -1) && (dx < (src->w-1)) && (dy < (src->h-1))) {
-					sp = (SDL_Color *)src->pixels;;
-					sp += ((src->pitch/4) * dy);
-					sp += dx;
-					c00 = *sp;
-					sp += 1;
-					c01 = *sp;
-					sp += (src->pitch/4);
-					c11 = *sp;
-					sp -= 1;
-					c10 = *sp;
-					if (flipx) {
-						cswap = c00; c00=c01; c01=cswap;
-						cswap = c10; c10=c11; c11=cswap;
-					}
-					if (flipy) {
-						cswap = c00; c00=c10; c10=cswap;
-						cswap = c01; c01=c11; c11=cswap;
-					}
-					/*
-					* Interpolate colors 
-					*/
-					ex = (sdx & 0xffff);
-					ey = (sdy & 0xffff);
-					t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-					t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-					pc->r = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-					t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-					pc->g = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-					t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-					pc->b = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-					t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-					pc->a = (((t2 - t1) * ey) >> 16) + t1;
-				}
-				sdx += icos;
-				sdy += isin;
-				pc++;
+	zoomSurfaceSize(src->w, src->h, zoomx, zoomy, &rect.w, &rect.h);
+	if ((rect.w > texture->w) || (rect.h > texture->h)) {
+		return (-1);
+	}
+	rect.x = 0;
+	rect.y = 0;
+	if (!SDL_LockTextureToSurface(texture, &rect, &dst)) {
+		return (-1);
+	}
+
+	result = zoomSurfaceInto(src, dst, zoomx, zoomy, smooth, scratch, scratchSize);
+
+	SDL_UnlockTexture(texture);
+
+	return (result);
+}
+
+/*! 
+\brief Zoom a rectangle of a surface.
+
+Like zoomSurface(), but zooms only the 'srcrect' part of 'src', reading it in
+place with the pitch of 'src' instead of cropping it into a new surface first.
+The rectangle is clipped to the surface.
+
+\param src The surface to zoom.
+\param srcrect The rectangle of 'src' to zoom or NULL for the whole surface.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param smooth SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
+
+\return The new, zoomed surface or NULL on error.
+*/
+SDL_Surface *zoomSurfaceRect(SDL_Surface * src, const SDL_Rect * srcrect, double zoomx, double zoomy, int smooth)
+{
+	SDL_Surface *view, *rz_dst;
+
+	if ((view = _rotozoomRectBegin(src, srcrect)) == NULL) {
+		return (NULL);
+	}
+	rz_dst = zoomSurface(view, zoomx, zoomy, smooth);
+	_rotozoomRectEnd(src, view);
+
+	return (rz_dst);
+}
+
+/*! 
+\brief Zoom a rectangle of a surface into an existing target surface.
+
+Like zoomSurfaceInto() for the 'srcrect' part of 'src'; the target size is
+calculated from the size of the clipped rectangle.
+
+\param src The surface to zoom.
+\param srcrect The rectangle of 'src' to zoom or NULL for the whole surface.
+\param dst The target surface.
+\param zoomx The horizontal zoom factor.
+\param zoomy The vertical zoom factor.
+\param smooth SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally with SMOOTHING_PREMULTIPLIED.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
+
+\return 0 for success or -1 for error.
+*/
+int zoomSurfaceRectInto(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, double zoomx, double zoomy, int smooth,
+	void *scratch, size_t scratchSize)
+{
+	SDL_Surface *view;
+	int result;
+
+	if ((view = _rotozoomRectBegin(src, srcrect)) == NULL) {
+		return (-1);
+	}
+	result = zoomSurfaceInto(view, dst, zoomx, zoomy, smooth, scratch, scratchSize);
+	_rotozoomRectEnd(src, view);
+
+	return (result);
+}
+
+/* ---- Band streaming */
+
+/*!
+\brief State of a streamed rotozoom.
+*/
+typedef struct {
+	int rotate;
+	int bpp;
+	int smooth;
+	int flipx;
+	int flipy;
+	int srch;
+	int dstw;
+	int dsth;
+	int isin;
+	int icos;
+	int *tables;
+	_pixelLayout layout;
+	_transformContext transform;
+} _rotozoomStream;
+
+/*!
+\brief Internal range of the source rows read by a band of destination rows.
+
+\param stream The stream.
+\param y0 First destination row.
+\param y1 Destination row after the last one.
+\param r0 Pointer to store the first source row.
+\param r1 Pointer to store the source row after the last one; equals r0 if no row is read.
+*/
+static void _rotozoomStreamRows(_rotozoomStream *stream, int y0, int y1, int *r0, int *r1)
+{
+	int y, x0, x1, ta, tb, cy, lo, hi, tap, by;
+	Sint64 sdx, sdy;
+	const int *say;
+
+	lo = stream->srch;
+	hi = -1;
+	tap = (stream->smooth) ? 1 : 0;
+	if (stream->rotate) {
+		/*
+		* The integer source coordinates are linear along a row; the ends of the in-bounds span are the extremes 
+		*/
+		for (y = y0; y < y1; y++) {
+			_transformRowSpan(&stream->transform, y, &sdx, &sdy, &x0, &x1);
+			if (x0 >= x1) {
+				continue;
 			}
-			pc = (SDL_Color *) ((Uint8 *) pc + gap);
+			ta = (int) ((sdy + (Sint64) x0 * stream->transform.isin) >> 16);
+			tb = (int) ((sdy + (Sint64) (x1 - 1) * stream->transform.isin) >> 16);
+			lo = SDL_min(lo, SDL_min(ta, tb));
+			hi = SDL_max(hi, SDL_max(ta, tb));
+		}
+		if (hi >= lo) {
+			if (stream->flipy) {
+				by = (tap) ? stream->srch : stream->srch - 1;
+				ta = by - hi - tap;
+				hi = by - lo;
+				lo = ta;
+			} else {
+				hi += tap;
+			}
+		}
+	} else if (stream->bpp == 1) {
+		/*
+		* The 8bit zoomer tables hold the (mirrored) source rows 
+		*/
+		say = stream->tables + stream->dstw + 1;
+		for (y = y0; y < y1; y++) {
+			lo = SDL_min(lo, say[y]);
+			hi = SDL_max(hi, say[y]);
 		}
 	} else {
-		for (y = 0; y < dst->h; y++) {
-			dy = cy - y;
-			sdx = (ax + (isin * dy)) + xd;
-			sdy = (ay - (icos * dy)) + yd;
-			for (x = 0; x < dst->w; x++) {
-				dx = (short) (sdx >> 16);
-				dy = (short) (sdy >> 16);
-				if (flipx) dx = (src->w-1)-dx;
-				if (flipy) dy = (src->h-1)-dy;
-				if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
-					sp = (SDL_Color *) ((Uint8 *) src->pixels + src->pitch * dy);
-					sp += dx;
-					*pc = *sp;
-				}
-				sdx += icos;
-				sdy += isin;
-				pc++;
+		say = stream->tables + stream->dstw + 1;
+		for (y = y0; y < y1; y++) {
+			cy = say[y];
+			ta = (stream->flipy) ? stream->srch - 1 - cy : cy;
+			tb = ta;
+			if ((tap) && (cy < stream->srch - 1)) {
+				tb += (stream->flipy) ? -1 : 1;
+			}
+			lo = SDL_min(lo, SDL_min(ta, tb));
+			hi = SDL_max(hi, SDL_max(ta, tb));
+		}
+	}
+	if (hi < lo) {
+		*r0 = *r1 = 0;
+		return;
+	}
+	*r0 = lo;
+	*r1 = hi + 1;
+}
+
+/*!
+\brief Internal rotozoom of one band of destination rows from a window of source rows.
+
+\param stream The stream.
+\param window The source rows from srcy on.
+\param srcy The source row held in the first row of 'window'.
+\param band The destination rows from dsty on.
+\param dsty The destination row held in the first row of 'band'.
+*/
+static void _rotozoomStreamBand(_rotozoomStream *stream, SDL_Surface * window, int srcy, SDL_Surface * band, int dsty)
+{
+	_transformNContext tctx;
+	_zoomNContext zctx;
+	const int *say;
+
+	if (stream->rotate) {
+		_transformSetupWindow(&tctx.transform, window, band, stream->srch, stream->dsth, srcy, dsty,
+			stream->dstw / 2, stream->dsth / 2, stream->isin, stream->icos, stream->flipx, stream->flipy, stream->smooth);
+		if (stream->bpp == 4) {
+			tctx.transform.kernel = (stream->smooth) ? _transformRowRGBAKernel() : NULL;
+			tctx.transform.ashift = _premultiplyShift(window, stream->smooth);
+			tctx.transform.premul = (tctx.transform.ashift >= 0) ? _transformRowRGBAPremulKernel() : NULL;
+			_rotozoomParallelFor(band->h, _transformSurfaceRGBABand, &tctx.transform);
+		} else if (stream->bpp > 1) {
+			tctx.layout = stream->layout;
+			tctx.smooth = stream->smooth;
+			_rotozoomParallelFor(band->h, _transformSurfaceNBand, &tctx);
+		} else {
+			tctx.transform.background = 0;
+			_rotozoomParallelFor(band->h, _transformSurfaceYBand, &tctx.transform);
+		}
+		return;
+	}
+
+	say = stream->tables + stream->dstw + 1;
+	zctx.zoom.src = window;
+	zctx.zoom.dst = band;
+	zctx.zoom.say = say + dsty;
+	zctx.zoom.flipy = stream->flipy;
+	zctx.zoom.srcy = srcy;
+	zctx.zoom.srch = stream->srch;
+	if (stream->bpp == 1) {
+		zctx.zoom.ox0 = stream->tables;
+		zctx.zoom.run = _zoomRunLength(zctx.zoom.ox0, stream->dstw);
+		_rotozoomParallelFor(band->h, _zoomSurfaceYBand, &zctx.zoom);
+		return;
+	}
+	zctx.zoom.ox0 = say + stream->dsth + 1;
+	zctx.zoom.ox1 = zctx.zoom.ox0 + stream->dstw;
+	zctx.zoom.fx = zctx.zoom.ox1 + stream->dstw;
+	zctx.zoom.fy = zctx.zoom.fx + stream->dstw + dsty;
+	zctx.zoom.run = _zoomRunLength(zctx.zoom.ox0, stream->dstw);
+	if (stream->bpp == 4) {
+		zctx.zoom.kernel = (stream->smooth) ? _zoomRowRGBAKernel() : NULL;
+		zctx.zoom.ashift = _premultiplyShift(window, stream->smooth);
+		zctx.zoom.premul = (zctx.zoom.ashift >= 0) ? _zoomRowRGBAPremulKernel() : NULL;
+		_rotozoomParallelFor(band->h, _zoomSurfaceRGBABand, &zctx.zoom);
+	} else {
+		zctx.zoom.kernel = NULL;
+		zctx.layout = stream->layout;
+		zctx.smooth = stream->smooth;
+		_rotozoomParallelFor(band->h, _zoomSurfaceNBand, &zctx);
+	}
+}
+
+/*!
+\brief Internal fill of a window with the source rows r0 to r1-1.
+
+Rows the window already holds (held0 to held1-1) are moved into place; only
+the missing rows are requested from the source callback.
+
+\param window The window surface.
+\param held0 The first source row held by the window.
+\param held1 The source row after the last one held by the window.
+\param r0 The first source row to hold.
+\param r1 The source row after the last one to hold.
+\param source The source callback.
+\param userdata The user data of the callbacks.
+
+\return 0 for success or -1 if the callback failed.
+*/
+static int _rotozoomStreamFill(SDL_Surface * window, int held0, int held1, int r0, int r1, rotozoomSourceFunc source, void *userdata)
+{
+	Uint8 *pixels;
+	int keep0, keep1;
+
+	pixels = (Uint8 *) window->pixels;
+	keep0 = (held0 > r0) ? held0 : r0;
+	keep1 = (held1 < r1) ? held1 : r1;
+	if (keep0 >= keep1) {
+		return (source(userdata, r0, r1 - r0, pixels, window->pitch) != 0) ? -1 : 0;
+	}
+	memmove(pixels + (keep0 - r0) * window->pitch, pixels + (keep0 - held0) * window->pitch, (size_t) (keep1 - keep0) * window->pitch);
+	if ((keep0 > r0) && (source(userdata, r0, keep0 - r0, pixels, window->pitch) != 0)) {
+		return (-1);
+	}
+	if ((r1 > keep1) && (source(userdata, keep1, r1 - keep1, pixels + (keep1 - r0) * window->pitch, window->pitch) != 0)) {
+		return (-1);
+	}
+	return (0);
+}
+
+/*!
+\brief Rotates and zooms an image band by band without holding the whole source or destination.
+
+Produces the same pixels as rotozoomSurfaceXY() (see there for the parameters)
+for a width x height source of the given format, which is read through the
+'source' callback, and emits the destination to the 'band' callback in bands
+of up to bandHeight rows. For every band only the source rows its pixels
+map to are requested; rows shared with the previous band are kept. Peak memory
+is the band plus the source rows of one band instead of both whole images.
+
+The destination size is the one rotozoomSurfaceSizeXY() reports and the bands
+have the format rotozoomSurfaceXY() returns: the source format for 32bit and 8bit
+sources and for 16bit and 24bit sources the native kernels support with the
+given smoothing mode, RGBA32 otherwise. Rows of sources of other formats are
+blitted to RGBA32 as they are read, with the default blend mode of the format;
+indexed formats of less than 8bit are not supported. SMOOTHING_BICUBIC and SMOOTHING_LANCZOS3 use bilinear smoothing,
+as rotozoomSurfaceXY() does for rotations. Pixels of 8bit destinations outside
+the source are 0.
+
+\param width The width of the source.
+\param height The height of the source.
+\param format The pixel format of the source.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
+\param bandHeight The maximum number of destination rows per band.
+\param source Callback storing source rows into memory: source(userdata, y, rows, pixels, pitch)
+must fill 'rows' rows of the source format starting at source row y; returns 0 on success.
+\param band Callback receiving the destination rows y to y+band->h-1 in a surface
+which is reused for the next band: band(userdata, y, band); returns 0 on success.
+\param userdata User data passed to the callbacks.
+
+\return 0 for success or -1 for error or if a callback failed.
+*/
+int rotozoomSurfaceXYStream(int width, int height, SDL_PixelFormat format, double angle, double zoomx, double zoomy, int smooth,
+	int bandHeight, rotozoomSourceFunc source, rotozoomBandFunc band, void *userdata)
+{
+	_rotozoomStream stream;
+	const SDL_PixelFormatDetails* details;
+	SDL_PixelFormat bandformat;
+	SDL_Surface *window, *raw, *out;
+	SDL_Rect rect;
+	double zoominv, sanglezoom, canglezoom;
+	int y0, y1, r0, r1, held0, held1, rows, result;
+
+	/*
+	* Sanity check 
+	*/
+	if ((width < 1) || (height < 1) || (bandHeight < 1) || (source == NULL) || (band == NULL)) {
+		return (-1);
+	}
+	details = SDL_GetPixelFormatDetails(format);
+	if ((details == NULL) || (SDL_ISPIXELFORMAT_FOURCC(format))) {
+		return (-1);
+	}
+	if ((SDL_ISPIXELFORMAT_INDEXED(format)) && (details->bits_per_pixel != 8)) {
+		return (-1);
+	}
+
+	/*
+	* Sources rotozoomSurfaceXY() converts are read into a raw window and converted to RGBA32 
+	*/
+	bandformat = format;
+	if ((details->bits_per_pixel != 32) && (details->bits_per_pixel != 8) &&
+		((!_rotozoomNativeFormat(format)) || (!_rotozoomNativeSmooth(format, smooth)))) {
+		bandformat = SDL_PIXELFORMAT_RGBA32;
+	}
+	stream.bpp = (bandformat == format) ? details->bytes_per_pixel : 4;
+	if (_zoomFilterMode(smooth)) {
+		smooth = SMOOTHING_ON | (smooth & SMOOTHING_PREMULTIPLIED);
+	}
+	stream.smooth = (stream.bpp > 1) ? smooth : 0;
+
+	/*
+	* Determine target size and the transform as rotozoomSurfaceXYInto() does 
+	*/
+	stream.rotate = _rotozoomSurfaceXYSize(width, height, angle, zoomx, zoomy, &stream.dstw, &stream.dsth, &canglezoom, &sanglezoom);
+	stream.srch = height;
+	stream.flipx = (zoomx < 0.0);
+	if (stream.flipx) zoomx = -zoomx;
+	stream.flipy = (zoomy < 0.0);
+	if (stream.flipy) zoomy = -zoomy;
+	if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
+	if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
+	zoominv = 65536.0 / (zoomx * zoomx);
+	stream.isin = (int) SDL_clamp(sanglezoom * zoominv, (double) -SDL_MAX_SINT32, (double) SDL_MAX_SINT32);
+	stream.icos = (int) SDL_clamp(canglezoom * zoominv, (double) -SDL_MAX_SINT32, (double) SDL_MAX_SINT32);
+	stream.tables = NULL;
+	if ((stream.bpp == 2) || (stream.bpp == 3)) {
+		_pixelLayoutInit(&stream.layout, format);
+	}
+
+	/*
+	* Allocate the band and a first window of one row 
+	*/
+	result = -1;
+	raw = NULL;
+	out = SDL_CreateSurface(stream.dstw, SDL_min(bandHeight, stream.dsth), bandformat);
+	window = SDL_CreateSurface(width, 1, bandformat);
+	if ((out == NULL) || (window == NULL)) {
+		goto done;
+	}
+	if (stream.rotate) {
+		_transformSetupWindow(&stream.transform, window, out, stream.srch, stream.dsth, 0, 0,
+			stream.dstw / 2, stream.dsth / 2, stream.isin, stream.icos, stream.flipx, stream.flipy, stream.smooth);
+	} else {
+		if ((stream.tables = (int *) SDL_malloc(ZOOM_TABLE_INTS(stream.dstw, stream.dsth) * sizeof(int))) == NULL) {
+			goto done;
+		}
+		if (stream.bpp == 1) {
+			_zoomTablesY(width, height, stream.dstw, stream.dsth, stream.flipx, stream.flipy, stream.tables);
+		} else {
+			_zoomTablesRGBA(width, height, stream.dstw, stream.dsth, stream.flipx, stream.smooth, stream.tables);
+		}
+	}
+
+	/*
+	* Size the window for the band reading the most source rows 
+	*/
+	rows = 1;
+	for (y0 = 0; y0 < stream.dsth; y0 += bandHeight) {
+		_rotozoomStreamRows(&stream, y0, SDL_min(y0 + bandHeight, stream.dsth), &r0, &r1);
+		rows = SDL_max(rows, r1 - r0);
+	}
+	if (rows > window->h) {
+		SDL_DestroySurface(window);
+		if ((window = SDL_CreateSurface(width, rows, bandformat)) == NULL) {
+			goto done;
+		}
+	}
+	if ((bandformat != format) && ((raw = SDL_CreateSurface(width, rows, format)) == NULL)) {
+		goto done;
+	}
+
+	/*
+	* Read, transform and emit band by band 
+	*/
+	held0 = held1 = 0;
+	for (y0 = 0; y0 < stream.dsth; y0 = y1) {
+		y1 = SDL_min(y0 + bandHeight, stream.dsth);
+		_rotozoomStreamRows(&stream, y0, y1, &r0, &r1);
+		if ((r1 > r0) && (_rotozoomStreamFill((raw != NULL) ? raw : window, held0, held1, r0, r1, source, userdata) != 0)) {
+			goto done;
+		}
+		if ((r1 > r0) && (raw != NULL)) {
+			/*
+			* Blit onto cleared rows like _rotozoomBegin() does, so blending matches 
+			*/
+			rect.x = 0;
+			rect.y = 0;
+			rect.w = width;
+			rect.h = r1 - r0;
+			memset(window->pixels, 0, (size_t) window->pitch * rect.h);
+			if (!SDL_BlitSurface(raw, &rect, window, NULL)) {
+				goto done;
 			}
-			pc = (SDL_Color *) ((Uint8 *) pc + gap);
+		}
+		if (r1 > r0) {
+			held0 = r0;
+			held1 = r1;
+		}
+		out->h = y1 - y0;
+		_rotozoomStreamBand(&stream, window, held0, out, y0);
+		if (band(userdata, y0, out) != 0) {
+			goto done;
 		}
 	}
+	result = 0;
+
+done:
+	SDL_free(stream.tables);
+	SDL_DestroySurface(raw);
+	SDL_DestroySurface(window);
+	SDL_DestroySurface(out);
+
+	return (result);
 }
 
+/* ---- Zoom plans */
+
 /*!
+\brief Precalculated geometry of a zoom; see zoomPlanCreate().
+*/
+struct zoomPlan {
+	int srcw;
+	int srch;
+	int dstw;
+	int dsth;
+	int flipx;
+	int flipy;
+	int smooth;
+	int *tablesRGBA;
+	int *tablesY;
+	_zoomFilterTable filterx;
+	_zoomFilterTable filtery;
+	Uint32 *filterTmp;
+	void *scratch;
+	size_t scratchSize;
+};
 
-\brief Rotates and zooms 8 bit palette/Y 'src' surface to 'dst' surface without smoothing.
+/*!
+\brief Create a plan for repeated zooms of one source size to one destination size.
 
-Rotates and zooms 8 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control 
-parameters by scanning the destination surface.
-Assumes src and dst surfaces are of 8 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+The plan holds the precalculated source row/column tables and, for smoothing,
+the interpolation weights of both the 32bit and the 8bit zoomer, so
+zoomPlanExecute() skips all setup work. For SMOOTHING_BICUBIC and
+SMOOTHING_LANCZOS3 it also holds the filter weights and intermediate buffer. The result is identical to zoomSurface()
+with factors that produce the destination size.
 
-\param src Source surface.
-\param dst Destination surface.
-\param cx Horizontal center coordinate.
-\param cy Vertical center coordinate.
-\param isin Integer version of sine of angle.
-\param icos Integer version of cosine of angle.
-\param flipx Flag indicating horizontal mirroring should be applied.
-\param flipy Flag indicating vertical mirroring should be applied.
+\param srcw The source width.
+\param srch The source height.
+\param dstw The destination width.
+\param dsth The destination height.
+\param flags SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3, optionally combined with SMOOTHING_PREMULTIPLIED, ZOOMPLAN_FLIPX and ZOOMPLAN_FLIPY.
+
+\return The new plan or NULL on error. Free with zoomPlanDestroy().
 */
-void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy)
+zoomPlan *zoomPlanCreate(int srcw, int srch, int dstw, int dsth, int flags)
 {
-	int x, y, dx, dy, xd, yd, sdx, sdy, ax, ay;
-	Uint8 *pc, *sp;
-	int gap;
+	zoomPlan *plan;
 
 	/*
-	* Variable setup 
+	* Sanity check 
 	*/
-	xd = ((src->w - dst->w) << 15);
-	yd = ((src->h - dst->h) << 15);
-	ax = (cx << 16) - (icos * cx);
-	ay = (cy << 16) - (isin * cx);
-	pc = (Uint8 *) dst->pixels;
-	gap = dst->pitch - dst->w;
+	if ((srcw < 1) || (srch < 1) || (dstw < 1) || (dsth < 1)) {
+		return NULL;
+	}
+
+	if ((plan = (zoomPlan *) SDL_malloc(sizeof(zoomPlan))) == NULL) {
+		return NULL;
+	}
+	plan->srcw = srcw;
+	plan->srch = srch;
+	plan->dstw = dstw;
+	plan->dsth = dsth;
+	plan->flipx = (flags & ZOOMPLAN_FLIPX) ? 1 : 0;
+	plan->flipy = (flags & ZOOMPLAN_FLIPY) ? 1 : 0;
+	plan->smooth = flags & ~(ZOOMPLAN_FLIPX | ZOOMPLAN_FLIPY);
+	plan->filterx.start = NULL;
+	plan->filterx.weights = NULL;
+	plan->filtery.start = NULL;
+	plan->filtery.weights = NULL;
+	plan->filterTmp = NULL;
+	plan->scratch = NULL;
+	plan->scratchSize = 0;
+
 	/*
-	* Clear surface to colorkey 
-	*/ 	
-	memset(pc, (int)(_colorkey(src) & 0xff), dst->pitch * dst->h);
+	* Precalculate the tables of both zoomers 
+	*/
+	plan->tablesRGBA = (int *) SDL_malloc(ZOOM_TABLE_INTS(dstw, dsth) * sizeof(int));
+	plan->tablesY = (int *) SDL_malloc(ZOOM_TABLE_INTS(dstw, dsth) * sizeof(int));
+	if ((plan->tablesRGBA == NULL) || (plan->tablesY == NULL)) {
+		zoomPlanDestroy(plan);
+		return NULL;
+	}
+	_zoomTablesRGBA(srcw, srch, dstw, dsth, plan->flipx, plan->smooth, plan->tablesRGBA);
+	_zoomTablesY(srcw, srch, dstw, dsth, plan->flipx, plan->flipy, plan->tablesY);
+
 	/*
-	* Iterate through destination surface 
+	* Precalculate the separable filter weights 
 	*/
-	for (y = 0; y < dst->h; y++) {
-		dy = cy - y;
-		sdx = (ax + (isin * dy)) + xd;
-		sdy = (ay - (icos * dy)) + yd;
-		for (x = 0; x < dst->w; x++) {
-			dx = (short) (sdx >> 16);
-			dy = (short) (sdy >> 16);
-			if (flipx) dx = (src->w-1)-dx;
-			if (flipy) dy = (src->h-1)-dy;
-			if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
-				sp = (Uint8 *) (src->pixels);
-				sp += (src->pitch * dy + dx);
-				*pc = *sp;
-			}
-			sdx += icos;
-			sdy += isin;
-			pc++;
+	if (_zoomFilterMode(plan->smooth)) {
+		if ((_zoomFilterTableInit(&plan->filterx, srcw, dstw, plan->flipx, plan->smooth) != 0) ||
+			(_zoomFilterTableInit(&plan->filtery, srch, dsth, plan->flipy, plan->smooth) != 0) ||
+			((plan->filterTmp = (Uint32 *) SDL_malloc((size_t) srch * dstw * sizeof(Uint32))) == NULL)) {
+			zoomPlanDestroy(plan);
+			return NULL;
 		}
-		pc += gap;
 	}
+
+	return plan;
 }
 
 /*!
-\brief Rotates a 8/16/24/32 bit surface in increments of 90 degrees.
+\brief Zoom a surface into an existing target surface using a plan.
 
-Specialized 90 degree rotator which rotates a 'src' surface in 90 degree 
-increments clockwise returning a new surface. Faster than rotozoomer since
-no scanning or interpolation takes place. Input surface must be 8/16/24/32 bit.
-(code contributed by J. Schiller, improved by C. Allport and A. Schiffler)
+'src' must have the source size and 'dst' the destination size of the plan.
+'dst' must have the format zoomSurface() would use with the smoothing mode of
+the plan: the source format for 32bit sources and natively handled 16bit and
+24bit sources, SDL_PIXELFORMAT_INDEX8 for 8bit sources and SDL_PIXELFORMAT_RGBA32
+otherwise. Sources of other formats are converted into a buffer kept by the plan.
 
-\param src Source surface to rotate.
-\param numClockwiseTurns Number of clockwise 90 degree turns to apply to the source.
+\param plan The plan created with zoomPlanCreate().
+\param src The surface to zoom.
+\param dst The target surface.
 
-\returns The new, rotated surface; or NULL for surfaces with incorrect input format.
+\return 0 for success or -1 for error.
 */
-SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns) 
+int zoomPlanExecute(zoomPlan *plan, SDL_Surface * src, SDL_Surface * dst)
 {
-	int row, col, newWidth, newHeight;
-	int bpp, bpr;
-	SDL_Surface* dst;
-	Uint8* srcBuf;
-	Uint8* dstBuf;
-	int normalizedClockwiseTurns;
+	SDL_Surface *rz_src;
+	int *tables, result;
+	size_t size;
+	void *scratch;
 	const SDL_PixelFormatDetails* details;
 
-	/* Has to be a valid surface pointer and be a Nbit surface where n is divisible by 8 */
-	if (!src || 
-	    !src->format) {
-		SDL_SetError("NULL source surface or source surface format");
-	    return NULL; 
+	/*
+	* Sanity check 
+	*/
+	if ((plan == NULL) || (src == NULL) || (src->w != plan->srcw) || (src->h != plan->srch)) {
+		return (-1);
 	}
 
+	/*
+	* Grow the conversion buffer for sources which are not 8bit or 32bit
+	* and have no native kernels 
+	*/
 	details = SDL_GetPixelFormatDetails(src->format);
-	if ((details->bits_per_pixel % 8) != 0) {
-		SDL_SetError("Invalid source surface bit depth");
-	    return NULL; 
+	if ((details != NULL) && (details->bits_per_pixel != 32) && (details->bits_per_pixel != 8) &&
+		((!_rotozoomNativeSmooth(src->format, plan->smooth)) || (!_rotozoomNativeFormat(src->format)))) {
+		size = (size_t) src->w * 4 * src->h;
+		if (plan->scratchSize < size) {
+			if ((scratch = SDL_realloc(plan->scratch, size)) == NULL) {
+				return (-1);
+			}
+			plan->scratch = scratch;
+			plan->scratchSize = size;
+		}
 	}
 
-	/* normalize numClockwiseTurns */
-	normalizedClockwiseTurns = (numClockwiseTurns % 4);
-	if (normalizedClockwiseTurns < 0) {
-		normalizedClockwiseTurns += 4;
+	if (_rotozoomBegin(src, dst, plan->dstw, plan->dsth, _rotozoomNativeSmooth(src->format, plan->smooth), plan->scratch, plan->scratchSize, &rz_src, &tables) != 0) {
+		return (-1);
 	}
 
-	/* If turns are even, our new width/height will be the same as the source surface */
-	if (normalizedClockwiseTurns % 2) {
-		newWidth = src->h;
-		newHeight = src->w;
+	/*
+	* Check which kind of surface we have 
+	*/
+	result = 0;
+	if (SDL_BYTESPERPIXEL(dst->format) == 4) {
+		if (plan->filterTmp != NULL) {
+			result = _zoomFilterExecute(rz_src, dst, &plan->filterx, &plan->filtery, plan->filterTmp, plan->smooth);
+		} else {
+			_zoomExecuteRGBA(rz_src, dst, plan->flipy, plan->smooth, plan->tablesRGBA);
+		}
+	} else if (SDL_BYTESPERPIXEL(dst->format) > 1) {
+		_zoomExecuteN(rz_src, dst, plan->flipy, plan->smooth, plan->tablesRGBA);
 	} else {
-		newWidth = src->w;
-		newHeight = src->h;
+		_zoomExecuteY(rz_src, dst, plan->tablesY);
 	}
 
-	dst = SDL_CreateSurface(newWidth, newHeight, src->format);
-	if(!dst) {
-		SDL_SetError("Could not create destination surface"); 
-		return NULL;
-	}
+	_rotozoomEnd(src, rz_src, dst);
 
-	if (SDL_MUSTLOCK(src)) {
-		SDL_LockSurface(src);
-	}
-	if (SDL_MUSTLOCK(dst)) {
-		SDL_LockSurface(dst);
-	}
+	return (result);
+}
 
-	/* Calculate byte-per-pixel */
-	bpp = details->bits_per_pixel / 8;
+/*!
+\brief Free a plan created with zoomPlanCreate().
 
-	switch(normalizedClockwiseTurns) {
-	case 0: /* Make a copy of the surface */
-		{
-			/* Unfortunately SDL_BlitSurface cannot be used to make a copy of the surface
-			since it does not preserve alpha. */
+\param plan The plan to free; may be NULL.
+*/
+void zoomPlanDestroy(zoomPlan *plan)
+{
+	if (plan == NULL) {
+		return;
+	}
+	SDL_free(plan->tablesRGBA);
+	SDL_free(plan->tablesY);
+	_zoomFilterTableFree(&plan->filterx);
+	_zoomFilterTableFree(&plan->filtery);
+	SDL_free(plan->filterTmp);
+	SDL_free(plan->scratch);
+	SDL_free(plan);
+}
 
-			if (src->pitch == dst->pitch) {
-				/* If the pitch is the same for both surfaces, the memory can be copied all at once. */
-				memcpy(dst->pixels, src->pixels, (src->h * src->pitch));
-			}
-			else
-			{
-				/* If the pitch differs, copy each row separately */
-				srcBuf = (Uint8*)(src->pixels);
-				dstBuf = (Uint8*)(dst->pixels);
-				bpr = src->w * bpp;
-				for (row = 0; row < src->h; row++) {
-					memcpy(dstBuf, srcBuf, bpr);
-					srcBuf += src->pitch;
-					dstBuf += dst->pitch;
-				}
-			}
-		}
-		break;
+/* ---- Rotation caches */
 
-		/* rotate clockwise */
-	case 1: /* rotated 90 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (dst->w - row - 1) * bpp;
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf += dst->pitch;
-				} 
-			} 
-		}
-		break;
+/*!
+\brief Initial number of hash buckets of a rotation cache (power of 2).
+*/
+#define ROTOZOOMCACHE_BUCKETS	64
 
-	case 2: /* rotated 180 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + ((dst->h - row - 1) * dst->pitch) + (dst->w - 1) * bpp;
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf -= bpp;
-				} 
-			} 
-		}
-		break;
+/*!
+\brief A cached rotated frame.
+*/
+typedef struct _rotozoomCacheEntry {
+	struct _rotozoomCacheEntry *next;
+	struct _rotozoomCacheEntry *newer;
+	struct _rotozoomCacheEntry *older;
+	SDL_Surface *src;
+	int step;
+	double zoom;
+	int smooth;
+	Uint32 hash;
+	SDL_Surface *surface;
+	SDL_Texture *texture;
+	SDL_Renderer *renderer;
+	size_t bytes;
+} _rotozoomCacheEntry;
 
-	case 3: /* rotated 270 degrees clockwise */
-		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (row * bpp) + ((dst->h - 1) * dst->pitch);
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf -= dst->pitch;
-				} 
-			} 
-		}
-		break;
-	} 
-	/* end switch */
+/*!
+\brief Cache of rotated frames; see rotozoomCacheCreate().
+*/
+struct rotozoomCache {
+	double quantum;
+	int steps;
+	size_t budget;
+	size_t bytes;
+	int count;
+	int buckets;
+	_rotozoomCacheEntry **table;
+	_rotozoomCacheEntry *newest;
+	_rotozoomCacheEntry *oldest;
+	SDL_Renderer **renderers;
+	int numRenderers;
+	char property[64];
+};
 
-	if (SDL_MUSTLOCK(src)) {
-		SDL_UnlockSurface(src);
-	}
-	if (SDL_MUSTLOCK(dst)) {
-		SDL_UnlockSurface(dst);
-	}
+/*!
+\brief Internal hash of the key of a cached frame.
+*/
+static Uint32 _rotozoomCacheHash(SDL_Surface * src, int step, double zoom, int smooth)
+{
+	Uint64 bits, h;
 
-	return dst;
+	SDL_memcpy(&bits, &zoom, sizeof(bits));
+	h = (Uint64) (uintptr_t) src;
+	h = (h ^ (h >> 29)) * 0x9e3779b97f4a7c15ULL;
+	h = (h ^ (Uint64) step ^ ((Uint64) smooth << 20) ^ bits) * 0xbf58476d1ce4e5b9ULL;
+	return (Uint32) (h ^ (h >> 32));
 }
 
-
 /*!
-\brief Internal target surface sizing function for rotozooms with trig result return. 
+\brief Internal removal of a frame from the hash table and the LRU list of a cache.
+*/
+static void _rotozoomCacheUnlink(rotozoomCache *cache, _rotozoomCacheEntry *entry)
+{
+	_rotozoomCacheEntry **link;
 
-\param width The source surface width.
-\param height The source surface height.
-\param angle The angle to rotate in degrees.
-\param zoomx The horizontal scaling factor.
-\param zoomy The vertical scaling factor.
-\param dstwidth The calculated width of the destination surface.
-\param dstheight The calculated height of the destination surface.
-\param canglezoom The sine of the angle adjusted by the zoom factor.
-\param sanglezoom The cosine of the angle adjusted by the zoom factor.
+	link = &cache->table[entry->hash & (cache->buckets - 1)];
+	while (*link != entry) {
+		link = &(*link)->next;
+	}
+	*link = entry->next;
+	if (entry->newer) {
+		entry->newer->older = entry->older;
+	} else {
+		cache->newest = entry->older;
+	}
+	if (entry->older) {
+		entry->older->newer = entry->newer;
+	} else {
+		cache->oldest = entry->newer;
+	}
+	cache->bytes -= entry->bytes;
+	cache->count--;
+}
 
+/*!
+\brief Internal release of an unlinked frame.
 */
-void _rotozoomSurfaceSizeTrig(int width, int height, double angle, double zoomx, double zoomy, 
-	int *dstwidth, int *dstheight, 
-	double *canglezoom, double *sanglezoom)
+static void _rotozoomCacheFree(_rotozoomCacheEntry *entry)
 {
-	double x, y, cx, cy, sx, sy;
-	double radangle;
-	int dstwidthhalf, dstheighthalf;
-
-	/*
-	* Determine destination width and height by rotating a centered source box 
-	*/
-	radangle = angle * (M_PI / 180.0);
-	*sanglezoom = sin(radangle);
-	*canglezoom = cos(radangle);
-	*sanglezoom *= zoomx;
-	*canglezoom *= zoomy;
-	x = (double)(width / 2);
-	y = (double)(height / 2);
-	cx = *canglezoom * x;
-	cy = *canglezoom * y;
-	sx = *sanglezoom * x;
-	sy = *sanglezoom * y;
+	if (entry->texture) {
+		SDL_DestroyTexture(entry->texture);
+	}
+	SDL_DestroySurface(entry->surface);
+	SDL_free(entry);
+}
 
-	dstwidthhalf = MAX((int)
-		ceil(MAX(MAX(MAX(fabs(cx + sy), fabs(cx - sy)), fabs(-cx + sy)), fabs(-cx - sy))), 1);
-	dstheighthalf = MAX((int)
-		ceil(MAX(MAX(MAX(fabs(sx + cy), fabs(sx - cy)), fabs(-sx + cy)), fabs(-sx - cy))), 1);
-	*dstwidth = 2 * dstwidthhalf;
-	*dstheight = 2 * dstheighthalf;
+/*!
+\brief Internal move of a frame to the newest end of the LRU list.
+*/
+static void _rotozoomCacheTouch(rotozoomCache *cache, _rotozoomCacheEntry *entry)
+{
+	if (cache->newest == entry) {
+		return;
+	}
+	if (entry->newer) {
+		entry->newer->older = entry->older;
+	}
+	if (entry->older) {
+		entry->older->newer = entry->newer;
+	} else {
+		cache->oldest = entry->newer;
+	}
+	entry->older = cache->newest;
+	entry->newer = NULL;
+	if (cache->newest) {
+		cache->newest->newer = entry;
+	}
+	cache->newest = entry;
+	if (cache->oldest == NULL) {
+		cache->oldest = entry;
+	}
 }
 
-/*! 
-\brief Returns the size of the resulting target surface for a rotozoomSurfaceXY() call. 
+/*!
+\brief Internal eviction of the least recently used frames until the cache fits its budget.
 
-\param width The source surface width.
-\param height The source surface height.
-\param angle The angle to rotate in degrees.
-\param zoomx The horizontal scaling factor.
-\param zoomy The vertical scaling factor.
-\param dstwidth The calculated width of the rotozoomed destination surface.
-\param dstheight The calculated height of the rotozoomed destination surface.
+\param cache The cache.
+\param keep The frame which must stay cached.
 */
-void rotozoomSurfaceSizeXY(int width, int height, double angle, double zoomx, double zoomy, int *dstwidth, int *dstheight)
+static void _rotozoomCacheTrim(rotozoomCache *cache, _rotozoomCacheEntry *keep)
 {
-	double dummy_sanglezoom, dummy_canglezoom;
+	_rotozoomCacheEntry *entry;
 
-	_rotozoomSurfaceSizeTrig(width, height, angle, zoomx, zoomy, dstwidth, dstheight, &dummy_sanglezoom, &dummy_canglezoom);
+	while ((cache->bytes > cache->budget) && (cache->oldest != NULL) && (cache->oldest != keep)) {
+		entry = cache->oldest;
+		_rotozoomCacheUnlink(cache, entry);
+		_rotozoomCacheFree(entry);
+	}
 }
 
-/*! 
-\brief Returns the size of the resulting target surface for a rotozoomSurface() call. 
-
-\param width The source surface width.
-\param height The source surface height.
-\param angle The angle to rotate in degrees.
-\param zoom The scaling factor.
-\param dstwidth The calculated width of the rotozoomed destination surface.
-\param dstheight The calculated height of the rotozoomed destination surface.
+/*!
+\brief Internal doubling of the number of hash buckets of a cache.
 */
-void rotozoomSurfaceSize(int width, int height, double angle, double zoom, int *dstwidth, int *dstheight)
+static void _rotozoomCacheGrow(rotozoomCache *cache)
 {
-	double dummy_sanglezoom, dummy_canglezoom;
+	_rotozoomCacheEntry **table, *entry, *next;
+	int i, buckets;
 
-	_rotozoomSurfaceSizeTrig(width, height, angle, zoom, zoom, dstwidth, dstheight, &dummy_sanglezoom, &dummy_canglezoom);
+	buckets = cache->buckets * 2;
+	if ((table = (_rotozoomCacheEntry **) SDL_calloc(buckets, sizeof(*table))) == NULL) {
+		return;
+	}
+	for (i = 0; i < cache->buckets; i++) {
+		for (entry = cache->table[i]; entry != NULL; entry = next) {
+			next = entry->next;
+			entry->next = table[entry->hash & (buckets - 1)];
+			table[entry->hash & (buckets - 1)] = entry;
+		}
+	}
+	SDL_free(cache->table);
+	cache->table = table;
+	cache->buckets = buckets;
 }
 
 /*!
-\brief Rotates and zooms a surface and optional anti-aliasing. 
+\brief Internal cleanup callback of the renderer property of a cache, forgets the textures of a destroyed renderer.
 
-Rotates and zoomes a 32bit or 8bit 'src' surface to newly created 'dst' surface.
-'angle' is the rotation in degrees and 'zoom' a scaling factor. If 'smooth' is set
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+The renderer releases its textures itself, so they are not destroyed here.
+Renderers the cache did not register with are ignored.
+
+\param userdata The cache.
+\param value The renderer being destroyed.
+*/
+static void SDLCALL _rotozoomCacheRendererDestroyed(void *userdata, void *value)
+{
+	rotozoomCache *cache = (rotozoomCache *) userdata;
+	_rotozoomCacheEntry *entry;
+	int i;
+
+	for (i = 0; i < cache->numRenderers; i++) {
+		if (cache->renderers[i] == (SDL_Renderer *) value) {
+			break;
+		}
+	}
+	if (i == cache->numRenderers) {
+		return;
+	}
+	cache->renderers[i] = cache->renderers[--cache->numRenderers];
+	for (entry = cache->newest; entry != NULL; entry = entry->older) {
+		if (entry->renderer == (SDL_Renderer *) value) {
+			cache->bytes -= entry->bytes;
+			entry->texture = NULL;
+			entry->renderer = NULL;
+			entry->bytes = (size_t) entry->surface->pitch * entry->surface->h;
+			cache->bytes += entry->bytes;
+		}
+	}
+}
 
-\param src The surface to rotozoom.
-\param angle The angle to rotate in degrees.
-\param zoom The scaling factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+/*!
+\brief Internal registration of a cache with a renderer, so its textures are dropped when the renderer is destroyed.
 
-\return The new rotozoomed surface.
+\return 0 for success or -1 for error.
 */
-SDL_Surface *rotozoomSurface(SDL_Surface * src, double angle, double zoom, int smooth)
+static int _rotozoomCacheRegister(rotozoomCache *cache, SDL_Renderer * renderer)
 {
-	return rotozoomSurfaceXY(src, angle, zoom, zoom, smooth);
+	SDL_Renderer **renderers;
+	SDL_PropertiesID props;
+	int i;
+
+	for (i = 0; i < cache->numRenderers; i++) {
+		if (cache->renderers[i] == renderer) {
+			return (0);
+		}
+	}
+	props = SDL_GetRendererProperties(renderer);
+	if (props == 0) {
+		return (-1);
+	}
+	renderers = (SDL_Renderer **) SDL_realloc(cache->renderers, (cache->numRenderers + 1) * sizeof(*renderers));
+	if (renderers == NULL) {
+		return (-1);
+	}
+	cache->renderers = renderers;
+	if (!SDL_SetPointerPropertyWithCleanup(props, cache->property, renderer, _rotozoomCacheRendererDestroyed, cache)) {
+		return (-1);
+	}
+	cache->renderers[cache->numRenderers++] = renderer;
+	return (0);
 }
 
 /*!
-\brief Rotates and zooms a surface with different horizontal and vertival scaling factors and optional anti-aliasing. 
-
-Rotates and zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
-'angle' is the rotation in degrees, 'zoomx and 'zoomy' scaling factors. If 'smooth' is set
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+\brief Internal lookup of a frame, rotating and storing it on a miss.
 
-\param src The surface to rotozoom.
-\param angle The angle to rotate in degrees.
-\param zoomx The horizontal scaling factor.
-\param zoomy The vertical scaling factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
-
-\return The new rotozoomed surface.
+\return The frame or NULL on error.
 */
-SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth)
+static _rotozoomCacheEntry *_rotozoomCacheLookup(rotozoomCache *cache, SDL_Surface * src, double angle, double zoom, int smooth)
 {
-	SDL_Surface *rz_src;
-	SDL_Surface *rz_dst;
-	double zoominv;
-	double sanglezoom, canglezoom, sanglezoominv, canglezoominv;
-	int dstwidthhalf, dstwidth, dstheighthalf, dstheight;
-	int is32bit;
-	int i, src_converted;
-	int flipx,flipy;
-	const SDL_PixelFormatDetails* details;
-	SDL_Palette* pal_dst;
-	SDL_Palette* pal_src;
+	_rotozoomCacheEntry *entry;
+	Uint32 hash;
+	int step;
 
-	/*
-	* Sanity check 
-	*/
-	if (src == NULL) {
+	if ((cache == NULL) || (src == NULL)) {
 		return (NULL);
 	}
 
 	/*
-	* Determine if source surface is 32bit or 8bit 
+	* Quantize the angle to the nearest step 
 	*/
-	details = SDL_GetPixelFormatDetails(src->format);
-	is32bit = (details->bits_per_pixel == 32);
-	if ((is32bit) || (details->bits_per_pixel == 8)) {
-		/*
-		* Use source surface 'as is' 
-		*/
-		rz_src = src;
-		src_converted = 0;
-	} else {
-		/*
-		* New source surface is 32bit with a defined RGBA ordering 
-		*/
-		rz_src =
-			SDL_CreateSurface(src->w, src->h, SDL_PIXELFORMAT_RGBA32);
-
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
-
-		src_converted = 1;
-		is32bit = 1;
+	step = (int) floor(fmod(angle, 360.0) / cache->quantum + 0.5);
+	step %= cache->steps;
+	if (step < 0) {
+		step += cache->steps;
 	}
 
-	/*
-	* Sanity check zoom factor 
-	*/
-	flipx = (zoomx<0.0);
-	if (flipx) zoomx=-zoomx;
-	flipy = (zoomy<0.0);
-	if (flipy) zoomy=-zoomy;
-	if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
-	if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
-	zoominv = 65536.0 / (zoomx * zoomx);
+	hash = _rotozoomCacheHash(src, step, zoom, smooth);
+	for (entry = cache->table[hash & (cache->buckets - 1)]; entry != NULL; entry = entry->next) {
+		if ((entry->hash == hash) && (entry->src == src) && (entry->step == step) && (entry->zoom == zoom) && (entry->smooth == smooth)) {
+			_rotozoomCacheTouch(cache, entry);
+			return (entry);
+		}
+	}
 
 	/*
-	* Check if we have a rotozoom or just a zoom 
+	* Miss: rotate and add as the newest frame 
 	*/
-	if (fabs(angle) > VALUE_LIMIT) {
+	if ((entry = (_rotozoomCacheEntry *) SDL_calloc(1, sizeof(*entry))) == NULL) {
+		return (NULL);
+	}
+	entry->surface = rotozoomSurface(src, step * cache->quantum, zoom, smooth);
+	if (entry->surface == NULL) {
+		SDL_free(entry);
+		return (NULL);
+	}
+	entry->src = src;
+	entry->step = step;
+	entry->zoom = zoom;
+	entry->smooth = smooth;
+	entry->hash = hash;
+	entry->bytes = (size_t) entry->surface->pitch * entry->surface->h;
+	if (cache->count >= cache->buckets) {
+		_rotozoomCacheGrow(cache);
+	}
+	entry->next = cache->table[hash & (cache->buckets - 1)];
+	cache->table[hash & (cache->buckets - 1)] = entry;
+	entry->older = cache->newest;
+	if (cache->newest) {
+		cache->newest->newer = entry;
+	} else {
+		cache->oldest = entry;
+	}
+	cache->newest = entry;
+	cache->bytes += entry->bytes;
+	cache->count++;
+	_rotozoomCacheTrim(cache, entry);
 
-		/*
-		* Angle!=0: full rotozoom 
-		*/
-		/*
-		* ----------------------- 
-		*/
+	return (entry);
+}
 
-		/* Determine target size */
-		_rotozoomSurfaceSizeTrig(rz_src->w, rz_src->h, angle, zoomx, zoomy, &dstwidth, &dstheight, &canglezoom, &sanglezoom);
+/*!
+\brief Create a cache of rotated frames.
+
+The cache stores rotozoomSurface() results of sprites for angles rounded to
+multiples of 'quantum' degrees and returns them on later requests, so rotating
+the same sprites every frame turns into a lookup. Frames are generated on first
+use; when the pixels of all frames (surfaces and textures) exceed 'budget'
+bytes, the least recently used frames are evicted. Frames are keyed by the
+source surface pointer, so sources must not be modified or freed while they
+have frames in the cache; see rotozoomCacheInvalidate(). Textures of a
+destroyed renderer are dropped from the cache automatically. The cache is not
+thread safe.
+
+\param quantum The angle step in degrees, e.g. 2.0; values <= 0 are treated as 1.
+\param budget The maximum number of bytes of cached pixels.
+
+\return The new cache or NULL on error.
+*/
+rotozoomCache *rotozoomCacheCreate(double quantum, size_t budget)
+{
+	rotozoomCache *cache;
 
-		/*
-		* Calculate target factors from sin/cos and zoom 
-		*/
-		sanglezoominv = sanglezoom;
-		canglezoominv = canglezoom;
-		sanglezoominv *= zoominv;
-		canglezoominv *= zoominv;
+	if ((cache = (rotozoomCache *) SDL_calloc(1, sizeof(rotozoomCache))) == NULL) {
+		return (NULL);
+	}
+	if (quantum <= 0.0) {
+		quantum = 1.0;
+	}
+	cache->steps = (int) ceil(360.0 / quantum - VALUE_LIMIT);
+	if (cache->steps < 1) {
+		cache->steps = 1;
+	}
+	cache->quantum = quantum;
+	cache->budget = budget;
+	cache->buckets = ROTOZOOMCACHE_BUCKETS;
+	if ((cache->table = (_rotozoomCacheEntry **) SDL_calloc(cache->buckets, sizeof(*cache->table))) == NULL) {
+		SDL_free(cache);
+		return (NULL);
+	}
+	SDL_snprintf(cache->property, sizeof(cache->property), "SDL_gfx.rotozoom_cache.%p", (void *) cache);
+	return (cache);
+}
 
-		/* Calculate half size */
-		dstwidthhalf = dstwidth / 2;
-		dstheighthalf = dstheight / 2;
+/*!
+\brief Get a cached rotated and zoomed frame of a surface.
 
-		/*
-		* Alloc space to completely contain the rotated surface 
-		*/
-		rz_dst = NULL;
-		if (is32bit) {
-			/*
-			* Target surface is 32bit with source RGBA/ABGR ordering 
-			*/
-			rz_dst =
-				SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, rz_src->format);
-		} else {
-			/*
-			* Target surface is 8bit 
-			*/
-			rz_dst = SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, SDL_PIXELFORMAT_INDEX8);
-			pal_dst = SDL_CreateSurfacePalette(rz_dst);
-		}
+Returns the rotozoomSurface() result for 'angle' rounded to the nearest
+multiple of the cache quantum, generating it if it is not cached yet. The
+surface belongs to the cache and stays valid until the next
+rotozoomCacheGet(), rotozoomCacheGetTexture() or rotozoomCacheInvalidate()
+call may evict it.
 
-		/* Check target */
-		if (rz_dst == NULL)
-			return NULL;
+\param cache The cache.
+\param src The source surface.
+\param angle The angle to rotate in degrees.
+\param zoom The scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
 
-		/* Adjust for guard rows */
-		rz_dst->h = dstheight;
+\return The cached surface or NULL on error.
+*/
+SDL_Surface *rotozoomCacheGet(rotozoomCache *cache, SDL_Surface * src, double angle, double zoom, int smooth)
+{
+	_rotozoomCacheEntry *entry;
 
-		/*
-		* Lock source surface 
-		*/
-		if (SDL_MUSTLOCK(rz_src)) {
-			SDL_LockSurface(rz_src);
-		}
+	entry = _rotozoomCacheLookup(cache, src, angle, zoom, smooth);
+	return (entry) ? entry->surface : NULL;
+}
 
-		/*
-		* Check which kind of surface we have 
-		*/
-		if (is32bit) {
-			/*
-			* Call the 32bit transformation routine to do the rotation (using alpha) 
-			*/
-			_transformSurfaceRGBA(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
-				(int) (sanglezoominv), (int) (canglezoominv), 
-				flipx, flipy,
-				smooth);
-		} else {
-			/*
-			* Copy palette and colorkey info 
-			*/
-			pal_src = SDL_GetSurfacePalette(rz_src);
-			for (i = 0; i < pal_src->ncolors; i++) {
-				pal_dst->colors[i] = pal_src->colors[i];
-			}
-			pal_dst->ncolors = pal_src->ncolors;
-			/*
-			* Call the 8bit transformation routine to do the rotation 
-			*/
-			transformSurfaceY(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
-				(int) (sanglezoominv), (int) (canglezoominv),
-				flipx, flipy);
-		}
-		/*
-		* Unlock source surface 
-		*/
-		if (SDL_MUSTLOCK(rz_src)) {
-			SDL_UnlockSurface(rz_src);
-		}
+/*!
+\brief Get a cached rotated and zoomed frame of a surface as texture.
 
-	} else {
+Like rotozoomCacheGet(), but returns a texture of the frame for 'renderer',
+created on first use and kept with the frame. The texture belongs to the cache;
+a frame keeps the texture of one renderer at a time. The cache tracks the
+renderer through its properties and forgets its textures when it is destroyed.
 
-		/*
-		* Angle=0: Just a zoom 
-		*/
-		/*
-		* -------------------- 
-		*/
+\param cache The cache.
+\param renderer The renderer to create the texture with.
+\param src The source surface.
+\param angle The angle to rotate in degrees.
+\param zoom The scaling factor.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable, optionally with SMOOTHING_PREMULTIPLIED.
 
-		/*
-		* Calculate target size
-		*/
-		zoomSurfaceSize(rz_src->w, rz_src->h, zoomx, zoomy, &dstwidth, &dstheight);
+\return The cached texture or NULL on error.
+*/
+SDL_Texture *rotozoomCacheGetTexture(rotozoomCache *cache, SDL_Renderer * renderer, SDL_Surface * src, double angle, double zoom, int smooth)
+{
+	_rotozoomCacheEntry *entry;
 
-		/*
-		* Alloc space to completely contain the zoomed surface 
-		*/
-		rz_dst = NULL;
-		if (is32bit) {
-			/*
-			* Target surface is 32bit with source RGBA/ABGR ordering 
-			*/
-			rz_dst =
-				SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, rz_src->format);
-		} else {
-			/*
-			* Target surface is 8bit 
-			*/
-			rz_dst = SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, SDL_PIXELFORMAT_INDEX8);
-			pal_dst = SDL_CreateSurfacePalette(rz_dst);
+	if (renderer == NULL) {
+		return (NULL);
+	}
+	entry = _rotozoomCacheLookup(cache, src, angle, zoom, smooth);
+	if (entry == NULL) {
+		return (NULL);
+	}
+	if (entry->texture != NULL) {
+		if (entry->renderer == renderer) {
+			return (entry->texture);
 		}
+		SDL_DestroyTexture(entry->texture);
+		entry->texture = NULL;
+	}
+	if (_rotozoomCacheRegister(cache, renderer) == 0) {
+		entry->texture = SDL_CreateTextureFromSurface(renderer, entry->surface);
+	}
+	entry->renderer = (entry->texture) ? renderer : NULL;
 
-		/* Check target */
-		if (rz_dst == NULL)
-			return NULL;
-
-		/* Adjust for guard rows */
-		rz_dst->h = dstheight;
+	/*
+	* Account for the texture as a second copy of the pixels 
+	*/
+	cache->bytes -= entry->bytes;
+	entry->bytes = (size_t) entry->surface->pitch * entry->surface->h * ((entry->texture) ? 2 : 1);
+	cache->bytes += entry->bytes;
+	if (entry->texture == NULL) {
+		return (NULL);
+	}
+	_rotozoomCacheTrim(cache, entry);
 
-		/*
-		* Lock source surface 
-		*/
-		if (SDL_MUSTLOCK(rz_src)) {
-			SDL_LockSurface(rz_src);
-		}
+	return (entry->texture);
+}
 
-		/*
-		* Check which kind of surface we have 
-		*/
-		if (is32bit) {
-			/*
-			* Call the 32bit transformation routine to do the zooming (using alpha) 
-			*/
-			_zoomSurfaceRGBA(rz_src, rz_dst, flipx, flipy, smooth);
+/*!
+\brief Drop the cached frames of a source surface.
 
-		} else {
-			/*
-			* Copy palette and colorkey info 
-			*/
-			pal_src = SDL_GetSurfacePalette(rz_src);
-			for (i = 0; i < pal_src->ncolors; i++) {
-				pal_dst->colors[i] = pal_src->colors[i];
-			}
-			pal_dst->ncolors = pal_src->ncolors;
+Call before modifying or freeing a source surface with cached frames.
 
-			/*
-			* Call the 8bit transformation routine to do the zooming 
-			*/
-			_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
-		}
+\param cache The cache.
+\param src The source surface or NULL to drop all frames.
+*/
+void rotozoomCacheInvalidate(rotozoomCache *cache, SDL_Surface * src)
+{
+	_rotozoomCacheEntry *entry, *older;
 
-		/*
-		* Unlock source surface 
-		*/
-		if (SDL_MUSTLOCK(rz_src)) {
-			SDL_UnlockSurface(rz_src);
+	if (cache == NULL) {
+		return;
+	}
+	for (entry = cache->newest; entry != NULL; entry = older) {
+		older = entry->older;
+		if ((src == NULL) || (entry->src == src)) {
+			_rotozoomCacheUnlink(cache, entry);
+			_rotozoomCacheFree(entry);
 		}
 	}
+}
 
-	/*
-	* Cleanup temp surface 
-	*/
-	if (src_converted) {
-		SDL_DestroySurface(rz_src);
+/*!
+\brief Free a cache created with rotozoomCacheCreate() and all its frames.
+
+\param cache The cache to free; may be NULL.
+*/
+void rotozoomCacheDestroy(rotozoomCache *cache)
+{
+	SDL_Renderer *renderer;
+
+	if (cache == NULL) {
+		return;
 	}
+	rotozoomCacheInvalidate(cache, NULL);
 
 	/*
-	* Return destination surface 
+	* Unregister from the renderers; the cleanup callback removes each from the list 
 	*/
-	return (rz_dst);
+	while (cache->numRenderers > 0) {
+		renderer = cache->renderers[cache->numRenderers - 1];
+		SDL_ClearProperty(SDL_GetRendererProperties(renderer), cache->property);
+		if ((cache->numRenderers > 0) && (cache->renderers[cache->numRenderers - 1] == renderer)) {
+			cache->numRenderers--;
+		}
+	}
+	SDL_free(cache->renderers);
+	SDL_free(cache->table);
+	SDL_free(cache);
 }
 
 /*!
-\brief Calculates the size of the target surface for a zoomSurface() call.
+\brief Internal calculation of the target size for a shrinkSurface() call.
 
-The minimum size of the target surface is 1. The input factors can be positive or negative.
+\param width The source surface width.
+\param height The source surface height.
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+\param dstwidth Pointer to store the target width.
+\param dstheight Pointer to store the target height.
+*/
+static void _shrinkSurfaceSize(int width, int height, int factorx, int factory, int *dstwidth, int *dstheight)
+{
+	*dstwidth=width/factorx;
+	while (*dstwidth*factorx>width) { (*dstwidth)--; }
+	*dstheight=height/factory;
+	while (*dstheight*factory>height) { (*dstheight)--; }
+}
 
-\param width The width of the source surface to zoom.
-\param height The height of the source surface to zoom.
-\param zoomx The horizontal zoom factor.
-\param zoomy The vertical zoom factor.
-\param dstwidth Pointer to an integer to store the calculated width of the zoomed target surface.
-\param dstheight Pointer to an integer to store the calculated height of the zoomed target surface.
+/*! 
+\brief Shrink a surface by an integer ratio using averaging.
+
+Shrinks a 32bit or 8bit 'src' surface to a newly created 'dst' surface.
+'factorx' and 'factory' are the shrinking ratios (i.e. 2=1/2 the size,
+3=1/3 the size, etc.) The destination surface is antialiased by averaging
+the source box RGBA or Y information. 16bit and 24bit RGB(A) surfaces are
+shrunk in their own format. Other surfaces which are not 8bit
+or 32bit RGBA/ABGR will be converted into a 32bit RGBA format on the fly.
+The input surface is not modified. The output surface is newly allocated.
+
+\param src The surface to shrink.
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return The new, shrunken surface.
 */
-void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dstwidth, int *dstheight)
+/*@null@*/ 
+SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 {
+	SDL_Surface *rz_dst;
+	int dstwidth, dstheight;
+
 	/*
-	* Make zoom factors positive 
+	* Sanity check 
 	*/
-	int flipx, flipy;
-	flipx = (zoomx<0.0);
-	if (flipx) zoomx = -zoomx;
-	flipy = (zoomy<0.0);
-	if (flipy) zoomy = -zoomy;
+	if (src == NULL) {
+		return (NULL);
+	}
 
 	/*
-	* Sanity check zoom factors 
+	* Alloc space to completely contain the shrunken surface
+	* (with added guard rows)
 	*/
-	if (zoomx < VALUE_LIMIT) {
-		zoomx = VALUE_LIMIT;
+	_shrinkSurfaceSize(src->w, src->h, factorx, factory, &dstwidth, &dstheight);
+	rz_dst = _rotozoomCreateTarget(src, dstwidth, dstheight, 1);
+	if (rz_dst == NULL) {
+		return (NULL);
 	}
-	if (zoomy < VALUE_LIMIT) {
-		zoomy = VALUE_LIMIT;
+
+	if (shrinkSurfaceInto(src, rz_dst, factorx, factory, NULL, 0) != 0) {
+		SDL_DestroySurface(rz_dst);
+		return (NULL);
 	}
 
 	/*
-	* Calculate target size 
+	* Return destination surface 
 	*/
-	*dstwidth = (int) floor(((double) width * zoomx) + 0.5);
-	*dstheight = (int) floor(((double) height * zoomy) + 0.5);
-	if (*dstwidth < 1) {
-		*dstwidth = 1;
-	}
-	if (*dstheight < 1) {
-		*dstheight = 1;
-	}
+	return (rz_dst);
 }
 
 /*! 
-\brief Zoom a surface by independent horizontal and vertical factors with optional smoothing.
+\brief Shrink a surface by an integer ratio into an existing target surface.
 
-Zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
-'zoomx' and 'zoomy' are scaling factors for width and height. If 'smooth' is on
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
-If zoom factors are negative, the image is flipped on the axes.
+Like shrinkSurface(), but writes into 'dst' instead of allocating a new surface.
+'dst' must be (src->w / factorx) x (src->h / factory) pixels large and have the
+format shrinkSurface() would use: the source format for 32bit, 16bit and 24bit
+RGB(A) sources, SDL_PIXELFORMAT_INDEX8 for 8bit sources and SDL_PIXELFORMAT_RGBA32
+otherwise.
+If a scratch buffer of rotozoomSurfaceScratchSize() bytes is passed, only the
+SDL_Surface header of a converted source is allocated, plus one row of column
+sums per band for ratios other than 2x2.
 
-\param src The surface to zoom.
-\param zoomx The horizontal zoom factor.
-\param zoomy The vertical zoom factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param src The surface to shrink.
+\param dst The target surface.
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
 
-\return The new, zoomed surface.
+\return 0 for success or -1 for error.
 */
-SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smooth)
+int shrinkSurfaceInto(SDL_Surface *src, SDL_Surface *dst, int factorx, int factory, void *scratch, size_t scratchSize)
 {
+	int result;
 	SDL_Surface *rz_src;
-	SDL_Surface *rz_dst;
+	int *tables;
 	int dstwidth, dstheight;
-	int is32bit;
-	int i, src_converted;
-	int flipx, flipy;
-	const SDL_PixelFormatDetails* details;
-	SDL_Palette* pal_src;
-	SDL_Palette* pal_dst;
 
 	/*
 	* Sanity check 
 	*/
-	if (src == NULL)
-		return (NULL);
+	if ((src == NULL) || (factorx < 1) || (factory < 1)) {
+		return (-1);
+	}
+
+	/* Get size for target */
+	_shrinkSurfaceSize(src->w, src->h, factorx, factory, &dstwidth, &dstheight);
+	if (_rotozoomBegin(src, dst, dstwidth, dstheight, 1, scratch, scratchSize, &rz_src, &tables) != 0) {
+		return (-1);
+	}
 
 	/*
-	* Determine if source surface is 32bit or 8bit 
+	* Check which kind of surface we have 
 	*/
-	details = SDL_GetPixelFormatDetails(src->format);
-	is32bit = (details->bits_per_pixel == 32);
-	if ((is32bit) || (details->bits_per_pixel == 8)) {
+	if (SDL_BYTESPERPIXEL(dst->format) == 4) {
 		/*
-		* Use source surface 'as is' 
+		* Call the 32bit transformation routine to do the shrinking (using alpha) 
+		*/
+		result = _shrinkSurfaceRGBA(rz_src, dst, factorx, factory);		
+	} else if (SDL_BYTESPERPIXEL(dst->format) > 1) {
+		/*
+		* Call the 16bit/24bit transformation routine to do the shrinking 
 		*/
-		rz_src = src;
-		src_converted = 0;
+		result = _shrinkSurfaceN(rz_src, dst, factorx, factory);
 	} else {
 		/*
-		* New source surface is 32bit with a defined RGBA ordering 
+		* Call the 8bit transformation routine to do the shrinking 
 		*/
-		rz_src =
-			SDL_CreateSurface(src->w, src->h, SDL_PIXELFORMAT_RGBA32);
-		if (rz_src == NULL) {
-			return NULL;
-		}
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
-		src_converted = 1;
-		is32bit = 1;
+		result = _shrinkSurfaceY(rz_src, dst, factorx, factory);
 	}
 
-	flipx = (zoomx<0.0);
-	if (flipx) zoomx = -zoomx;
-	flipy = (zoomy<0.0);
-	if (flipy) zoomy = -zoomy;
+	_rotozoomEnd(src, rz_src, dst);
 
-	/* Get size if target */
-	zoomSurfaceSize(rz_src->w, rz_src->h, zoomx, zoomy, &dstwidth, &dstheight);
+	return (result);
+}
 
-	/*
-	* Alloc space to completely contain the zoomed surface 
-	*/
-	rz_dst = NULL;
-	if (is32bit) {
-		/*
-		* Target surface is 32bit with source RGBA/ABGR ordering 
-		*/
-		rz_dst =
-			SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, rz_src->format);
-	} else {
-		/*
-		* Target surface is 8bit 
-		*/
-		rz_dst = SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, SDL_PIXELFORMAT_INDEX8);
-		pal_dst = SDL_CreateSurfacePalette(rz_dst);
-	}
+/*!
+\brief Internal calculation of the target size for a shrinkSurfaceArea() call.
 
-	/* Check target */
-	if (rz_dst == NULL) {
-		/*
-		* Cleanup temp surface 
-		*/
-		if (src_converted) {
-			SDL_DestroySurface(rz_src);
-		}		
-		return NULL;
-	}
+\param width The source surface width.
+\param height The source surface height.
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+\param dstwidth Pointer to store the target width.
+\param dstheight Pointer to store the target height.
+*/
+static void _shrinkSurfaceAreaSize(int width, int height, double factorx, double factory, int *dstwidth, int *dstheight)
+{
+	*dstwidth = (int) ((double) width / factorx);
+	if (*dstwidth < 1) *dstwidth = 1;
+	*dstheight = (int) ((double) height / factory);
+	if (*dstheight < 1) *dstheight = 1;
+}
 
-	/* Adjust for guard rows */
-	rz_dst->h = dstheight;
+/*! 
+\brief Shrink a surface by arbitrary ratios using area averaging.
 
-	/*
-	* Lock source surface 
-	*/
-	if (SDL_MUSTLOCK(rz_src)) {
-		SDL_LockSurface(rz_src);
-	}
+Shrinks a 32bit or 8bit 'src' surface to a newly created 'dst' surface of
+(src->w / factorx) x (src->h / factory) pixels (rounded down, at least 1).
+Unlike shrinkSurface() the ratios need not be integers (e.g. 3.7): every
+destination pixel is the average of the source area it covers, with partly
+covered source pixels weighted by their coverage. Each source pixel is read
+once. If the surface is not 8bit or 32bit RGBA/ABGR it will be converted
+into a 32bit RGBA format on the fly.
+
+\param src The surface to shrink.
+\param factorx The horizontal shrinking ratio; must be at least 1.
+\param factory The vertical shrinking ratio; must be at least 1.
+
+\return The new, shrunken surface.
+*/
+/*@null@*/ 
+SDL_Surface *shrinkSurfaceArea(SDL_Surface *src, double factorx, double factory)
+{
+	SDL_Surface *rz_dst;
+	int dstwidth, dstheight;
 
 	/*
-	* Check which kind of surface we have 
+	* Sanity check 
 	*/
-	if (is32bit) {
-		/*
-		* Call the 32bit transformation routine to do the zooming (using alpha) 
-		*/
-		_zoomSurfaceRGBA(rz_src, rz_dst, flipx, flipy, smooth);
-	} else {
-		/*
-		* Copy palette and colorkey info 
-		*/
-		pal_src = SDL_GetSurfacePalette(rz_src);
-		for (i = 0; i < pal_src->ncolors; i++) {
-			pal_dst->colors[i] = pal_src->colors[i];
-		}
-		pal_dst->ncolors = pal_src->ncolors;
-		/*
-		* Call the 8bit transformation routine to do the zooming 
-		*/
-		_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
+	if ((src == NULL) || !(factorx >= 1.0) || !(factory >= 1.0)) {
+		return (NULL);
 	}
+
 	/*
-	* Unlock source surface 
+	* Alloc space to completely contain the shrunken surface
+	* (with added guard rows)
 	*/
-	if (SDL_MUSTLOCK(rz_src)) {
-		SDL_UnlockSurface(rz_src);
+	_shrinkSurfaceAreaSize(src->w, src->h, factorx, factory, &dstwidth, &dstheight);
+	rz_dst = _rotozoomCreateTarget(src, dstwidth, dstheight, 0);
+	if (rz_dst == NULL) {
+		return (NULL);
 	}
 
-	/*
-	* Cleanup temp surface 
-	*/
-	if (src_converted) {
-		SDL_DestroySurface(rz_src);
+	if (shrinkSurfaceAreaInto(src, rz_dst, factorx, factory, NULL, 0) != 0) {
+		SDL_DestroySurface(rz_dst);
+		return (NULL);
 	}
 
 	/*
@@ -1468,169 +6849,266 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 }
 
 /*! 
-\brief Shrink a surface by an integer ratio using averaging.
+\brief Shrink a surface by arbitrary ratios using area averaging into an existing target surface.
 
-Shrinks a 32bit or 8bit 'src' surface to a newly created 'dst' surface.
-'factorx' and 'factory' are the shrinking ratios (i.e. 2=1/2 the size,
-3=1/3 the size, etc.) The destination surface is antialiased by averaging
-the source box RGBA or Y information. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
-The input surface is not modified. The output surface is newly allocated.
+Like shrinkSurfaceArea(), but writes into 'dst' instead of allocating a new surface.
+'dst' must be (int)(src->w / factorx) x (int)(src->h / factory) pixels large
+(at least 1) and have the source format for 32bit sources, SDL_PIXELFORMAT_INDEX8
+for 8bit sources and SDL_PIXELFORMAT_RGBA32 otherwise. The scratch buffer
+is used for the conversion of sources which are not 8bit or 32bit; the
+coverage tables and row accumulators are always allocated.
 
 \param src The surface to shrink.
-\param factorx The horizontal shrinking ratio.
-\param factory The vertical shrinking ratio.
+\param dst The target surface.
+\param factorx The horizontal shrinking ratio; must be at least 1.
+\param factory The vertical shrinking ratio; must be at least 1.
+\param scratch Optional scratch buffer or NULL.
+\param scratchSize Size of the scratch buffer in bytes.
 
-\return The new, shrunken surface.
+\return 0 for success or -1 for error.
 */
-/*@null@*/ 
-SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
+int shrinkSurfaceAreaInto(SDL_Surface *src, SDL_Surface *dst, double factorx, double factory, void *scratch, size_t scratchSize)
 {
 	int result;
 	SDL_Surface *rz_src;
-	SDL_Surface *rz_dst = NULL;
+	int *tables;
 	int dstwidth, dstheight;
-	int is32bit;
-	int i, src_converted;
-	int haveError = 0;
-	const SDL_PixelFormatDetails* details;
-	SDL_Palette* pal_src;
-	SDL_Palette* pal_dst;
 
 	/*
 	* Sanity check 
 	*/
-	if (src == NULL) {
-		return (NULL);
+	if ((src == NULL) || !(factorx >= 1.0) || !(factory >= 1.0)) {
+		return (-1);
 	}
 
-	/*
-	* Determine if source surface is 32bit or 8bit 
-	*/
-	details = SDL_GetPixelFormatDetails(src->format);
-	is32bit = (details->bits_per_pixel == 32);
-	if ((is32bit) || (details->bits_per_pixel == 8)) {
-		/*
-		* Use source surface 'as is' 
-		*/
-		rz_src = src;
-		src_converted = 0;
+	/* Get size for target */
+	_shrinkSurfaceAreaSize(src->w, src->h, factorx, factory, &dstwidth, &dstheight);
+	if (_rotozoomBegin(src, dst, dstwidth, dstheight, 0, scratch, scratchSize, &rz_src, &tables) != 0) {
+		return (-1);
+	}
+
+	result = _shrinkSurfaceArea(rz_src, dst);
+
+	_rotozoomEnd(src, rz_src, dst);
+
+	return (result);
+}
+
+/*!
+\brief Internal 2x2 box filter row for 16bit and 24bit pixels; the math of _shrinkSurfaceN() for a 2x2 box.
+
+\param s0 The first source row.
+\param s1 The second source row.
+\param d The destination row.
+\param w The destination width.
+\param layout The channel layout of the pixels.
+*/
+static void _shrinkRow2x2N(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int w, const _pixelLayout *layout)
+{
+	int x, i, bpp;
+	Uint32 p00, p01, p10, p11, mask, result;
+
+	bpp = layout->bpp;
+	for (x = 0; x < w; x++) {
+		p00 = _getPixelN(s0, bpp);
+		p01 = _getPixelN(s0 + bpp, bpp);
+		p10 = _getPixelN(s1, bpp);
+		p11 = _getPixelN(s1 + bpp, bpp);
+		result = 0;
+		for (i = 0; i < layout->channels; i++) {
+			mask = layout->mask[i];
+			result |= ((((p00 & mask) >> layout->shift[i]) + ((p01 & mask) >> layout->shift[i]) +
+				((p10 & mask) >> layout->shift[i]) + ((p11 & mask) >> layout->shift[i])) >> 2) << layout->shift[i];
+		}
+		_putPixelN(d, bpp, result);
+		s0 += 2 * bpp;
+		s1 += 2 * bpp;
+		d += bpp;
+	}
+}
+
+/*!
+\brief Internal 2x2 box filter of one row of a mipmap level.
+
+\param kernel The row kernel of 32bit and 8bit levels.
+\param layout The channel layout of 16bit and 24bit levels or NULL.
+*/
+static void _mipChainRow(_shrinkRow2x2Func kernel, const _pixelLayout *layout, SDL_Surface * src, int y, SDL_Surface * dst)
+{
+	const Uint8 *s0, *s1;
+	Uint8 *d;
+
+	s0 = (const Uint8 *) src->pixels + (size_t) 2 * y * src->pitch;
+	s1 = s0 + src->pitch;
+	d = (Uint8 *) dst->pixels + (size_t) y * dst->pitch;
+	if (layout != NULL) {
+		_shrinkRow2x2N(s0, s1, d, dst->w, layout);
+	} else {
+		kernel(s0, s1, d, dst->w);
+	}
+}
+
+/*!
+\brief Internal generation of all levels of a mipmap chain in one pass.
+
+Every row of the first level is followed by the rows of the deeper levels it
+completes, so each level is filtered while its two source rows are still in
+the cache.
+
+\param src The source surface (of the format of the levels).
+\param chain The chain with allocated levels.
+*/
+static void _mipChainStream(SDL_Surface * src, mipChain *chain)
+{
+	_shrinkRow2x2Func kernel;
+	_pixelLayout layout, *nlayout;
+	int y, r, k, bpp;
+
+	bpp = SDL_BYTESPERPIXEL(chain->level[0]->format);
+	kernel = NULL;
+	nlayout = NULL;
+	if ((bpp == 2) || (bpp == 3)) {
+		_pixelLayoutInit(&layout, chain->level[0]->format);
+		nlayout = &layout;
 	} else {
+		kernel = _shrinkRow2x2Kernel(bpp);
+	}
+	for (y = 0; y < chain->level[0]->h; y++) {
+		_mipChainRow(kernel, nlayout, src, y, chain->level[0]);
+
 		/*
-		* New source surface is 32bit with a defined RGBA ordering 
+		* Cascade every completed pair of rows into the next level 
 		*/
-		rz_src = SDL_CreateSurface(src->w, src->h, SDL_PIXELFORMAT_RGBA32);
-		if (rz_src==NULL) {
-			haveError = 1;
-			goto exitShrinkSurface;
+		r = y;
+		for (k = 1; (k < chain->levels) && (r & 1) && ((r >> 1) < chain->level[k]->h); k++) {
+			r >>= 1;
+			_mipChainRow(kernel, nlayout, chain->level[k - 1], r, chain->level[k]);
 		}
-
-		SDL_BlitSurface(src, NULL, rz_src, NULL);
-		src_converted = 1;
-		is32bit = 1;
 	}
+}
+
+/*! 
+\brief Build a mipmap chain by repeated 2x2 box filtering.
+
+Creates up to 'levels' surfaces of half, quarter, ... the size of 'src'; level
+i is identical to applying shrinkSurface(..., 2, 2) i+1 times and has the same
+format: 16bit and 24bit RGB(A) levels keep the source format. All levels are
+produced in one pass over the source and share one pixel allocation. The chain
+stops early when a level would be smaller than 1x1 pixel. Other surfaces which
+are not 8bit or 32bit RGBA/ABGR will be converted into a 32bit RGBA format on
+the fly.
+
+\param src The surface to build the chain of.
+\param levels The number of levels to build; 0 or less builds all levels down to one pixel wide or high.
+
+\return The new chain or NULL on error. Free with freeMipChain().
+*/
+mipChain *buildMipChain(SDL_Surface *src, int levels)
+{
+	mipChain *chain;
+	SDL_Surface *rz_src;
+	SDL_PixelFormat format;
+	SDL_Palette *pal_src, *pal_dst;
+	int *tables;
+	int i, j, w, h, bpp, pitch;
+	size_t size;
+	Uint8 *pixels;
 
 	/*
-	* Lock the surface 
+	* Sanity check 
 	*/
-	if (SDL_MUSTLOCK(rz_src)) {
-		if (!SDL_LockSurface(rz_src)) {
-			haveError = 1;
-			goto exitShrinkSurface;
-		}
+	if (src == NULL) {
+		return (NULL);
 	}
 
-	/* Get size for target */
-	dstwidth=rz_src->w/factorx;
-	while (dstwidth*factorx>rz_src->w) { dstwidth--; }
-	dstheight=rz_src->h/factory;
-	while (dstheight*factory>rz_src->h) { dstheight--; }
+	/*
+	* Limit the number of levels to the source size 
+	*/
+	for (i = 0, w = src->w / 2, h = src->h / 2; (w > 0) && (h > 0) && ((levels < 1) || (i < levels)); i++, w /= 2, h /= 2);
+	if (i == 0) {
+		return (NULL);
+	}
+	levels = i;
 
 	/*
-	* Alloc space to completely contain the shrunken surface
-	* (with added guard rows)
+	* Alloc the chain, the level surfaces and their 16 byte aligned rows in one block 
 	*/
-	if (is32bit==1) {
-		/*
-		* Target surface is 32bit with source RGBA/ABGR ordering 
-		*/
-		rz_dst =
-			SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, rz_src->format);
-	} else {
-		/*
-		* Target surface is 8bit 
-		*/
-		rz_dst = SDL_CreateSurface(dstwidth, dstheight + GUARD_ROWS, SDL_PIXELFORMAT_INDEX8);
-		pal_dst = SDL_CreateSurfacePalette(rz_dst);
+	format = _rotozoomTargetFormat(src, 1);
+	bpp = SDL_BYTESPERPIXEL(format);
+	if ((chain = (mipChain *) SDL_malloc(sizeof(mipChain))) == NULL) {
+		return (NULL);
+	}
+	chain->levels = levels;
+	chain->level = (SDL_Surface **) SDL_calloc(levels, sizeof(SDL_Surface *));
+	size = 0;
+	for (i = 0, w = src->w / 2, h = src->h / 2; i < levels; i++, w /= 2, h /= 2) {
+		size += (size_t) ((w * bpp + 15) & ~15) * h;
+	}
+	chain->pixels = SDL_malloc(size);
+	if ((chain->level == NULL) || (chain->pixels == NULL)) {
+		freeMipChain(chain);
+		return (NULL);
+	}
+	pixels = (Uint8 *) chain->pixels;
+	for (i = 0, w = src->w / 2, h = src->h / 2; i < levels; i++, w /= 2, h /= 2) {
+		pitch = (w * bpp + 15) & ~15;
+		chain->level[i] = SDL_CreateSurfaceFrom(w, h, format, pixels, pitch);
+		if (chain->level[i] == NULL) {
+			freeMipChain(chain);
+			return (NULL);
+		}
+		if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+			SDL_CreateSurfacePalette(chain->level[i]);
+		}
+		pixels += (size_t) pitch * h;
 	}
 
-	/* Check target */
-	if (rz_dst == NULL) {
-		haveError = 1;
-		goto exitShrinkSurface;
+	if (_rotozoomBegin(src, chain->level[0], chain->level[0]->w, chain->level[0]->h, 1, NULL, 0, &rz_src, &tables) != 0) {
+		freeMipChain(chain);
+		return (NULL);
 	}
 
-	/* Adjust for guard rows */
-	rz_dst->h = dstheight;
+	_mipChainStream(rz_src, chain);
 
 	/*
-	* Check which kind of surface we have 
+	* Copy the palette to the deeper levels 
 	*/
-	if (is32bit==1) {
-		/*
-		* Call the 32bit transformation routine to do the shrinking (using alpha) 
-		*/
-		result = _shrinkSurfaceRGBA(rz_src, rz_dst, factorx, factory);		
-		if ((result!=0) || (rz_dst==NULL)) {
-			haveError = 1;
-			goto exitShrinkSurface;
-		}
-	} else {
-		/*
-		* Copy palette and colorkey info 
-		*/
-		pal_src = SDL_GetSurfacePalette(rz_src);
-		for (i = 0; i < pal_src->ncolors; i++) {
-			pal_dst->colors[i] = pal_src->colors[i];
-		}
-		pal_dst->ncolors = pal_src->ncolors;
-		/*
-		* Call the 8bit transformation routine to do the shrinking 
-		*/
-		result = _shrinkSurfaceY(rz_src, rz_dst, factorx, factory);
-		if (result!=0) {
-			haveError = 1;
-			goto exitShrinkSurface;
+	if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+		pal_src = SDL_GetSurfacePalette(chain->level[0]);
+		for (i = 1; i < levels; i++) {
+			pal_dst = SDL_GetSurfacePalette(chain->level[i]);
+			if ((pal_src != NULL) && (pal_dst != NULL)) {
+				for (j = 0; j < pal_src->ncolors; j++) {
+					pal_dst->colors[j] = pal_src->colors[j];
+				}
+				pal_dst->ncolors = pal_src->ncolors;
+			}
 		}
 	}
 
-exitShrinkSurface:
-	if (rz_src!=NULL) {
-		/*
-		* Unlock source surface 
-		*/
-		if (SDL_MUSTLOCK(rz_src)) {
-			SDL_UnlockSurface(rz_src);
-		}
+	_rotozoomEnd(src, rz_src, chain->level[0]);
 
-		/*
-		* Cleanup temp surface 
-		*/
-		if (src_converted==1) {
-			SDL_DestroySurface(rz_src);
-		}
-	}
+	return (chain);
+}
 
-	/* Check error state; maybe need to cleanup destination */
-	if (haveError==1) {
-		if (rz_dst!=NULL) {
-			SDL_DestroySurface(rz_dst);
-		}
-		rz_dst=NULL;
-	} 
+/*!
+\brief Free a chain created with buildMipChain().
 
-	/*
-	* Return destination surface 
-	*/
-	return (rz_dst);
+\param chain The chain to free; may be NULL.
+*/
+void freeMipChain(mipChain *chain)
+{
+	int i;
+
+	if (chain == NULL) {
+		return;
+	}
+	if (chain->level != NULL) {
+		for (i = 0; i < chain->levels; i++) {
+			SDL_DestroySurface(chain->level[i]);
+		}
+		SDL_free(chain->level);
+	}
+	SDL_free(chain->pixels);
+	SDL_free(chain);
 }
@@ -55,6 +55,73 @@ extern "C" {
 	*/
 #define SMOOTHING_ON		1
 
+	/*!
+	\brief Bicubic (Catmull-Rom) resampling; zoom only, rotations fall back to SMOOTHING_ON.
+	*/
+#define SMOOTHING_BICUBIC	2
+
+	/*!
+	\brief Lanczos-3 resampling; zoom only, rotations fall back to SMOOTHING_ON.
+	*/
+#define SMOOTHING_LANCZOS3	3
+
+	/*!
+	\brief Smoothing flag: smoothing of straight alpha pixels in premultiplied space (no dark fringes); or with SMOOTHING_ON, SMOOTHING_BICUBIC or SMOOTHING_LANCZOS3.
+	*/
+#define SMOOTHING_PREMULTIPLIED	0x400
+
+	/*!
+	\brief Zoom plan flag: mirror the image horizontally.
+	*/
+#define ZOOMPLAN_FLIPX		0x100
+
+	/*!
+	\brief Zoom plan flag: mirror the image vertically.
+	*/
+#define ZOOMPLAN_FLIPY		0x200
+
+	/*!
+	\brief Opaque zoom plan; see zoomPlanCreate().
+	*/
+	typedef struct zoomPlan zoomPlan;
+
+	/*!
+	\brief Opaque cache of rotated frames; see rotozoomCacheCreate().
+	*/
+	typedef struct rotozoomCache rotozoomCache;
+
+	/*!
+	\brief Mipmap chain; see buildMipChain().
+	*/
+	typedef struct mipChain {
+		int levels;		/*!< Number of levels. */
+		SDL_Surface **level;	/*!< The levels; level 0 is half the size of the source. */
+		void *pixels;		/*!< Pixel memory shared by all levels. */
+	} mipChain;
+
+	/*!
+	\brief A job of rotozoomSurfaceXYBatch().
+	*/
+	typedef struct rotozoomJob {
+		SDL_Surface *src;	/*!< The surface to rotozoom. */
+		double angle;		/*!< The angle to rotate in degrees. */
+		double zoomx;		/*!< The horizontal scaling factor. */
+		double zoomy;		/*!< The vertical scaling factor. */
+		int smooth;		/*!< Antialiasing flag. */
+		SDL_Surface *dst;	/*!< The target surface, or NULL to create it. */
+		int result;		/*!< Set to 0 for success or -1 for error. */
+	} rotozoomJob;
+
+	/*!
+	\brief Source callback of rotozoomSurfaceXYStream(); stores 'rows' source rows from row y into 'pixels', returns 0 on success.
+	*/
+	typedef int (*rotozoomSourceFunc)(void *userdata, int y, int rows, void *pixels, int pitch);
+
+	/*!
+	\brief Band callback of rotozoomSurfaceXYStream(); receives the destination rows y to y+band->h-1, returns 0 on success.
+	*/
+	typedef int (*rotozoomBandFunc)(void *userdata, int y, SDL_Surface * band);
+
 	/* ---- Function Prototypes */
 
 #ifdef _MSC_VER
@@ -81,6 +148,27 @@ extern "C" {
 	SDL3_ROTOZOOM_SCOPE SDL_Surface *rotozoomSurfaceXY
 		(SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth);
 
+	SDL3_ROTOZOOM_SCOPE int rotozoomSurfaceXYInto
+		(SDL_Surface * src, SDL_Surface * dst, double angle, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE int rotozoomSurfaceXYToTexture
+		(SDL_Surface * src, SDL_Texture * texture, double angle, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE SDL_Surface *rotozoomSurfaceXYRect
+		(SDL_Surface * src, const SDL_Rect * srcrect, double angle, double zoomx, double zoomy, int smooth);
+
+	SDL3_ROTOZOOM_SCOPE int rotozoomSurfaceXYRectInto
+		(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, double angle, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE int rotozoomSurfaceXYBatch(rotozoomJob *jobs, int numJobs);
+
+	SDL3_ROTOZOOM_SCOPE int rotozoomSurfaceXYStream
+		(int width, int height, SDL_PixelFormat format, double angle, double zoomx, double zoomy, int smooth,
+		int bandHeight, rotozoomSourceFunc source, rotozoomBandFunc band, void *userdata);
+
 
 	SDL3_ROTOZOOM_SCOPE void rotozoomSurfaceSize(int width, int height, double angle, double zoom, int *dstwidth,
 		int *dstheight);
@@ -97,8 +185,42 @@ extern "C" {
 
 	SDL3_ROTOZOOM_SCOPE SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smooth);
 
+	SDL3_ROTOZOOM_SCOPE int zoomSurfaceInto(SDL_Surface * src, SDL_Surface * dst, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE int zoomSurfaceToTexture(SDL_Surface * src, SDL_Texture * texture, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE SDL_Surface *zoomSurfaceRect(SDL_Surface * src, const SDL_Rect * srcrect, double zoomx, double zoomy, int smooth);
+
+	SDL3_ROTOZOOM_SCOPE int zoomSurfaceRectInto(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, double zoomx, double zoomy, int smooth,
+		void *scratch, size_t scratchSize);
+
 	SDL3_ROTOZOOM_SCOPE void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dstwidth, int *dstheight);
 
+	SDL3_ROTOZOOM_SCOPE zoomPlan *zoomPlanCreate(int srcw, int srch, int dstw, int dsth, int flags);
+
+	SDL3_ROTOZOOM_SCOPE int zoomPlanExecute(zoomPlan *plan, SDL_Surface * src, SDL_Surface * dst);
+
+	SDL3_ROTOZOOM_SCOPE void zoomPlanDestroy(zoomPlan *plan);
+
+	/* 
+
+	Rotation caches
+
+	*/
+
+	SDL3_ROTOZOOM_SCOPE rotozoomCache *rotozoomCacheCreate(double quantum, size_t budget);
+
+	SDL3_ROTOZOOM_SCOPE SDL_Surface *rotozoomCacheGet(rotozoomCache *cache, SDL_Surface * src, double angle, double zoom, int smooth);
+
+	SDL3_ROTOZOOM_SCOPE SDL_Texture *rotozoomCacheGetTexture(rotozoomCache *cache, SDL_Renderer * renderer, SDL_Surface * src,
+		double angle, double zoom, int smooth);
+
+	SDL3_ROTOZOOM_SCOPE void rotozoomCacheInvalidate(rotozoomCache *cache, SDL_Surface * src);
+
+	SDL3_ROTOZOOM_SCOPE void rotozoomCacheDestroy(rotozoomCache *cache);
+
 	/* 
 
 	Shrinking functions
@@ -107,6 +229,26 @@ extern "C" {
 
 	SDL3_ROTOZOOM_SCOPE SDL_Surface *shrinkSurface(SDL_Surface * src, int factorx, int factory);
 
+	SDL3_ROTOZOOM_SCOPE int shrinkSurfaceInto(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE SDL_Surface *shrinkSurfaceArea(SDL_Surface * src, double factorx, double factory);
+
+	SDL3_ROTOZOOM_SCOPE int shrinkSurfaceAreaInto(SDL_Surface * src, SDL_Surface * dst, double factorx, double factory,
+		void *scratch, size_t scratchSize);
+
+	SDL3_ROTOZOOM_SCOPE mipChain *buildMipChain(SDL_Surface * src, int levels);
+
+	SDL3_ROTOZOOM_SCOPE void freeMipChain(mipChain *chain);
+
+	/* 
+
+	Scratch buffer for the *Into() functions
+
+	*/
+
+	SDL3_ROTOZOOM_SCOPE size_t rotozoomSurfaceScratchSize(SDL_Surface * src, int dstwidth, int dstheight);
+
 	/* 
 
 	Specialized rotation functions
@@ -115,6 +257,16 @@ extern "C" {
 
 	SDL3_ROTOZOOM_SCOPE SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns);
 
+	/*
+
+	Tuning functions
+
+	*/
+
+	SDL3_ROTOZOOM_SCOPE void rotozoomSetSIMD(int enable);
+
+	SDL3_ROTOZOOM_SCOPE void rotozoomSetThreads(int numThreads, int minRowsPerBand);
+
 	/* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -0,0 +1,349 @@
+/*
+
+benchrotozoom.c: headless benchmark of the SDL_Surface rotozoom functions
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely.
+
+Runs zoomSurface, rotozoomSurfaceXY, shrinkSurface and rotateSurface90Degrees
+over a matrix of source sizes, formats, angles, zoom factors and smoothing
+modes and prints one record per case as CSV (default) or JSON.
+
+Usage: BenchRotozoom [--json] [--maxsize N] [--threads N] [--nosimd] [--time S]
+
+  --json       Print a JSON array instead of CSV.
+  --maxsize N  Skip sources whose width exceeds N (e.g. 1024 for a quick run).
+  --threads N  Threads of the rotozoomer (rotozoomSetThreads; 0 = all cores).
+  --nosimd     Disable the SIMD kernels (rotozoomSetSIMD).
+  --time S     Minimum measuring time per case in seconds (default 0.25).
+
+Throughput is reported as destination megapixels per second. Allocations
+are the SDL_malloc/SDL_calloc/SDL_realloc calls per call; SDL3_rotozoom
+allocates through these as well, so they include its scratch buffers and
+zoomer tables besides surfaces, palettes and format details.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include "SDL3_rotozoom.h"
+
+/* Largest destination that is measured (in pixels) */
+#define MAX_DST_PIXELS	(64 * 1024 * 1024)
+
+/* Benchmarked operations */
+#define OP_ZOOM		0
+#define OP_ROTOZOOM	1
+#define OP_SHRINK	2
+#define OP_ROTATE90	3
+
+static const char *opNames[] = { "zoomSurface", "rotozoomSurfaceXY", "shrinkSurface", "rotateSurface90Degrees" };
+
+/* Source sizes (256x256 to 8K UHD) */
+static const int sizes[][2] = {
+	{ 256, 256 }, { 512, 512 }, { 1024, 1024 }, { 1920, 1080 }, { 3840, 2160 }, { 7680, 4320 }
+};
+
+/* Source formats (8, 24 and 32 bit) */
+static const SDL_PixelFormat formats[] = { SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGBA32 };
+static const char *formatNames[] = { "8", "24", "32" };
+
+static const double zoomFactors[] = { 0.5, 1.0, 1.5, 2.0 };
+static const double rotateAngles[] = { 0.0, 30.0, 45.0, 90.0 };
+static const double rotateZooms[] = { 0.5, 1.0 };
+static const int shrinkFactors[] = { 2, 3, 4 };
+static const int quarterTurns[] = { 1, 2, 3 };
+
+#define COUNT(a)	((int) (sizeof(a) / sizeof((a)[0])))
+
+/* Options */
+int json = 0;
+int maxSize = 0;
+double minTime = 0.25;
+
+/* Number of records printed */
+int records = 0;
+
+/* Allocation counting through the SDL memory functions */
+static SDL_malloc_func realMalloc;
+static SDL_calloc_func realCalloc;
+static SDL_realloc_func realRealloc;
+static SDL_free_func realFree;
+static SDL_AtomicInt allocations;
+
+static void *SDLCALL countingMalloc(size_t size)
+{
+	SDL_AddAtomicInt(&allocations, 1);
+	return realMalloc(size);
+}
+
+static void *SDLCALL countingCalloc(size_t nmemb, size_t size)
+{
+	SDL_AddAtomicInt(&allocations, 1);
+	return realCalloc(nmemb, size);
+}
+
+static void *SDLCALL countingRealloc(void *mem, size_t size)
+{
+	SDL_AddAtomicInt(&allocations, 1);
+	return realRealloc(mem, size);
+}
+
+/* One benchmark case */
+typedef struct {
+	int op;
+	int format;
+	int width;
+	int height;
+	double angle;
+	double zoomx;
+	double zoomy;
+	int smooth;
+	int factor;
+} BenchCase;
+
+/* Runs the operation once; returns the result surface or NULL */
+SDL_Surface *RunCase(const BenchCase *c, SDL_Surface *src)
+{
+	switch (c->op) {
+	case OP_ZOOM:
+		return zoomSurface(src, c->zoomx, c->zoomy, c->smooth);
+	case OP_ROTOZOOM:
+		return rotozoomSurfaceXY(src, c->angle, c->zoomx, c->zoomy, c->smooth);
+	case OP_SHRINK:
+		return shrinkSurface(src, c->factor, c->factor);
+	case OP_ROTATE90:
+		return rotateSurface90Degrees(src, c->factor);
+	}
+	return NULL;
+}
+
+/* Estimates the destination size of a case, so that huge outputs can be skipped */
+void CaseSize(const BenchCase *c, int *dstw, int *dsth)
+{
+	switch (c->op) {
+	case OP_ZOOM:
+		zoomSurfaceSize(c->width, c->height, c->zoomx, c->zoomy, dstw, dsth);
+		break;
+	case OP_ROTOZOOM:
+		rotozoomSurfaceSizeXY(c->width, c->height, c->angle, c->zoomx, c->zoomy, dstw, dsth);
+		break;
+	case OP_SHRINK:
+		*dstw = c->width / c->factor;
+		*dsth = c->height / c->factor;
+		break;
+	default:
+		*dstw = (c->factor & 1) ? c->height : c->width;
+		*dsth = (c->factor & 1) ? c->width : c->height;
+		break;
+	}
+}
+
+/* Creates a source surface filled with a deterministic pattern */
+SDL_Surface *CreateSource(int width, int height, SDL_PixelFormat format)
+{
+	SDL_Surface *src;
+	SDL_Palette *palette;
+	Uint8 *row;
+	Uint32 seed = 0x12345678;
+	int x, y, i;
+
+	src = SDL_CreateSurface(width, height, format);
+	if (src == NULL) {
+		return NULL;
+	}
+	if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+		palette = SDL_CreateSurfacePalette(src);
+		if (palette == NULL) {
+			SDL_DestroySurface(src);
+			return NULL;
+		}
+		for (i = 0; i < palette->ncolors; i++) {
+			palette->colors[i].r = (Uint8) i;
+			palette->colors[i].g = (Uint8) i;
+			palette->colors[i].b = (Uint8) i;
+			palette->colors[i].a = 255;
+		}
+	}
+	for (y = 0; y < height; y++) {
+		row = (Uint8 *) src->pixels + (size_t) y * src->pitch;
+		for (x = 0; x < src->pitch; x++) {
+			seed = seed * 1664525 + 1013904223;
+			row[x] = (Uint8) (seed >> 24);
+		}
+	}
+
+	return src;
+}
+
+/* Measures one case and prints its record */
+void BenchmarkCase(const BenchCase *c, SDL_Surface *src)
+{
+	SDL_Surface *dst;
+	Uint64 frequency, start, elapsed;
+	int dstw, dsth, iterations, allocs;
+	double seconds, msPerCall, mpixPerSec;
+
+	CaseSize(c, &dstw, &dsth);
+	if ((dstw <= 0) || (dsth <= 0) || ((Sint64) dstw * dsth > MAX_DST_PIXELS)) {
+		return;
+	}
+
+	/* Warm up (thread pool, caches) and check the result */
+	dst = RunCase(c, src);
+	if (dst == NULL) {
+		fprintf(stderr, "%s failed: %s\n", opNames[c->op], SDL_GetError());
+		return;
+	}
+	dstw = dst->w;
+	dsth = dst->h;
+	SDL_DestroySurface(dst);
+
+	frequency = SDL_GetPerformanceFrequency();
+	SDL_SetAtomicInt(&allocations, 0);
+	iterations = 0;
+	start = SDL_GetPerformanceCounter();
+	do {
+		dst = RunCase(c, src);
+		SDL_DestroySurface(dst);
+		iterations++;
+		elapsed = SDL_GetPerformanceCounter() - start;
+	} while ((iterations < 3) || ((double) elapsed / frequency < minTime));
+	allocs = SDL_GetAtomicInt(&allocations);
+
+	seconds = (double) elapsed / frequency;
+	msPerCall = 1000.0 * seconds / iterations;
+	mpixPerSec = (double) dstw * dsth * iterations / seconds / 1.0e6;
+
+	if (json) {
+		printf("%s\n  {\"op\": \"%s\", \"bpp\": %s, \"width\": %d, \"height\": %d, "
+			"\"angle\": %g, \"zoomx\": %g, \"zoomy\": %g, \"smooth\": %d, \"factor\": %d, "
+			"\"dst_width\": %d, \"dst_height\": %d, \"iterations\": %d, "
+			"\"ms_per_call\": %.4f, \"mpix_per_sec\": %.2f, \"allocs_per_call\": %.2f}",
+			(records > 0) ? "," : "",
+			opNames[c->op], formatNames[c->format], c->width, c->height,
+			c->angle, c->zoomx, c->zoomy, c->smooth, c->factor,
+			dstw, dsth, iterations, msPerCall, mpixPerSec, (double) allocs / iterations);
+	} else {
+		printf("%s,%s,%d,%d,%g,%g,%g,%d,%d,%d,%d,%d,%.4f,%.2f,%.2f\n",
+			opNames[c->op], formatNames[c->format], c->width, c->height,
+			c->angle, c->zoomx, c->zoomy, c->smooth, c->factor,
+			dstw, dsth, iterations, msPerCall, mpixPerSec, (double) allocs / iterations);
+	}
+	fflush(stdout);
+	records++;
+}
+
+/* Runs all cases of one source surface */
+void BenchmarkSource(SDL_Surface *src, int format)
+{
+	BenchCase c;
+	int i, j, smooth;
+
+	memset(&c, 0, sizeof(c));
+	c.format = format;
+	c.width = src->w;
+	c.height = src->h;
+
+	c.op = OP_ZOOM;
+	for (i = 0; i < COUNT(zoomFactors); i++) {
+		for (smooth = 0; smooth <= 1; smooth++) {
+			c.zoomx = c.zoomy = zoomFactors[i];
+			c.smooth = smooth;
+			BenchmarkCase(&c, src);
+		}
+	}
+
+	c.op = OP_ROTOZOOM;
+	for (i = 0; i < COUNT(rotateAngles); i++) {
+		for (j = 0; j < COUNT(rotateZooms); j++) {
+			for (smooth = 0; smooth <= 1; smooth++) {
+				c.angle = rotateAngles[i];
+				c.zoomx = c.zoomy = rotateZooms[j];
+				c.smooth = smooth;
+				BenchmarkCase(&c, src);
+			}
+		}
+	}
+
+	c.angle = 0.0;
+	c.zoomx = c.zoomy = 0.0;
+	c.smooth = 0;
+	c.op = OP_SHRINK;
+	for (i = 0; i < COUNT(shrinkFactors); i++) {
+		c.factor = shrinkFactors[i];
+		BenchmarkCase(&c, src);
+	}
+
+	c.op = OP_ROTATE90;
+	for (i = 0; i < COUNT(quarterTurns); i++) {
+		c.factor = quarterTurns[i];
+		BenchmarkCase(&c, src);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *src;
+	int i, f, threads = -1;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0) {
+			json = 1;
+		} else if ((strcmp(argv[i], "--maxsize") == 0) && (i + 1 < argc)) {
+			maxSize = atoi(argv[++i]);
+		} else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) {
+			threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--nosimd") == 0) {
+			rotozoomSetSIMD(0);
+		} else if ((strcmp(argv[i], "--time") == 0) && (i + 1 < argc)) {
+			minTime = atof(argv[++i]);
+		} else {
+			fprintf(stderr, "Usage: %s [--json] [--maxsize N] [--threads N] [--nosimd] [--time S]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (threads >= 0) {
+		rotozoomSetThreads(threads, 64);
+	}
+
+	/* Count allocations of all SDL calls */
+	SDL_GetOriginalMemoryFunctions(&realMalloc, &realCalloc, &realRealloc, &realFree);
+	SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, realFree);
+
+	if (json) {
+		printf("[");
+	} else {
+		printf("op,bpp,width,height,angle,zoomx,zoomy,smooth,factor,dst_width,dst_height,iterations,ms_per_call,mpix_per_sec,allocs_per_call\n");
+	}
+
+	for (i = 0; i < COUNT(sizes); i++) {
+		if ((maxSize > 0) && (sizes[i][0] > maxSize)) {
+			continue;
+		}
+		for (f = 0; f < COUNT(formats); f++) {
+			src = CreateSource(sizes[i][0], sizes[i][1], formats[f]);
+			if (src == NULL) {
+				fprintf(stderr, "Could not create %dx%d source: %s\n", sizes[i][0], sizes[i][1], SDL_GetError());
+				continue;
+			}
+			BenchmarkSource(src, f);
+			SDL_DestroySurface(src);
+		}
+	}
+
+	if (json) {
+		printf("\n]\n");
+	}
+
+	SDL_Quit();
+	return 0;
+}
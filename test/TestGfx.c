@@ -1473,6 +1473,54 @@ int TestThickLineAccuracy(SDL_Renderer *renderer)
 }
 
 
+int TestAAThickLine(SDL_Renderer *renderer)
+{
+	int i;
+	Uint8 r,g,b;
+	int step = 6;
+	
+	/* Draw A=255 */
+	SetViewport(renderer,0,60,WIDTH/2,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		aaThickLineRGBA(renderer, rx[i], ry[i], rx[i+1], ry[i+1], lw[i], rr[i], rg[i], rb[i], 255);
+	}
+
+	/* Draw A=various */
+	SetViewport(renderer,WIDTH/2,60,WIDTH,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		aaThickLineRGBA(renderer, rx[i], ry[i], rx[i+1], ry[i+1], lw[i], rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw polylines with 3, 4 and 5 points, A=various */
+	SetViewport(renderer,WIDTH/2,80+(HEIGHT-80)/2,WIDTH,HEIGHT);
+	for (i=0; i<(NUM_RANDOM-5); i += step) {
+		aaThickPolylineRGBA(renderer, &rx[i], &ry[i], 3 + (i/step) % 3, lw[i], rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw Colortest */
+	SetViewport(renderer,0,80+(HEIGHT-80)/2,WIDTH/2,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		if (rx[i] < (WIDTH/6))  {
+			r=255; g=0; b=0; 
+		} else if (rx[i] < (WIDTH/3) ) {
+			r=0; g=255; b=0; 
+		} else {
+			r=0; g=0; b=255; 
+		}
+		aaThickLineRGBA(renderer, rx[i], ry[i], rx[i]+rr1[i], ry[i]+rr2[i], lw[i], r, g, b, 255);
+	}
+
+	/* Clear viewport */
+	ClearViewport(renderer);
+
+	/* Accuracy test */
+	ClearCenter(renderer, "18px w2w3 aaline");
+	aaThickLineRGBA(renderer, WIDTH/2 - 10, HEIGHT/2 - 5, WIDTH/2, HEIGHT/2 + 10, 2, 255, 255, 255, 255);
+	aaThickLineRGBA(renderer, WIDTH/2, HEIGHT/2 - 5, WIDTH/2 + 10, HEIGHT/2 + 10, 3, 255, 255, 255, 255);
+
+	return (4 * NUM_RANDOM) / step;
+}
+
 int TestTexturedPolygon(SDL_Renderer *renderer)
 {
 	/* Define masking bytes */
@@ -1711,6 +1759,246 @@ int TestBigEllipse(SDL_Renderer *renderer)
 	return count;
 }
 
+/*!
+\brief Pack RGBA components into a color value as expected by the ___Color routines.
+*/
+Uint32 PackColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	Uint32 color;
+	Uint8 *c = (Uint8 *)&color;
+	c[0] = r;
+	c[1] = g;
+	c[2] = b;
+	c[3] = a;
+	return color;
+}
+
+int TestGradient(SDL_Renderer *renderer)
+{
+	int i, j;
+	Uint32 colors[5];
+	float px[5], py[5];
+	int step = 8;
+
+	/* Draw box gradients A=255 */
+	SetViewport(renderer,0,60,WIDTH/2,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		boxGradient(renderer, rx[i], ry[i], rx[i]+rr1[i], ry[i]+rr2[i],
+			PackColor(rr[i], rg[i], rb[i], 255), PackColor(rg[i], rb[i], rr[i], 255),
+			PackColor(rb[i], rr[i], rg[i], 255), PackColor(0, 0, 0, 255));
+	}
+
+	/* Draw radial circles A=various */
+	SetViewport(renderer,WIDTH/2,60,WIDTH,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		filledCircleRadialGradient(renderer, rx[i], ry[i], rr1[i],
+			PackColor(255, 255, 255, ra[i]), PackColor(rr[i], rg[i], rb[i], 0));
+	}
+
+	/* Draw pentagon gradients A=various */
+	SetViewport(renderer,WIDTH/2,80+(HEIGHT-80)/2,WIDTH,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		for (j=0; j<5; j++) {
+			px[j] = rx[i] + rr1[i] * (float)SDL_cos(j * 2.0 * M_PI / 5.0);
+			py[j] = ry[i] + rr1[i] * (float)SDL_sin(j * 2.0 * M_PI / 5.0);
+			colors[j] = PackColor((j & 1) ? 255 : 0, (j & 2) ? 255 : 0, (j & 4) ? 255 : 0, ra[i]);
+		}
+		/* Make it concave */
+		px[2] = rx[i];
+		py[2] = ry[i];
+		filledPolygonGradient(renderer, px, py, colors, 5);
+	}
+
+	/* Draw Colortest */
+	SetViewport(renderer,0,80+(HEIGHT-80)/2,WIDTH/2,HEIGHT);
+	boxGradient(renderer, 0, 0, WIDTH/6, HEIGHT/2,
+		PackColor(255, 0, 0, 255), PackColor(255, 0, 0, 255),
+		PackColor(0, 0, 0, 255), PackColor(0, 0, 0, 255));
+	boxGradient(renderer, WIDTH/6, 0, WIDTH/3, HEIGHT/2,
+		PackColor(0, 255, 0, 255), PackColor(0, 255, 0, 255),
+		PackColor(0, 0, 0, 255), PackColor(0, 0, 0, 255));
+	boxGradient(renderer, WIDTH/3, 0, WIDTH/2, HEIGHT/2,
+		PackColor(0, 0, 255, 255), PackColor(0, 0, 255, 255),
+		PackColor(0, 0, 0, 255), PackColor(0, 0, 0, 255));
+
+	/* Clear viewport */
+	ClearViewport(renderer);
+
+	/* Accuracy test */
+	ClearCenter(renderer, "gradient box");
+	boxGradient(renderer, WIDTH/2, HEIGHT/2, WIDTH/2+10, HEIGHT/2+10,
+		PackColor(255, 255, 255, 255), PackColor(255, 0, 0, 255),
+		PackColor(0, 255, 0, 255), PackColor(0, 0, 255, 255));
+
+	return (3 * NUM_RANDOM) / step + 3;
+}
+
+int TestTessellated(SDL_Renderer *renderer)
+{
+	int i;
+	int step = 4;
+
+	gfxPrimitivesSetTessellationTolerance(0.5f);
+
+	/* Draw circles A=255 */
+	SetViewport(renderer,0,60,WIDTH/2,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		circleRGBA(renderer, rx[i], ry[i], rr1[i], rr[i], rg[i], rb[i], 255);
+	}
+
+	/* Draw filled ellipses A=various */
+	SetViewport(renderer,WIDTH/2,60,WIDTH,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		filledEllipseRGBA(renderer, rx[i], ry[i], rr1[i], rr2[i], rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw arcs A=various */
+	SetViewport(renderer,WIDTH/2,80+(HEIGHT-80)/2,WIDTH,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		arcRGBA(renderer, rx[i], ry[i], rr1[i], a1[i], a2[i], rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw filled pies A=various */
+	SetViewport(renderer,0,80+(HEIGHT-80)/2,WIDTH/2,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		filledPieRGBA(renderer, rx[i], ry[i], rr1[i], a1[i], a2[i], rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Clear viewport */
+	ClearViewport(renderer);
+
+	/* Accuracy test */
+	ClearCenter(renderer, "r10 tess circle");
+	circleRGBA(renderer, WIDTH/2, HEIGHT/2, 10, 255, 255, 255, 255);
+
+	gfxPrimitivesSetTessellationTolerance(0.0f);
+
+	return (4 * NUM_RANDOM) / step;
+}
+
+int TestPattern(SDL_Renderer *renderer)
+{
+	int i, j;
+	float px[5], py[5];
+	int step = 8;
+	static const Uint8 hatch[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+	static const Uint8 dots[8] = { 0x88, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00 };
+	static const Uint8 cross[8] = { 0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81 };
+
+	/* Draw hatched boxes A=255 */
+	SetViewport(renderer,0,60,WIDTH/2,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		boxPatternRGBA(renderer, rx[i], ry[i], rx[i]+rr1[i], ry[i]+rr2[i], hatch, 8, rr[i], rg[i], rb[i], 255);
+	}
+
+	/* Draw dotted circles A=various */
+	SetViewport(renderer,WIDTH/2,60,WIDTH,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		filledCirclePatternRGBA(renderer, rx[i], ry[i], rr1[i], dots, 8, rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw cross-hatched pentagons A=various */
+	SetViewport(renderer,WIDTH/2,80+(HEIGHT-80)/2,WIDTH,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		for (j=0; j<5; j++) {
+			px[j] = rx[i] + rr1[i] * (float)SDL_cos(j * 2.0 * M_PI / 5.0);
+			py[j] = ry[i] + rr1[i] * (float)SDL_sin(j * 2.0 * M_PI / 5.0);
+		}
+		filledPolygonPatternRGBA(renderer, px, py, 5, cross, 8, rr[i], rg[i], rb[i], ra[i]);
+	}
+
+	/* Draw Colortest */
+	SetViewport(renderer,0,80+(HEIGHT-80)/2,WIDTH/2,HEIGHT);
+	boxPatternRGBA(renderer, 0, 0, WIDTH/6, HEIGHT/2, hatch, 8, 255, 0, 0, 255);
+	boxPatternRGBA(renderer, WIDTH/6, 0, WIDTH/3, HEIGHT/2, hatch, 8, 0, 255, 0, 255);
+	boxPatternRGBA(renderer, WIDTH/3, 0, WIDTH/2, HEIGHT/2, hatch, 8, 0, 0, 255, 255);
+
+	/* Clear viewport */
+	ClearViewport(renderer);
+
+	/* Accuracy test */
+	ClearCenter(renderer, "16x16 hatch box");
+	boxPatternRGBA(renderer, WIDTH/2, HEIGHT/2, WIDTH/2+15, HEIGHT/2+15, hatch, 8, 255, 255, 255, 255);
+
+	return (3 * NUM_RANDOM) / step + 3;
+}
+
+/* Fill px/py with an n point star around x,y */
+void MakeStar(float x, float y, float r, float *px, float *py, int n)
+{
+	int j;
+	float radius;
+
+	for (j=0; j<n; j++) {
+		radius = (j & 1) ? r / 2.0f : r;
+		px[j] = x + radius * (float)SDL_cos(j * 2.0 * M_PI / n);
+		py[j] = y + radius * (float)SDL_sin(j * 2.0 * M_PI / n);
+	}
+}
+
+int TestPolygonCache(SDL_Renderer *renderer)
+{
+	int i, missing;
+	float px[10], py[10];
+	int step = 8;
+
+	/* Start from an empty cache with the default limit */
+	gfxPrimitivesClearPolygonCache();
+	gfxPrimitivesSetPolygonCacheSize(1024 * 1024);
+
+	/* Draw uncached stars A=255 */
+	SetViewport(renderer,0,60,WIDTH/2,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		MakeStar(rx[i], ry[i], rr1[i], px, py, 10);
+		filledPolygonRGBA(renderer, px, py, 10, rr[i], rg[i], rb[i], 255);
+	}
+
+	/* Draw the same stars cached, twice: the second pass uses the stored spans */
+	SetViewport(renderer,WIDTH/2,60,WIDTH,60+(HEIGHT-80)/2);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		MakeStar(rx[i], ry[i], rr1[i], px, py, 10);
+		filledPolygonCachedRGBA(renderer, px, py, 10, 0, 0, rr[i], rg[i], rb[i], 255);
+	}
+	for (i=0; i<NUM_RANDOM; i += step) {
+		MakeStar(rx[i], ry[i], rr1[i], px, py, 10);
+		filledPolygonCachedRGBA(renderer, px, py, 10, 0, 0, rr[i], rg[i], rb[i], 255);
+	}
+
+	/* Invalidate the stars and redraw them cached A=various */
+	SetViewport(renderer,WIDTH/2,80+(HEIGHT-80)/2,WIDTH,HEIGHT);
+	missing = 0;
+	for (i=0; i<NUM_RANDOM; i += step) {
+		MakeStar(rx[i], ry[i], rr1[i], px, py, 10);
+		if (!gfxPrimitivesInvalidatePolygonCache(px, py, 10)) {
+			missing++;
+		}
+		filledPolygonCachedRGBA(renderer, px, py, 10, 0, 0, rr[i], rg[i], rb[i], ra[i]);
+	}
+	if (missing > 0) {
+		SDL_Log("Polygon cache: %i of %i stars were evicted before invalidation", missing, NUM_RANDOM / step);
+	}
+
+	/* Draw Colortest: red uncached fills covered by green cached fills; no red may remain */
+	SetViewport(renderer,0,80+(HEIGHT-80)/2,WIDTH/2,HEIGHT);
+	for (i=0; i<NUM_RANDOM; i += step) {
+		MakeStar(rx[i], ry[i], rr1[i], px, py, 10);
+		filledPolygonRGBA(renderer, px, py, 10, 255, 0, 0, 255);
+		filledPolygonCachedRGBA(renderer, px, py, 10, 0, 0, 0, 255, 0, 255);
+	}
+
+	/* Clear viewport */
+	ClearViewport(renderer);
+
+	/* Accuracy test */
+	ClearCenter(renderer, "cached 10pt star");
+	MakeStar(WIDTH/2 + 8, HEIGHT/2 + 8, 8, px, py, 10);
+	filledPolygonCachedRGBA(renderer, px, py, 10, 0, 0, 255, 255, 255, 255);
+
+	gfxPrimitivesClearPolygonCache();
+
+	return (5 * NUM_RANDOM) / step + 1;
+}
+
 /* ====== Main */
 
 int main(int argc, char *argv[])
@@ -1809,7 +2097,7 @@ int main(int argc, char *argv[])
 
 		if (!drawn) {
 			/* Set test range */
-			numTests = 28;
+			numTests = 33;
 			if (test < 0) { 
 				test = (numTests - 1); 
 			} else {
@@ -1936,6 +2224,26 @@ int main(int argc, char *argv[])
 						ExecuteTest(renderer, TestBigEllipse, test, "Ellipse (Big)");
 						break;
 					}
+					case 28: {
+						ExecuteTest(renderer, TestGradient, test, "Gradient");
+						break;
+					}
+					case 29: {
+						ExecuteTest(renderer, TestAAThickLine, test, "AAThickLine");
+						break;
+					}
+					case 30: {
+						ExecuteTest(renderer, TestTessellated, test, "Tessellated Curves");
+						break;
+					}
+					case 31: {
+						ExecuteTest(renderer, TestPattern, test, "Pattern");
+						break;
+					}
+					case 32: {
+						ExecuteTest(renderer, TestPolygonCache, test, "Polygon Cache");
+						break;
+					}
 					default: {
 						ClearScreen(renderer, "Unknown Test");
 						break;
@@ -1951,6 +2259,7 @@ int main(int argc, char *argv[])
 		SDL_Delay(25);
     }
 
+    gfxPrimitivesClearPatternCache();
     SDLTest_CommonQuit(state);
 
     /* Print out some timing information */
@@ -387,6 +387,610 @@ void CustomTest(SDL_Surface *picture, double a, double x, double y, int smooth){
 	SDL_Delay(1000);		
 }
 
+/* Draw a surface at the given position (NULL is ignored) */
+void DrawPicture(SDL_Surface *picture, float x, float y)
+{
+	SDL_Texture *texture;
+	SDL_FRect dest;
+	SDL_Renderer *renderer = state->renderers[0];
+
+	if (picture == NULL) return;
+	texture = SDL_CreateTextureFromSurface(renderer, picture);
+	if (!texture) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+		return;
+	}
+	dest.x = x;
+	dest.y = y;
+	dest.w = picture->w;
+	dest.h = picture->h;
+	SDL_RenderTexture(renderer, texture, NULL, &dest);
+	SDL_DestroyTexture(texture);
+}
+
+/* Number of pixels with a channel differing by more than 'tolerance' or -1 if the size or format differs */
+int CountDifferences(SDL_Surface *a, SDL_Surface *b, int tolerance)
+{
+	int x, y, i, bpp, count;
+	Uint8 *pa, *pb;
+
+	if ((a == NULL) || (b == NULL) || (a->w != b->w) || (a->h != b->h) || (a->format != b->format)) {
+		return -1;
+	}
+	bpp = SDL_BYTESPERPIXEL(a->format);
+	count = 0;
+	for (y = 0; y < a->h; y++) {
+		pa = (Uint8 *)a->pixels + y * a->pitch;
+		pb = (Uint8 *)b->pixels + y * b->pitch;
+		for (x = 0; x < a->w * bpp; x += bpp) {
+			for (i = 0; i < bpp; i++) {
+				if (abs(pa[x + i] - pb[x + i]) > tolerance) break;
+			}
+			if (i < bpp) count++;
+		}
+	}
+	return count;
+}
+
+/* Log the result of a consistency check */
+void LogCheck(const char *name, int checks, int failures)
+{
+	if (failures == 0) {
+		SDL_Log("  %s: %i checks passed\n", name, checks);
+	} else {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "  %s: %i of %i checks FAILED\n", name, failures, checks);
+	}
+}
+
+/* Begin a frame: handle events and clear the screen */
+void BeginFrame(void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+}
+
+/* End a frame: draw the message and display */
+void EndFrame(void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+	SDL_RenderPresent(renderer);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Rotozoom into a preallocated surface with a scratch buffer and compare with rotozoomSurfaceXY */
+void IntoTest(SDL_Surface *picture, int smooth)
+{
+	SDL_Surface *reference, *target;
+	void *scratch = NULL;
+	size_t scratchSize = 0, size;
+	int framecount, checks = 0, failures = 0;
+	double angle, zoom;
+
+	SDL_Log("%s\n", messageText);
+
+	for (framecount = 0; framecount < 360 && !done; framecount += 2) {
+		BeginFrame();
+		angle = (double)framecount;
+		zoom = 0.5 + 0.5 * fabs(sin((double)framecount / 40.0));
+		reference = rotozoomSurfaceXY(picture, angle, zoom, zoom, smooth);
+		if (reference == NULL) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't rotozoom image\n");
+			break;
+		}
+		target = SDL_CreateSurface(reference->w, reference->h, reference->format);
+		if (target == NULL) {
+			SDL_DestroySurface(reference);
+			break;
+		}
+
+		/* Grow the scratch buffer as needed, like an application reusing it each frame */
+		size = rotozoomSurfaceScratchSize(picture, target->w, target->h);
+		if (size > scratchSize) {
+			SDL_free(scratch);
+			scratch = SDL_malloc(size);
+			scratchSize = (scratch != NULL) ? size : 0;
+		}
+
+		checks++;
+		if ((rotozoomSurfaceXYInto(picture, target, angle, zoom, zoom, smooth, scratch, scratchSize) != 0) ||
+			(CountDifferences(reference, target, 0) != 0)) {
+			failures++;
+		}
+
+		DrawPicture(reference, (WIDTH / 2 - reference->w) / 2, (HEIGHT - reference->h) / 2);
+		DrawPicture(target, WIDTH / 2 + (WIDTH / 2 - target->w) / 2, (HEIGHT - target->h) / 2);
+		SDL_DestroySurface(reference);
+		SDL_DestroySurface(target);
+		EndFrame();
+	}
+
+	SDL_free(scratch);
+	LogCheck("rotozoomSurfaceXYInto", checks, failures);
+}
+
+/* Zoom with a reused plan and compare with zoomSurface */
+void ZoomPlanTest(SDL_Surface *picture, int smooth)
+{
+	zoomPlan *plan;
+	SDL_Surface *reference, *target;
+	int framecount, flags, dstw, dsth, checks = 0, failures = 0;
+	double zoomx, zoomy;
+
+	SDL_Log("%s\n", messageText);
+
+	dstw = picture->w * 3 / 2;
+	dsth = picture->h * 3 / 2;
+	zoomx = (double)dstw / (double)picture->w;
+	zoomy = (double)dsth / (double)picture->h;
+	target = SDL_CreateSurface(dstw, dsth, picture->format);
+	if (target == NULL) return;
+
+	for (framecount = 0; framecount < 4 && !done; framecount++) {
+		BeginFrame();
+		flags = smooth;
+		if (framecount & 1) flags |= ZOOMPLAN_FLIPX;
+		if (framecount & 2) flags |= ZOOMPLAN_FLIPY;
+		SDL_Log("  Frame: %i   Flip: x=%i y=%i\n", framecount, framecount & 1, (framecount >> 1) & 1);
+
+		plan = zoomPlanCreate(picture->w, picture->h, dstw, dsth, flags);
+		if (plan == NULL) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create zoom plan\n");
+			break;
+		}
+		reference = zoomSurface(picture, (framecount & 1) ? -zoomx : zoomx, (framecount & 2) ? -zoomy : zoomy, smooth);
+
+		/* Execute a few times to show that the plan is reusable */
+		checks++;
+		if ((zoomPlanExecute(plan, picture, target) != 0) || (zoomPlanExecute(plan, picture, target) != 0) ||
+			(CountDifferences(reference, target, 0) != 0)) {
+			failures++;
+		}
+		zoomPlanDestroy(plan);
+
+		DrawPicture(target, (WIDTH - target->w) / 2, (HEIGHT - target->h) / 2);
+		SDL_DestroySurface(reference);
+		EndFrame();
+
+		/* Always delay */
+		SDL_Delay(500);
+	}
+
+	SDL_DestroySurface(target);
+	LogCheck("zoomPlanExecute", checks, failures);
+}
+
+/* Shrink by fractional ratios; integer ratios must match shrinkSurface up to rounding */
+void ShrinkAreaTest(SDL_Surface *picture)
+{
+	SDL_Surface *shrunk, *view, *area, *reference;
+	int framecount, factor, checks = 0, failures = 0;
+	double ratio;
+
+	SDL_Log("%s\n", messageText);
+
+	for (framecount = 10; framecount <= 80 && !done; framecount++) {
+		BeginFrame();
+		ratio = (double)framecount / 10.0;
+		shrunk = shrinkSurfaceArea(picture, ratio, ratio);
+		if (shrunk == NULL) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't shrink image\n");
+			break;
+		}
+		if ((framecount % 10) == 0) {
+			SDL_Log("  Frame: %i   Shrink: %.1f\n", framecount, ratio);
+
+			/* Crop to a multiple of the factor, so both shrinkers average the same pixels */
+			factor = framecount / 10;
+			view = SDL_CreateSurfaceFrom(picture->w / factor * factor, picture->h / factor * factor,
+				picture->format, picture->pixels, picture->pitch);
+			area = shrinkSurfaceArea(view, factor, factor);
+			reference = shrinkSurface(view, factor, factor);
+			checks++;
+			if (CountDifferences(reference, area, 1) != 0) {
+				failures++;
+			}
+			SDL_DestroySurface(reference);
+			SDL_DestroySurface(area);
+			SDL_DestroySurface(view);
+		}
+		DrawPicture(shrunk, (WIDTH - shrunk->w) / 2, (HEIGHT - shrunk->h) / 2);
+		SDL_DestroySurface(shrunk);
+		EndFrame();
+	}
+
+	LogCheck("shrinkSurfaceArea", checks, failures);
+}
+
+/* Build a mip chain and compare every level with repeated shrinkSurface */
+void MipChainTest(SDL_Surface *picture)
+{
+	mipChain *chain;
+	SDL_Surface *reference, *next;
+	int i, checks = 0, failures = 0;
+	float x;
+
+	SDL_Log("%s\n", messageText);
+
+	chain = buildMipChain(picture, 0);
+	if (chain == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't build mip chain\n");
+		return;
+	}
+
+	BeginFrame();
+	reference = picture;
+	x = 8;
+	for (i = 0; i < chain->levels; i++) {
+		next = shrinkSurface(reference, 2, 2);
+		if (reference != picture) SDL_DestroySurface(reference);
+		reference = next;
+		checks++;
+		if (CountDifferences(reference, chain->level[i], 0) != 0) {
+			failures++;
+		}
+		DrawPicture(chain->level[i], x, 32);
+		x += chain->level[i]->w + 8;
+	}
+	if ((reference != NULL) && (reference != picture)) SDL_DestroySurface(reference);
+	freeMipChain(chain);
+	EndFrame();
+
+	LogCheck("buildMipChain", checks, failures);
+	SDL_Delay(2000);
+}
+
+/* Streaming source and destination of StreamTest */
+typedef struct {
+	SDL_Surface *source;
+	SDL_Surface *target;
+} StreamData;
+
+/* Source callback of rotozoomSurfaceXYStream: copy rows of the picture */
+int StreamSource(void *userdata, int y, int rows, void *pixels, int pitch)
+{
+	StreamData *data = (StreamData *)userdata;
+	int i, bytes;
+
+	bytes = data->source->w * SDL_BYTESPERPIXEL(data->source->format);
+	for (i = 0; i < rows; i++) {
+		memcpy((Uint8 *)pixels + i * pitch, (Uint8 *)data->source->pixels + (y + i) * data->source->pitch, bytes);
+	}
+	return 0;
+}
+
+/* Band callback of rotozoomSurfaceXYStream: collect the bands into one surface */
+int StreamBand(void *userdata, int y, SDL_Surface *band)
+{
+	StreamData *data = (StreamData *)userdata;
+	int i, bytes;
+
+	if ((band->w != data->target->w) || (y + band->h > data->target->h)) return -1;
+	bytes = band->w * SDL_BYTESPERPIXEL(band->format);
+	for (i = 0; i < band->h; i++) {
+		memcpy((Uint8 *)data->target->pixels + (y + i) * data->target->pitch, (Uint8 *)band->pixels + i * band->pitch, bytes);
+	}
+	return 0;
+}
+
+/* Rotozoom band by band from a callback source and compare with rotozoomSurfaceXY, which also gives the band format */
+void StreamTest(SDL_Surface *picture, int smooth)
+{
+	SDL_Surface *reference;
+	StreamData data;
+	int framecount, checks = 0, failures = 0;
+	double angle;
+
+	SDL_Log("%s\n", messageText);
+
+	/* Unrotated bicubic and Lanczos-3 zooms use bilinear smoothing in the stream, so start rotated */
+	data.source = picture;
+	framecount = ((smooth == SMOOTHING_BICUBIC) || (smooth == SMOOTHING_LANCZOS3)) ? 5 : 0;
+	for (; framecount < 360 && !done; framecount += 5) {
+		BeginFrame();
+		angle = (double)framecount;
+		reference = rotozoomSurfaceXY(picture, angle, 0.75, 0.75, smooth);
+		if (reference == NULL) break;
+		data.target = SDL_CreateSurface(reference->w, reference->h, reference->format);
+		if (data.target == NULL) {
+			SDL_DestroySurface(reference);
+			break;
+		}
+		checks++;
+		if ((rotozoomSurfaceXYStream(picture->w, picture->h, picture->format, angle, 0.75, 0.75, smooth,
+			16, StreamSource, StreamBand, &data) != 0) || (CountDifferences(reference, data.target, 0) != 0)) {
+			failures++;
+		}
+		DrawPicture(data.target, (WIDTH - data.target->w) / 2, (HEIGHT - data.target->h) / 2);
+		SDL_DestroySurface(data.target);
+		SDL_DestroySurface(reference);
+		EndFrame();
+	}
+
+	LogCheck("rotozoomSurfaceXYStream", checks, failures);
+}
+
+/* Rotozoom straight into a streaming texture; too small textures and other formats are rejected */
+void ToTextureTest(SDL_Surface *picture, int smooth)
+{
+	SDL_Texture *texture, *other;
+	SDL_FRect source, dest;
+	int framecount, w, h, maxw, maxh, checks = 0, failures = 0;
+	double angle;
+	SDL_Renderer *renderer = state->renderers[0];
+
+	SDL_Log("%s\n", messageText);
+
+	/* Large enough for every angle */
+	maxw = 0;
+	maxh = 0;
+	for (framecount = 0; framecount < 360; framecount++) {
+		rotozoomSurfaceSizeXY(picture->w, picture->h, (double)framecount, 1.0, 1.0, &w, &h);
+		if (w > maxw) maxw = w;
+		if (h > maxh) maxh = h;
+	}
+	texture = SDL_CreateTexture(renderer, picture->format, SDL_TEXTUREACCESS_STREAMING, maxw, maxh);
+	if (texture == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+		return;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	for (framecount = 0; framecount < 360 && !done; framecount++) {
+		BeginFrame();
+		angle = (double)framecount;
+		rotozoomSurfaceSizeXY(picture->w, picture->h, angle, 1.0, 1.0, &w, &h);
+		checks++;
+		if (rotozoomSurfaceXYToTexture(picture, texture, angle, 1.0, 1.0, smooth, NULL, 0) != 0) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't rotozoom into texture\n");
+			failures++;
+			break;
+		}
+		source.x = 0;
+		source.y = 0;
+		source.w = w;
+		source.h = h;
+		dest.x = (WIDTH - w) / 2;
+		dest.y = (HEIGHT - h) / 2;
+		dest.w = w;
+		dest.h = h;
+		SDL_RenderTexture(renderer, texture, &source, &dest);
+		EndFrame();
+	}
+	SDL_DestroyTexture(texture);
+
+	/* A texture one pixel narrower than the result */
+	rotozoomSurfaceSizeXY(picture->w, picture->h, 45.0, 1.0, 1.0, &w, &h);
+	other = SDL_CreateTexture(renderer, picture->format, SDL_TEXTUREACCESS_STREAMING, w - 1, h);
+	if (other != NULL) {
+		checks++;
+		if (rotozoomSurfaceXYToTexture(picture, other, 45.0, 1.0, 1.0, smooth, NULL, 0) == 0) {
+			failures++;
+		}
+		SDL_DestroyTexture(other);
+	}
+
+	/* A texture of another format than rotozoomSurfaceXY returns */
+	other = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING, w, h);
+	if (other != NULL) {
+		checks++;
+		if (rotozoomSurfaceXYToTexture(picture, other, 45.0, 1.0, 1.0, smooth, NULL, 0) == 0) {
+			failures++;
+		}
+		SDL_DestroyTexture(other);
+	}
+
+	LogCheck("rotozoomSurfaceXYToTexture", checks, failures);
+}
+
+/* Spin a sprite from a rotation cache; the second turn only does lookups */
+void CacheTest(SDL_Surface *picture, int smooth)
+{
+	rotozoomCache *cache;
+	SDL_Surface *cached, *reference, *canvas;
+	SDL_Renderer *software;
+	SDL_Texture *texture;
+	SDL_FRect dest;
+	int framecount, turn, checks = 0, failures = 0;
+	float w, h;
+	Uint64 start, ticks[2];
+	SDL_Renderer *renderer = state->renderers[0];
+
+	SDL_Log("%s\n", messageText);
+
+	cache = rotozoomCacheCreate(2.0, 64 * 1024 * 1024);
+	if (cache == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create rotation cache\n");
+		return;
+	}
+
+	for (turn = 0; turn < 2 && !done; turn++) {
+		ticks[turn] = 0;
+		for (framecount = 0; framecount < 360 && !done; framecount += 2) {
+			BeginFrame();
+			start = SDL_GetPerformanceCounter();
+			texture = rotozoomCacheGetTexture(cache, renderer, picture, (double)framecount, 1.0, smooth);
+			ticks[turn] += SDL_GetPerformanceCounter() - start;
+			if (texture == NULL) {
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't get cached texture\n");
+				break;
+			}
+			SDL_GetTextureSize(texture, &w, &h);
+			dest.x = (WIDTH - w) / 2;
+			dest.y = (HEIGHT - h) / 2;
+			dest.w = w;
+			dest.h = h;
+			SDL_RenderTexture(renderer, texture, NULL, &dest);
+			EndFrame();
+		}
+	}
+	SDL_Log("  First turn: %.2f ms  Second turn (cached): %.2f ms\n",
+		(double)ticks[0] * 1000.0 / (double)SDL_GetPerformanceFrequency(),
+		(double)ticks[1] * 1000.0 / (double)SDL_GetPerformanceFrequency());
+
+	/* Cached surfaces match rotozoomSurface at the quantized angle */
+	for (framecount = 0; framecount < 360; framecount += 30) {
+		cached = rotozoomCacheGet(cache, picture, (double)framecount + 0.5, 1.0, smooth);
+		reference = rotozoomSurface(picture, (double)framecount, 1.0, smooth);
+		checks++;
+		if (CountDifferences(reference, cached, 0) != 0) {
+			failures++;
+		}
+		SDL_DestroySurface(reference);
+	}
+
+	/* Textures of a destroyed renderer are dropped, the frame gets a new texture */
+	canvas = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA32);
+	software = (canvas != NULL) ? SDL_CreateSoftwareRenderer(canvas) : NULL;
+	if (software != NULL) {
+		checks++;
+		if (rotozoomCacheGetTexture(cache, software, picture, 0.0, 1.0, smooth) == NULL) {
+			failures++;
+		}
+		SDL_DestroyRenderer(software);
+		checks++;
+		if (rotozoomCacheGetTexture(cache, renderer, picture, 0.0, 1.0, smooth) == NULL) {
+			failures++;
+		}
+	}
+	SDL_DestroySurface(canvas);
+
+	rotozoomCacheInvalidate(cache, picture);
+	rotozoomCacheDestroy(cache);
+	LogCheck("rotozoomCacheGet", checks, failures);
+}
+
+/* Rotozoom a moving rectangle in place and compare with rotozooming a cropped copy */
+void RectTest(SDL_Surface *picture, int smooth)
+{
+	SDL_Surface *rotated, *cropped, *reference;
+	SDL_Rect rect;
+	int framecount, y, bpp, checks = 0, failures = 0;
+	double angle;
+
+	SDL_Log("%s\n", messageText);
+
+	bpp = SDL_BYTESPERPIXEL(picture->format);
+	rect.w = picture->w / 2;
+	rect.h = picture->h / 2;
+	cropped = SDL_CreateSurface(rect.w, rect.h, picture->format);
+	if (cropped == NULL) return;
+
+	for (framecount = 0; framecount < 360 && !done; framecount += 2) {
+		BeginFrame();
+		angle = (double)framecount;
+		rect.x = (int)((picture->w - rect.w) * (0.5 + 0.5 * sin(angle * M_PI / 180.0)));
+		rect.y = (int)((picture->h - rect.h) * (0.5 + 0.5 * cos(angle * M_PI / 180.0)));
+		rotated = rotozoomSurfaceXYRect(picture, &rect, angle, 1.5, 1.5, smooth);
+		if (rotated == NULL) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't rotozoom rectangle\n");
+			break;
+		}
+		if ((framecount % 30) == 0) {
+			for (y = 0; y < rect.h; y++) {
+				memcpy((Uint8 *)cropped->pixels + y * cropped->pitch,
+					(Uint8 *)picture->pixels + (rect.y + y) * picture->pitch + rect.x * bpp, rect.w * bpp);
+			}
+			reference = rotozoomSurfaceXY(cropped, angle, 1.5, 1.5, smooth);
+			checks++;
+			if (CountDifferences(reference, rotated, 0) != 0) {
+				failures++;
+			}
+			SDL_DestroySurface(reference);
+		}
+		DrawPicture(rotated, (WIDTH - rotated->w) / 2, (HEIGHT - rotated->h) / 2);
+		SDL_DestroySurface(rotated);
+		EndFrame();
+	}
+
+	/* A rectangle reaching past the bottom right corner is clipped to the surface */
+	rect.x = picture->w - rect.w;
+	rect.y = picture->h - rect.h;
+	for (y = 0; y < rect.h; y++) {
+		memcpy((Uint8 *)cropped->pixels + y * cropped->pitch,
+			(Uint8 *)picture->pixels + (rect.y + y) * picture->pitch + rect.x * bpp, rect.w * bpp);
+	}
+	rect.w *= 2;
+	rect.h *= 2;
+	rotated = rotozoomSurfaceXYRect(picture, &rect, 30.0, 1.5, 1.5, smooth);
+	reference = rotozoomSurfaceXY(cropped, 30.0, 1.5, 1.5, smooth);
+	checks++;
+	if (CountDifferences(reference, rotated, 0) != 0) {
+		failures++;
+	}
+	SDL_DestroySurface(reference);
+	SDL_DestroySurface(rotated);
+
+	/* No rectangle rotozooms the whole surface */
+	rotated = rotozoomSurfaceXYRect(picture, NULL, 30.0, 1.5, 1.5, smooth);
+	reference = rotozoomSurfaceXY(picture, 30.0, 1.5, 1.5, smooth);
+	checks++;
+	if (CountDifferences(reference, rotated, 0) != 0) {
+		failures++;
+	}
+	SDL_DestroySurface(reference);
+	SDL_DestroySurface(rotated);
+
+	SDL_DestroySurface(cropped);
+	LogCheck("rotozoomSurfaceXYRect", checks, failures);
+}
+
+#define BATCH_JOBS	16
+
+/* Rotozoom a grid of sprites sharing one source in one batch call and compare with rotozoomSurfaceXY */
+void BatchTest(SDL_Surface *picture, int smooth)
+{
+	rotozoomJob jobs[BATCH_JOBS];
+	SDL_Surface *sprite, *reference;
+	int framecount, i, checks = 0, failures = 0;
+
+	SDL_Log("%s\n", messageText);
+
+	sprite = zoomSurface(picture, 0.25, 0.25, SMOOTHING_ON);
+	if (sprite == NULL) return;
+
+	for (framecount = 0; framecount < 360 && !done; framecount += 2) {
+		BeginFrame();
+		for (i = 0; i < BATCH_JOBS; i++) {
+			jobs[i].src = sprite;
+			jobs[i].angle = (double)(framecount * (i + 1) / 4);
+			jobs[i].zoomx = 0.75 + 0.05 * i;
+			jobs[i].zoomy = jobs[i].zoomx;
+			jobs[i].smooth = smooth;
+			jobs[i].dst = NULL;
+		}
+		if (rotozoomSurfaceXYBatch(jobs, BATCH_JOBS) != 0) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't rotozoom batch\n");
+		}
+		for (i = 0; i < BATCH_JOBS; i++) {
+			if ((framecount % 30) == 0) {
+				reference = rotozoomSurfaceXY(sprite, jobs[i].angle, jobs[i].zoomx, jobs[i].zoomy, smooth);
+				checks++;
+				if ((jobs[i].result != 0) || (CountDifferences(reference, jobs[i].dst, 0) != 0)) {
+					failures++;
+				}
+				SDL_DestroySurface(reference);
+			}
+			if (jobs[i].dst != NULL) {
+				DrawPicture(jobs[i].dst, (i % 4) * WIDTH / 4 + (WIDTH / 4 - jobs[i].dst->w) / 2,
+					(i / 4) * HEIGHT / 4 + (HEIGHT / 4 - jobs[i].dst->h) / 2);
+				SDL_DestroySurface(jobs[i].dst);
+			}
+		}
+		EndFrame();
+	}
+
+	SDL_DestroySurface(sprite);
+	LogCheck("rotozoomSurfaceXYBatch", checks, failures);
+}
+
 
 void Draw (int start, int end)
 {
@@ -568,7 +1172,15 @@ done8bit:
 		if (start <= 12) {
 			SDL_snprintf(messageText, 1024, "12. zoom: Just zooming, with interpolation");
 			ZoomPicture(picture,SMOOTHING_ON);
-			if (done) goto done24bit;			
+			if (done) goto done24bit;
+
+			SDL_snprintf(messageText, 1024, "12b. zoom: Just zooming, bicubic");
+			ZoomPicture(picture,SMOOTHING_BICUBIC);
+			if (done) goto done24bit;
+
+			SDL_snprintf(messageText, 1024, "12c. zoom: Just zooming, Lanczos-3");
+			ZoomPicture(picture,SMOOTHING_LANCZOS3);
+			if (done) goto done24bit;
 		}
 		if (end == 12) goto done24bit;
 
@@ -607,6 +1219,10 @@ done24bit:
 			SDL_snprintf(messageText, 1024, "13. Rotating and zooming, with interpolation (RGBA source)");
 			RotatePicture(picture_again,ROTATE_ON,FLIP_OFF,SMOOTHING_ON,POSITION_CENTER);
 			if (done) goto done32bit;
+
+			SDL_snprintf(messageText, 1024, "13b. Rotating and zooming, premultiplied interpolation (RGBA source)");
+			RotatePicture(picture_again,ROTATE_ON,FLIP_OFF,SMOOTHING_ON | SMOOTHING_PREMULTIPLIED,POSITION_CENTER);
+			if (done) goto done32bit;
 		}
 		if (end == 13) goto done32bit;
 
@@ -813,6 +1429,124 @@ donerotate90:
 		if (end <= 25) return;
 	}
 
+	/* -------- Into, plan, stream, cache and batch tests --------- */
+
+	if (start<=34) {
+
+		/* Message */
+		SDL_Log("API tests ...\n");
+
+		/* Load the image into a surface */
+		bmpfile = "sample24.bmp";
+		SDL_Log("Loading picture: %s\n", bmpfile);
+		picture = SDL_LoadBMP(bmpfile);
+		if ( picture == NULL ) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", bmpfile, SDL_GetError());
+			return;
+		}
+
+		/* New source surface is 32bit with defined RGBA ordering */
+		SDL_Log("Converting 24bit image into 32bit RGBA surface ...\n");
+		picture_again = SDL_CreateSurface(picture->w, picture->h, SDL_GetPixelFormatForMasks(32, rmask, gmask, bmask, amask));
+		if (picture_again == NULL) goto doneapi;
+		SDL_BlitSurface(picture,NULL,picture_again,NULL);
+
+		if (start <= 26) {
+			SDL_snprintf(messageText, 1024, "26a. Into: preallocated target and scratch, with interpolation (RGBA source)");
+			IntoTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "26b. Into: preallocated target and scratch, with interpolation (24bit source)");
+			IntoTest(picture, SMOOTHING_ON);
+			if (done) goto doneapi;
+		}
+		if (end == 26) goto doneapi;
+
+		if (start <= 27) {
+			SDL_snprintf(messageText, 1024, "27a. zoomPlan: reused plan with flips, with interpolation");
+			ZoomPlanTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "27b. zoomPlan: reused plan with flips, Lanczos-3");
+			ZoomPlanTest(picture_again, SMOOTHING_LANCZOS3);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "27c. zoomPlan: reused plan with flips, with interpolation (24bit source)");
+			ZoomPlanTest(picture, SMOOTHING_ON);
+			if (done) goto doneapi;
+		}
+		if (end == 27) goto doneapi;
+
+		if (start <= 28) {
+			SDL_snprintf(messageText, 1024, "28. shrinkSurfaceArea: Shrinking by fractional ratios");
+			ShrinkAreaTest(picture_again);
+			if (done) goto doneapi;
+		}
+		if (end == 28) goto doneapi;
+
+		if (start <= 29) {
+			SDL_snprintf(messageText, 1024, "29. buildMipChain: All levels of the mip chain");
+			MipChainTest(picture_again);
+			if (done) goto doneapi;
+		}
+		if (end == 29) goto doneapi;
+
+		if (start <= 30) {
+			SDL_snprintf(messageText, 1024, "30a. Stream: Rotating and zooming band by band, with interpolation");
+			StreamTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "30b. Stream: Rotating and zooming band by band, with interpolation (24bit source)");
+			StreamTest(picture, SMOOTHING_ON);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "30c. Stream: Rotating and zooming band by band, bicubic (24bit source, RGBA bands)");
+			StreamTest(picture, SMOOTHING_BICUBIC);
+			if (done) goto doneapi;
+		}
+		if (end == 30) goto doneapi;
+
+		if (start <= 31) {
+			SDL_snprintf(messageText, 1024, "31. ToTexture: Rotating straight into a streaming texture");
+			ToTextureTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+		}
+		if (end == 31) goto doneapi;
+
+		if (start <= 32) {
+			SDL_snprintf(messageText, 1024, "32. rotozoomCache: Rotating from a cache of frames");
+			CacheTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+		}
+		if (end == 32) goto doneapi;
+
+		if (start <= 33) {
+			SDL_snprintf(messageText, 1024, "33. Rect: Rotating and zooming a moving rectangle in place");
+			RectTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+		}
+		if (end == 33) goto doneapi;
+
+		if (start <= 34) {
+			SDL_snprintf(messageText, 1024, "34a. Batch: Rotating 16 sprites in one call");
+			BatchTest(picture_again, SMOOTHING_ON);
+			if (done) goto doneapi;
+
+			SDL_snprintf(messageText, 1024, "34b. Batch: Rotating 16 sprites sharing a 24bit source which is converted, bicubic");
+			BatchTest(picture, SMOOTHING_BICUBIC);
+			if (done) goto doneapi;
+		}
+		if (end == 34) goto doneapi;
+
+doneapi:
+
+		/* Free the pictures */
+		SDL_DestroySurface(picture);
+		if (picture_again) SDL_DestroySurface(picture_again);
+		if (done) return;
+		if (end <= 34) return;
+	}
+
 	return;
 }
 
@@ -823,7 +1557,7 @@ int main(int argc, char *argv[])
 {
 	int i;
 	int testStart = 0;
-	int testEnd = 25;
+	int testEnd = 34;
 	SDL_Event event;
 	Uint64 then, now, frames;
 